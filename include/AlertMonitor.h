@@ -0,0 +1,74 @@
+#ifndef ALERT_MONITOR_H
+#define ALERT_MONITOR_H
+
+#include "config.h"
+
+/**
+ * @file AlertMonitor.h
+ * @brief Classifies CO2 readings against runtime-adjustable alert thresholds.
+ */
+
+/**
+ * @enum AlertLevel
+ * @brief Alert levels derived from the CO2 concentration.
+ */
+enum AlertLevel {
+    ALERT_NONE = 0,     ///< CO2 at or below the moderate threshold
+    ALERT_MODERATE = 1, ///< CO2 above the moderate threshold
+    ALERT_CRITICAL = 2  ///< CO2 above the critical threshold
+};
+
+/**
+ * @class AlertMonitor
+ * @brief Holds the alert thresholds and the current alert level.
+ *
+ * The thresholds start at `CO2_MODERATE_THRESHOLD` and `CO2_CRITICAL_THRESHOLD` and can be
+ * changed at runtime, e.g. from the serial console.
+ */
+class AlertMonitor {
+private:
+    float moderateThreshold = CO2_MODERATE_THRESHOLD; ///< Moderate alert threshold in ppm
+    float criticalThreshold = CO2_CRITICAL_THRESHOLD; ///< Critical alert threshold in ppm
+    AlertLevel level = ALERT_NONE; ///< Level of the last evaluated reading
+
+public:
+    /**
+     * @brief Classifies a CO2 reading and stores the resulting level.
+     *
+     * @param co2 The CO2 concentration in ppm.
+     * @return The alert level of the reading.
+     */
+    AlertLevel evaluate(float co2);
+
+    /**
+     * @brief Retrieves the level of the last evaluated reading.
+     *
+     * @return The current alert level.
+     */
+    AlertLevel getLevel() const;
+
+    /**
+     * @brief Sets both alert thresholds.
+     *
+     * @param moderate The moderate threshold in ppm.
+     * @param critical The critical threshold in ppm.
+     * @return `true` if the thresholds were accepted, `false` if they are not ordered or not positive.
+     */
+    bool setThresholds(float moderate, float critical);
+
+    /**
+     * @brief Retrieves the moderate alert threshold.
+     *
+     * @return The threshold in ppm.
+     */
+    float getModerateThreshold() const;
+
+    /**
+     * @brief Retrieves the critical alert threshold.
+     *
+     * @return The threshold in ppm.
+     */
+    float getCriticalThreshold() const;
+};
+
+#endif // ALERT_MONITOR_H
\ No newline at end of file
@@ -0,0 +1,54 @@
+#ifndef BUILD_PROFILE_H
+#define BUILD_PROFILE_H
+
+#include <stdint.h>
+
+/**
+ * @file BuildProfile.h
+ * @brief Compile-time selection of the diagnostic subsystems included in the firmware.
+ *
+ * Each PlatformIO environment selects one profile with `-DBUILD_PROFILE=...`. The code
+ * tests the features of `ACTIVE_PROFILE` with `if constexpr`, so a disabled subsystem is
+ * never referenced and the linker drops it together with its strings.
+ */
+
+#define BUILD_PROFILE_PRODUCTION 0  ///< Deployed units: no logging and no diagnostics
+#define BUILD_PROFILE_FIELD_DEBUG 1 ///< Units under investigation: logging up to info, console and tracing
+#define BUILD_PROFILE_LAB 2         ///< Bench units: everything including the debug log and the boot checks
+
+#ifndef BUILD_PROFILE
+#define BUILD_PROFILE BUILD_PROFILE_FIELD_DEBUG
+#endif
+
+/**
+ * @struct BuildProfile
+ * @brief The features of one build profile.
+ */
+struct BuildProfile {
+    const char* name; ///< Name reported at boot
+    uint8_t maxLogLevel; ///< Most verbose `LogLevel` compiled in; messages above it compile to nothing
+    bool serialConsole; ///< Serial console commands
+    bool traceRecorder; ///< Recording of the raw sensor stream (`TRACE_BLOCK_COUNT` blocks of RAM)
+    bool i2cScanner; ///< I2C bus scan at boot
+    bool displayCheck; ///< Display test pattern at boot
+};
+
+/**
+ * @brief All profiles, indexed by the `BUILD_PROFILE_*` values.
+ */
+constexpr BuildProfile BUILD_PROFILES[] = {
+    // name, log level (0 = none ... 4 = debug), console, trace, I2C scan, display check
+    { "production", 0, false, false, false, false },
+    { "field-debug", 3, true, true, false, false },
+    { "lab", 4, true, true, true, true },
+};
+
+static_assert(BUILD_PROFILE >= 0 && BUILD_PROFILE < sizeof(BUILD_PROFILES) / sizeof(BUILD_PROFILES[0]),
+              "BUILD_PROFILE must be one of the BUILD_PROFILE_* values");
+
+/**
+ * @brief The profile this firmware is built with.
+ */
+constexpr BuildProfile ACTIVE_PROFILE = BUILD_PROFILES[BUILD_PROFILE];
+
+#endif // BUILD_PROFILE_H
@@ -0,0 +1,40 @@
+#ifndef BUTTON_H
+#define BUTTON_H
+
+/**
+ * @file Button.h
+ * @brief Debouncing of a push button.
+ */
+
+/**
+ * @class Button
+ * @brief Turns the raw, bouncing state of a push button into single press events.
+ *
+ * The caller reads the pin and passes the level, so the logic does not depend on the
+ * GPIO API. A level counts once it has been stable for `BUTTON_DEBOUNCE_MS`.
+ */
+class Button {
+private:
+    bool stableState = false; ///< Debounced state, `true` while pressed
+    bool lastReading = false; ///< Raw state of the previous call
+    unsigned long lastChange = 0; ///< Time the raw state last changed in ms
+
+public:
+    /**
+     * @brief Feeds the current raw state of the button.
+     *
+     * @param pressed Whether the button reads as pressed.
+     * @param now The current time in ms.
+     * @return `true` once per debounced press, `false` otherwise.
+     */
+    bool update(bool pressed, unsigned long now);
+
+    /**
+     * @brief Retrieves the debounced state.
+     *
+     * @return `true` while the button is pressed.
+     */
+    bool isPressed() const;
+};
+
+#endif // BUTTON_H
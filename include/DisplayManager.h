@@ -1,113 +1,198 @@
-#ifndef DISPLAY_MANAGER_H
-#define DISPLAY_MANAGER_H
-
-#include <Adafruit_SSD1306.h>
-#include "Logger.h"
-
-#define SCREEN_WIDTH 128 ///< Width of the OLED display in pixels
-#define SCREEN_HEIGHT 64 ///< Height of the OLED display in pixels
-#define OLED_RESET -1    ///< OLED reset pin (-1 if not used)
-#define SCREEN_ADDRESS 0x3C ///< I2C address of the OLED display
-#define FONT_SIZE_SMALL 1   ///< Font size for small text
-#define FONT_SIZE_LARGE 2   ///< Font size for large text
-// Don't redefine these if they come from libraries
-#ifndef SSD1306_SWITCHCAPVCC
-#define SSD1306_SWITCHCAPVCC 0x02
-#endif
-
-#ifndef SSD1306_WHITE
-#define SSD1306_WHITE 1
-#endif
-
-
-/**
- * @class DisplayManager
- * @brief Manages the OLED display for showing messages, warnings, and sensor readings.
- */
-class DisplayManager {
-public:
-    /**
-     * @brief Constructor for the DisplayManager class.
-     */
-    DisplayManager();
-
-    /**
-     * @brief Initializes the OLED display.
-     * 
-     * @return true if the display was successfully initialized, false otherwise.
-     */
-    bool initialize();
-
-    /**
-     * @brief Displays a calibration message on the screen.
-     * 
-     * @param message1 The first line of the calibration message.
-     * @param message2 The second line of the calibration message.
-     */
-    void showCalibrationMessage(const char* message1, const char* message2);
-
-    /**
-     * @brief Displays a blinking warning message on the screen.
-     * 
-     * @param line1 The first line of the warning message.
-     * @param line2 The second line of the warning message.
-     * @param line3 The third line of the warning message.
-     * @param line4 The fourth line of the warning message.
-     * @param co2 The CO2 level to display.
-     * @param temperatureSCD The temperature from the SCD30 sensor.
-     * @param temperatureBMP The temperature from the BMP280 sensor.
-     * @param humidity The humidity level to display.
-     * @param pressure The pressure level to display.
-     */
-    void showBlinkingWarning(const char* line1, const char* line2, const char* line3, const char* line4, float co2, float temperatureSCD, float temperatureBMP, float humidity, float pressure);
-
-    /**
-     * @brief Displays the normal screen with sensor readings.
-     * 
-     * @param co2 The CO2 level to display.
-     * @param temperatureSCD The temperature from the SCD30 sensor.
-     * @param temperatureBMP The temperature from the BMP280 sensor.
-     * @param humidity The humidity level to display.
-     * @param pressure The pressure level to display.
-     */
-    void showNormalScreen(float co2, float temperatureSCD, float temperatureBMP, float humidity, float pressure);
-
-    /**
-     * @brief Runs a display check to verify the OLED functionality.
-     */
-    void runDisplayCheck();
-
-    /**
-     * @brief Displays a splash screen with a centered message.
-     * 
-     * @param text The message to display on the splash screen.
-     */
-    void splashScreen(const char* text);
-
-private:
-    Adafruit_SSD1306 display; ///< The OLED display object.
-
-    unsigned long lastBlinkTime = 0; ///< Timestamp of the last blink toggle.
-    unsigned long blinkInterval = 1000; ///< Interval for blinking warnings (in milliseconds).
-    bool isWarningActive = false; ///< Indicates whether the warning is currently active.
-
-    /**
-     * @brief Displays a headline centered at the top of the screen.
-     * 
-     * @param text The headline text to display.
-     */
-    void showHeadline(const char* text);
-
-    /**
-     * @brief Displays sensor readings on the screen.
-     * 
-     * @param co2 The CO2 level to display.
-     * @param temperatureSCD The temperature from the SCD30 sensor.
-     * @param temperatureBMP The temperature from the BMP280 sensor.
-     * @param humidity The humidity level to display.
-     * @param pressure The pressure level to display.
-     */
-    void displayReadings(float co2, float temperatureSCD, float temperatureBMP, float humidity, float pressure);
-};
-
+#ifndef DISPLAY_MANAGER_H
+#define DISPLAY_MANAGER_H
+
+#include <Adafruit_SSD1306.h>
+#include "Logger.h"
+
+#define SCREEN_WIDTH 128 ///< Width of the OLED display in pixels
+#define SCREEN_HEIGHT 64 ///< Height of the OLED display in pixels
+#define OLED_RESET -1    ///< OLED reset pin (-1 if not used)
+#define SCREEN_ADDRESS 0x3C ///< I2C address of the OLED display
+#define FONT_SIZE_SMALL 1   ///< Font size for small text
+#define FONT_SIZE_LARGE 2   ///< Font size for large text
+#define FONT_SIZE_HUGE 4    ///< Font size for the main value of a page
+#define DISPLAY_BUFFER_BYTES (SCREEN_WIDTH * SCREEN_HEIGHT / 8) ///< Size of the monochrome frame buffer
+// Don't redefine these if they come from libraries
+#ifndef SSD1306_SWITCHCAPVCC
+#define SSD1306_SWITCHCAPVCC 0x02
+#endif
+
+#ifndef SSD1306_WHITE
+#define SSD1306_WHITE 1
+#endif
+
+
+/**
+ * @class DisplayManager
+ * @brief Manages the OLED display for showing messages, warnings, and sensor readings.
+ */
+class DisplayManager {
+public:
+    /**
+     * @brief Constructor for the DisplayManager class.
+     */
+    DisplayManager();
+
+    /**
+     * @brief Initializes the OLED display.
+     * 
+     * @return true if the display was successfully initialized, false otherwise.
+     */
+    bool initialize();
+
+    /**
+     * @brief Displays a calibration message on the screen.
+     * 
+     * @param message1 The first line of the calibration message.
+     * @param message2 The second line of the calibration message.
+     */
+    void showCalibrationMessage(const char* message1, const char* message2);
+
+    /**
+     * @brief Displays a static warning message on the screen.
+     * 
+     * Used when the device sleeps between samples and cannot blink.
+     * 
+     * @param line1 The first line of the warning message.
+     * @param line2 The second line of the warning message.
+     * @param line3 The third line of the warning message.
+     * @param line4 The fourth line of the warning message.
+     */
+    void showWarning(const char* line1, const char* line2, const char* line3, const char* line4);
+
+    /**
+     * @brief Displays the normal screen with sensor readings.
+     * 
+     * @param co2 The CO2 level to display.
+     * @param temperatureSCD The temperature from the SCD30 sensor.
+     * @param temperatureBMP The temperature from the BMP280 sensor.
+     * @param humidity The humidity level to display.
+     * @param pressure The pressure level to display.
+     */
+    void showNormalScreen(float co2, float temperatureSCD, float temperatureBMP, float humidity, float pressure);
+
+    /**
+     * @brief Sets the interval at which warnings blink.
+     * 
+     * @param interval The blink interval in milliseconds.
+     */
+    void setBlinkInterval(unsigned long interval);
+
+    /**
+     * @brief Gets the interval at which warnings blink.
+     * 
+     * @return The blink interval in milliseconds.
+     */
+    unsigned long getBlinkInterval() const;
+
+    /**
+     * @brief Runs a display check to verify the OLED functionality.
+     */
+    void runDisplayCheck();
+
+    /**
+     * @brief Displays a splash screen with a centered message.
+     * 
+     * @param text The message to display on the splash screen.
+     */
+    void splashScreen(const char* text);
+
+    /**
+     * @brief Switches the panel off; the display RAM keeps its content.
+     */
+    void sleep();
+
+    /**
+     * @brief Switches the panel back on.
+     */
+    void wake();
+
+    // Drawing primitives of the display pages; they only change the buffer, `flush()` shows it
+
+    /**
+     * @brief Clears the display buffer.
+     */
+    void clear();
+
+    /**
+     * @brief Draws a headline centered at the top of the screen.
+     * 
+     * @param text The headline text to display.
+     */
+    void drawHeadline(const char* text);
+
+    /**
+     * @brief Draws text at a position.
+     * 
+     * @param x The left edge in pixels.
+     * @param y The top edge in pixels.
+     * @param size The font size (6x8 pixels per character at size 1).
+     * @param text The text to draw.
+     */
+    void drawText(int16_t x, int16_t y, uint8_t size, const char* text);
+
+    /**
+     * @brief Draws text aligned to the right edge of the screen.
+     * 
+     * @param y The top edge in pixels.
+     * @param size The font size.
+     * @param text The text to draw.
+     */
+    void drawTextRight(int16_t y, uint8_t size, const char* text);
+
+    /**
+     * @brief Draws text centered horizontally.
+     * 
+     * @param y The top edge in pixels.
+     * @param size The font size.
+     * @param text The text to draw.
+     */
+    void drawTextCentered(int16_t y, uint8_t size, const char* text);
+
+    /**
+     * @brief Draws the warning message into the display buffer.
+     * 
+     * @param line1 The first line of the warning message.
+     * @param line2 The second line of the warning message.
+     * @param line3 The third line of the warning message.
+     * @param line4 The fourth line of the warning message.
+     */
+    void drawWarning(const char* line1, const char* line2, const char* line3, const char* line4);
+
+    /**
+     * @brief Copies the display buffer, e.g. to cache the background of a page.
+     * 
+     * @param buffer Receives `DISPLAY_BUFFER_BYTES` bytes.
+     */
+    void saveBuffer(uint8_t* buffer);
+
+    /**
+     * @brief Replaces the display buffer with a copy made by `saveBuffer()`.
+     * 
+     * @param buffer The `DISPLAY_BUFFER_BYTES` bytes to restore.
+     */
+    void restoreBuffer(const uint8_t* buffer);
+
+    /**
+     * @brief Transfers the display buffer to the panel.
+     */
+    void flush();
+
+private:
+    Adafruit_SSD1306 display; ///< The OLED display object.
+
+    unsigned long blinkInterval = 1000; ///< Interval for blinking warnings (in milliseconds).
+
+    /**
+     * @brief Draws the sensor readings below the headline into the display buffer.
+     * 
+     * @param co2 The CO2 level to display.
+     * @param temperatureSCD The temperature from the SCD30 sensor.
+     * @param temperatureBMP The temperature from the BMP280 sensor.
+     * @param humidity The humidity level to display.
+     * @param pressure The pressure level to display.
+     */
+    void displayReadings(float co2, float temperatureSCD, float temperatureBMP, float humidity, float pressure);
+};
+
 #endif // DISPLAY_MANAGER_H
\ No newline at end of file
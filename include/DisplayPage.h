@@ -0,0 +1,95 @@
+#ifndef DISPLAY_PAGE_H
+#define DISPLAY_PAGE_H
+
+#include <stdint.h>
+#include "AlertMonitor.h"
+#include "DisplayManager.h"
+
+/**
+ * @file DisplayPage.h
+ * @brief The values shown on the display and the interface of a display page.
+ */
+
+/**
+ * @brief Groups of `DisplayModel` values; a page is redrawn only when one of its groups changes.
+ */
+enum DisplayInput : uint8_t {
+    INPUT_READINGS = 0x01,    ///< CO2, temperatures, humidity and pressure
+    INPUT_ALERT = 0x02,       ///< Alert level
+    INPUT_EXPOSURE = 0x04,    ///< Exposure of the running day and its thresholds
+    INPUT_VENTILATION = 0x08, ///< Result of the last ventilation episode
+    INPUT_HEALTH = 0x10       ///< Uptime, heap and timing of the device
+};
+
+/**
+ * @struct DisplayModel
+ * @brief Everything the pages show, written by the measurement path and read by the pages.
+ */
+struct DisplayModel {
+    float co2; ///< Filtered CO2 in ppm
+    float temperatureSCD; ///< Compensated SCD30 temperature in °C
+    float temperatureBMP; ///< BMP280 temperature in °C
+    float humidity; ///< Relative humidity in %
+    float pressure; ///< Pressure in hPa
+    AlertLevel alertLevel; ///< Alert level of the filtered CO2
+
+    float moderateThreshold; ///< Moderate exposure threshold in ppm
+    float criticalThreshold; ///< Critical exposure threshold in ppm
+    float moderatePpmHours; ///< Exposure above the moderate threshold today in ppm*h
+    float moderateMinutes; ///< Time above the moderate threshold today in minutes
+    float criticalPpmHours; ///< Exposure above the critical threshold today in ppm*h
+    float criticalMinutes; ///< Time above the critical threshold today in minutes
+
+    bool ventilationAvailable; ///< Whether an air change rate has been estimated
+    float airChangesPerHour; ///< Last air change rate in 1/h
+    float fitQuality; ///< R^2 of the last decay fit
+    float episodeMinutes; ///< Duration of the last decay episode in minutes
+
+    uint32_t uptimeSeconds; ///< Time since boot in s
+    uint32_t freeHeap; ///< Free heap in bytes
+    uint32_t samples; ///< Samples processed since boot
+    uint32_t loopBusyMaxUs; ///< Longest loop iteration in us
+    uint32_t renderMaxUs; ///< Longest page render in us
+};
+
+/**
+ * @class DisplayPage
+ * @brief One screen of the display, split into a static background and the changing content.
+ *
+ * The `PageManager` caches the background as a bitmap, so `drawContent()` only draws the
+ * values on top of it. Pages draw through the `DisplayManager` primitives and must not
+ * call `DisplayManager::flush()`.
+ */
+class DisplayPage {
+public:
+    virtual ~DisplayPage() = default;
+
+    /**
+     * @brief Retrieves the `DisplayInput` groups the content depends on.
+     */
+    virtual uint8_t getInputs() const = 0;
+
+    /**
+     * @brief Retrieves the interval at which the content changes on its own, e.g. to blink.
+     *
+     * @return The interval in ms, or 0 if the content only changes with the inputs.
+     */
+    virtual unsigned long getRefreshInterval() const { return 0; }
+
+    /**
+     * @brief Draws the static parts of the page into a cleared buffer.
+     *
+     * @param display The display to draw on.
+     */
+    virtual void drawBackground(DisplayManager& display) = 0;
+
+    /**
+     * @brief Draws the current values on top of the background.
+     *
+     * @param display The display to draw on.
+     * @param now The current time in ms.
+     */
+    virtual void drawContent(DisplayManager& display, unsigned long now) = 0;
+};
+
+#endif // DISPLAY_PAGE_H
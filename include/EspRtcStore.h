@@ -0,0 +1,51 @@
+#ifndef ESP_RTC_STORE_H
+#define ESP_RTC_STORE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "PowerManager.h"
+
+/**
+ * @file EspRtcStore.h
+ * @brief Retained state storage in the ESP8266 RTC user memory.
+ */
+
+/**
+ * @class EspRtcStore
+ * @brief Keeps the record in the 512 bytes of RTC user memory, which survive deep sleep.
+ *
+ * The record starts at block `RTC_STATE_OFFSET_BLOCKS`; the blocks before it are left to
+ * the OTA bootloader.
+ */
+class EspRtcStore : public RtcStore {
+private:
+    uint32_t offsetBlocks; ///< First 4-byte block of the record
+
+public:
+    /**
+     * @brief Constructs the store.
+     *
+     * @param offsetBlocks The first 4-byte block of the record.
+     */
+    explicit EspRtcStore(uint32_t offsetBlocks = RTC_STATE_OFFSET_BLOCKS);
+
+    /**
+     * @brief Reads the retained record.
+     *
+     * @param data Receives the record; must be 4-byte aligned.
+     * @param size The record size in bytes, a multiple of 4.
+     * @return `true` if the read succeeded, `false` otherwise.
+     */
+    bool read(void* data, size_t size) override;
+
+    /**
+     * @brief Writes the retained record.
+     *
+     * @param data The record; must be 4-byte aligned.
+     * @param size The record size in bytes, a multiple of 4.
+     * @return `true` if the write succeeded, `false` otherwise.
+     */
+    bool write(const void* data, size_t size) override;
+};
+
+#endif // ESP_RTC_STORE_H
@@ -0,0 +1,209 @@
+#ifndef EXPOSURE_ACCUMULATOR_H
+#define EXPOSURE_ACCUMULATOR_H
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @file ExposureAccumulator.h
+ * @brief Integrates the time-weighted CO2 exposure above the alert thresholds.
+ */
+
+/**
+ * @enum ExposureBand
+ * @brief Threshold bands for which exposure is accumulated.
+ */
+enum ExposureBand {
+    EXPOSURE_MODERATE = 0, ///< Above the moderate alert threshold
+    EXPOSURE_CRITICAL = 1, ///< Above the critical alert threshold
+    EXPOSURE_BAND_COUNT = 2 ///< Number of bands
+};
+
+/**
+ * @struct ExposureTotals
+ * @brief Exposure accumulated over one rollup period.
+ */
+struct ExposureTotals {
+    float ppmHours[EXPOSURE_BAND_COUNT]; ///< CO2 excess above the band threshold integrated over time in ppm*h
+    float secondsAbove[EXPOSURE_BAND_COUNT]; ///< Time spent above the band threshold in s
+};
+
+/**
+ * @struct ExposureRunningState
+ * @brief Snapshot of the running hour and day, which EEPROM only receives on rollovers.
+ *
+ * Used to carry the unsaved part of the accumulation across deep sleep.
+ */
+struct ExposureRunningState {
+    uint8_t currentHour; ///< Slot of the running hour
+    uint8_t currentDay; ///< Slot of the running day
+    uint8_t hoursInDay; ///< Completed hours of the running day
+    uint8_t hasLastSample; ///< Whether lastCO2 and lastTimestamp are valid
+    uint32_t hourElapsedMs; ///< Operating time already spent in the running hour in ms
+    ExposureTotals hour; ///< Totals of the running hour
+    ExposureTotals day; ///< Totals of the running day
+    float lastCO2; ///< Previous CO2 sample in ppm
+    uint32_t lastTimestamp; ///< Timestamp of the previous sample in ms
+};
+
+/**
+ * @class ExposureAccumulator
+ * @brief Accumulates ppm-hours and time above the CO2 thresholds with hourly and daily rollups.
+ *
+ * Consecutive samples are joined by straight lines, and the area above each threshold is
+ * integrated exactly, including partial segments that cross a threshold. Irregular sample
+ * spacing is therefore handled correctly. Every sample costs O(1): it updates the current
+ * hour and the current day in place.
+ *
+ * The device has no wall clock, so hours and days are counted in operating time. The rollup
+ * tables and the position within the current hour are persisted to EEPROM on every hour
+ * rollover, so a reboot loses at most the exposure of the running hour.
+ */
+class ExposureAccumulator {
+private:
+    /**
+     * @struct History
+     * @brief Persisted rollup tables.
+     */
+    struct History {
+        uint32_t magic; ///< Marks an initialized record
+        uint8_t currentHour; ///< Slot of the running hour in `hours`
+        uint8_t currentDay; ///< Slot of the running day in `days`
+        uint8_t hoursInDay; ///< Completed hours of the running day
+        uint8_t reserved; ///< Padding
+        uint32_t hourElapsedMs; ///< Operating time already spent in the running hour in ms
+        ExposureTotals hours[EXPOSURE_HOUR_COUNT]; ///< Ring of hourly rollups
+        ExposureTotals days[EXPOSURE_DAY_COUNT]; ///< Ring of daily rollups
+        uint32_t checksum; ///< Checksum over all preceding fields
+    };
+
+    History history; ///< Rollup tables, mirrored to EEPROM
+    float thresholds[EXPOSURE_BAND_COUNT]; ///< Band thresholds in ppm
+
+    bool hasLastSample = false; ///< Whether lastCO2 and lastTimestamp are valid
+    float lastCO2 = 0.0f; ///< Previous CO2 sample in ppm
+    unsigned long lastTimestamp = 0; ///< Timestamp of the previous sample in ms
+
+    /**
+     * @brief Advances the operating clock and performs hour and day rollovers.
+     *
+     * @param elapsedMs Operating time since the previous sample in ms.
+     */
+    void advanceClock(unsigned long elapsedMs);
+
+    /**
+     * @brief Computes the checksum of the history record.
+     *
+     * @return The checksum over all fields except `checksum` itself.
+     */
+    uint32_t computeChecksum() const;
+
+    /**
+     * @brief Clears all rollup tables.
+     */
+    void clearHistory();
+
+    /**
+     * @brief Logs one rollup period.
+     *
+     * @param label The name of the period (e.g. "hour").
+     * @param totals The totals to log.
+     */
+    void logTotals(const char* label, const ExposureTotals& totals) const;
+
+public:
+    /**
+     * @brief Constructs the accumulator with the configured alert thresholds.
+     */
+    ExposureAccumulator();
+
+    /**
+     * @brief Restores the rollup tables from EEPROM.
+     *
+     * `EEPROM.begin()` must have been called before. An invalid record starts empty tables.
+     */
+    void begin();
+
+    /**
+     * @brief Writes the rollup tables to EEPROM.
+     *
+     * @return `true` if the EEPROM commit succeeded, `false` otherwise.
+     */
+    bool save();
+
+    /**
+     * @brief Sets the band thresholds, normally to the alert thresholds.
+     *
+     * Samples from then on are integrated against the new thresholds; the totals
+     * accumulated so far are kept.
+     *
+     * @param moderate The moderate threshold in ppm.
+     * @param critical The critical threshold in ppm.
+     * @return `true` if the thresholds were accepted, `false` if they are not ordered or not positive.
+     */
+    bool setThresholds(float moderate, float critical);
+
+    /**
+     * @brief Retrieves the threshold of a band.
+     *
+     * @param band The band.
+     * @return The threshold in ppm.
+     */
+    float getThreshold(ExposureBand band) const;
+
+    /**
+     * @brief Integrates the exposure since the previous sample.
+     *
+     * @param co2 The CO2 concentration in ppm.
+     * @param timestampMs The sample timestamp in ms (e.g. from `millis()`).
+     */
+    void addSample(float co2, unsigned long timestampMs);
+
+    /**
+     * @brief Captures the running hour and day.
+     *
+     * @param state Receives the snapshot.
+     */
+    void getRunningState(ExposureRunningState& state) const;
+
+    /**
+     * @brief Continues the running hour and day from a snapshot.
+     *
+     * Call after `begin()`.
+     *
+     * @param state The snapshot.
+     * @return `true` if the snapshot matched the restored tables and was applied.
+     */
+    bool setRunningState(const ExposureRunningState& state);
+
+    /**
+     * @brief Retrieves an hourly rollup.
+     *
+     * @param hoursAgo 0 for the running hour, 1 for the previous hour, and so on.
+     * @return The totals of that hour.
+     */
+    const ExposureTotals& getHour(uint8_t hoursAgo = 0) const;
+
+    /**
+     * @brief Retrieves a daily rollup.
+     *
+     * @param daysAgo 0 for the running day, 1 for the previous day, and so on.
+     * @return The totals of that day.
+     */
+    const ExposureTotals& getDay(uint8_t daysAgo = 0) const;
+
+    /**
+     * @brief Logs a single rollup.
+     *
+     * @param index 0 to `EXPOSURE_HOUR_COUNT` - 1 selects an hour (newest first), the
+     *              following `EXPOSURE_DAY_COUNT` indices select a day (newest first).
+     */
+    void logEntry(uint8_t index) const;
+
+    /**
+     * @brief Logs all hourly and daily rollups.
+     */
+    void logHistory() const;
+};
+
+#endif // EXPOSURE_ACCUMULATOR_H
\ No newline at end of file
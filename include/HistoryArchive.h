@@ -0,0 +1,64 @@
+#ifndef HISTORY_ARCHIVE_H
+#define HISTORY_ARCHIVE_H
+
+#include <stdint.h>
+#include "config.h"
+#include "HistoryCodec.h"
+
+/**
+ * @file HistoryArchive.h
+ * @brief Ring of compressed history blocks kept in RAM for export.
+ */
+
+/**
+ * @class HistoryArchive
+ * @brief Keeps the most recent `HISTORY_ARCHIVE_BLOCKS` encoded blocks.
+ *
+ * Samples are appended to the newest block; once it is full, the oldest block is reused.
+ * The memory footprint is fixed at `HISTORY_ARCHIVE_BLOCKS` * `HISTORY_BLOCK_BYTES`.
+ */
+class HistoryArchive {
+private:
+    HistoryEncoder blocks[HISTORY_ARCHIVE_BLOCKS]; ///< Block ring
+    uint8_t newest = 0; ///< Index of the block receiving samples
+    uint8_t count = 1; ///< Number of blocks in use
+    uint32_t samples = 0; ///< Samples appended since start
+
+public:
+    /**
+     * @brief Appends a sample, starting a new block if the current one is full.
+     *
+     * @param sample The sample to store.
+     */
+    void append(const HistorySample& sample);
+
+    /**
+     * @brief Retrieves the number of blocks in use.
+     */
+    uint8_t getBlockCount() const;
+
+    /**
+     * @brief Retrieves a block.
+     *
+     * @param index 0 for the oldest block up to `getBlockCount()` - 1 for the newest.
+     * @return The block.
+     */
+    const HistoryEncoder& getBlock(uint8_t index) const;
+
+    /**
+     * @brief Retrieves the number of samples appended since start.
+     */
+    uint32_t getTotalSamples() const;
+
+    /**
+     * @brief Retrieves the number of samples currently held.
+     */
+    uint32_t getStoredSamples() const;
+
+    /**
+     * @brief Retrieves the number of encoded bytes currently held.
+     */
+    uint32_t getStoredBytes() const;
+};
+
+#endif // HISTORY_ARCHIVE_H
\ No newline at end of file
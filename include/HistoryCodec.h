@@ -0,0 +1,191 @@
+#ifndef HISTORY_CODEC_H
+#define HISTORY_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @file HistoryCodec.h
+ * @brief Compact block encoding of the measurement history for export over the serial port.
+ */
+
+#define HISTORY_FORMAT_VERSION 1 ///< Version byte at the start of every block
+#define HISTORY_HEADER_BYTES 4   ///< Version, channel count and 16-bit sample count
+
+/**
+ * @brief The channels of one history sample, in the order produced by `SensorManager`.
+ */
+enum HistoryChannel {
+    HISTORY_CO2,          ///< CO2 concentration in ppm
+    HISTORY_TEMP_SCD,     ///< SCD30 temperature in °C
+    HISTORY_TEMP_BMP,     ///< BMP280 temperature in °C
+    HISTORY_HUMIDITY,     ///< Relative humidity in %
+    HISTORY_PRESSURE,     ///< Pressure in hPa
+    HISTORY_CHANNEL_COUNT ///< Number of channels
+};
+
+/**
+ * @struct HistorySample
+ * @brief One timestamped set of readings.
+ */
+struct HistorySample {
+    uint32_t timestampMs;                 ///< `millis()` at the time of the reading
+    float values[HISTORY_CHANNEL_COUNT];  ///< Readings indexed by `HistoryChannel`
+};
+
+/**
+ * @class HistoryEncoder
+ * @brief Encodes samples incrementally into one fixed-size block.
+ *
+ * The scheme follows Gorilla (Pelkonen et al., VLDB 2015) with integer values:
+ * - Timestamps are stored as the delta of the previous delta. A steady sample interval
+ *   costs one bit; loop jitter of a few ms costs 9 bits.
+ * - Values are quantized to 1/`HISTORY_VALUE_RESOLUTION` (the two decimals `loop()` logs)
+ *   and stored as zigzag deltas of the previous value in a prefix-coded width class.
+ *   Noisy sensor floats share few bits with their predecessor, so XOR coding of the raw
+ *   floats would save much less than quantized deltas.
+ * - Each block starts with a full sample and can be decoded on its own.
+ *
+ * The encoder never allocates and needs no Arduino headers, so the same code runs on the
+ * host decoder and benchmark.
+ */
+class HistoryEncoder {
+private:
+    uint8_t buffer[HISTORY_BLOCK_BYTES]; ///< Header followed by the bit stream
+    size_t bitPosition; ///< Number of bits written including the header
+    uint16_t sampleCount; ///< Number of samples in the block
+    uint32_t lastTimestamp; ///< Timestamp of the previous sample in ms
+    uint32_t lastDelta; ///< Timestamp delta of the previous sample in ms
+    int32_t lastValues[HISTORY_CHANNEL_COUNT]; ///< Quantized values of the previous sample
+
+    /**
+     * @brief Appends the lowest bits of a value, most significant bit first.
+     *
+     * @param value The bits to write.
+     * @param count The number of bits (at most 32).
+     */
+    void writeBits(uint32_t value, uint8_t count);
+
+public:
+    /**
+     * @brief Constructs an empty block.
+     */
+    HistoryEncoder();
+
+    /**
+     * @brief Discards the block contents.
+     */
+    void reset();
+
+    /**
+     * @brief Appends a sample if it fits into the block.
+     *
+     * @param sample The sample to encode.
+     * @return `true` if the sample was added, `false` if the block is full.
+     */
+    bool append(const HistorySample& sample);
+
+    /**
+     * @brief Retrieves the encoded block.
+     */
+    const uint8_t* getData() const;
+
+    /**
+     * @brief Retrieves the size of the encoded block in bytes.
+     */
+    size_t getSize() const;
+
+    /**
+     * @brief Retrieves the number of samples in the block.
+     */
+    uint16_t getSampleCount() const;
+};
+
+/**
+ * @class HistoryDecoder
+ * @brief Decodes the samples of one block produced by `HistoryEncoder`.
+ */
+class HistoryDecoder {
+private:
+    const uint8_t* data = nullptr; ///< The block
+    size_t size = 0; ///< Size of the block in bytes
+    size_t bitPosition = 0; ///< Read position in bits
+    uint16_t sampleCount = 0; ///< Number of samples in the block
+    uint16_t decoded = 0; ///< Number of samples returned so far
+    uint32_t lastTimestamp = 0; ///< Timestamp of the previous sample in ms
+    uint32_t lastDelta = 0; ///< Timestamp delta of the previous sample in ms
+    int32_t lastValues[HISTORY_CHANNEL_COUNT] = {}; ///< Quantized values of the previous sample
+
+    /**
+     * @brief Reads bits, most significant bit first.
+     *
+     * @param count The number of bits (at most 32).
+     * @param value Receives the bits.
+     * @return `true` on success, `false` if the block ends early.
+     */
+    bool readBits(uint8_t count, uint32_t& value);
+
+    /**
+     * @brief Reads a width class prefix.
+     *
+     * @param widthClass Receives the class (0-4).
+     * @return `true` on success, `false` if the block ends early.
+     */
+    bool readClass(uint8_t& widthClass);
+
+public:
+    /**
+     * @brief Starts decoding a block.
+     *
+     * @param data The block.
+     * @param size The size of the block in bytes.
+     * @return `true` if the header is valid, `false` otherwise.
+     */
+    bool begin(const uint8_t* data, size_t size);
+
+    /**
+     * @brief Decodes the next sample.
+     *
+     * @param sample Receives the sample.
+     * @return `true` on success, `false` at the end of the block or if it is corrupt.
+     */
+    bool next(HistorySample& sample);
+
+    /**
+     * @brief Retrieves the number of samples announced by the block header.
+     */
+    uint16_t getSampleCount() const;
+};
+
+/**
+ * @brief Converts a reading to the integer representation stored in the block.
+ *
+ * @param value The reading.
+ * @return The reading in steps of 1/`HISTORY_VALUE_RESOLUTION`; NaN maps to 0.
+ */
+int32_t quantizeReading(float value);
+
+/**
+ * @brief Encodes binary data as base64 text.
+ *
+ * @param data The data.
+ * @param size The size of the data in bytes.
+ * @param out Receives the NUL-terminated text.
+ * @param outSize The size of `out`; at least `4 * ((size + 2) / 3) + 1` bytes.
+ * @return The length of the text, or 0 if `out` is too small.
+ */
+size_t encodeBase64(const uint8_t* data, size_t size, char* out, size_t outSize);
+
+/**
+ * @brief Decodes base64 text.
+ *
+ * @param text The text.
+ * @param length The length of the text.
+ * @param out Receives the data.
+ * @param outSize The size of `out` in bytes.
+ * @return The size of the data in bytes, or 0 if the text is invalid or `out` is too small.
+ */
+size_t decodeBase64(const char* text, size_t length, uint8_t* out, size_t outSize);
+
+#endif // HISTORY_CODEC_H
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef HTTP_REQUEST_SCANNER_H
+#define HTTP_REQUEST_SCANNER_H
+
+#include <stddef.h>
+#include "config.h"
+
+/**
+ * @file HttpRequestScanner.h
+ * @brief Incremental scanner for the minimal HTTP requests of a metrics scraper.
+ */
+
+/**
+ * @brief Result of scanning a request.
+ */
+enum HttpRequestTarget {
+    HTTP_PENDING,     ///< The request is not complete yet
+    HTTP_METRICS,     ///< `GET /metrics`
+    HTTP_NOT_FOUND,   ///< A valid request for another resource
+    HTTP_BAD_REQUEST  ///< A malformed or oversized request
+};
+
+/**
+ * @class HttpRequestScanner
+ * @brief Consumes a request one byte at a time until the end of its headers.
+ *
+ * Only the request line is kept (`HTTP_REQUEST_LINE_SIZE` bytes); header lines are skipped
+ * without buffering. Requests longer than `HTTP_MAX_REQUEST_BYTES` are rejected.
+ */
+class HttpRequestScanner {
+private:
+    char requestLine[HTTP_REQUEST_LINE_SIZE]; ///< First line of the request
+    size_t lineLength = 0; ///< Characters in `requestLine`
+    size_t total = 0; ///< Bytes consumed
+    bool lineComplete = false; ///< Whether the request line has ended
+    bool lineOverflow = false; ///< Whether the request line exceeded the buffer
+    bool atLineStart = false; ///< Whether the previous byte ended a header line
+
+    /**
+     * @brief Classifies the complete request line.
+     */
+    HttpRequestTarget classify();
+
+public:
+    /**
+     * @brief Prepares for a new request.
+     */
+    void reset();
+
+    /**
+     * @brief Consumes one byte of the request.
+     *
+     * @param c The byte.
+     * @return `HTTP_PENDING` until the headers end, then the classification.
+     */
+    HttpRequestTarget feed(char c);
+};
+
+#endif // HTTP_REQUEST_SCANNER_H
\ No newline at end of file
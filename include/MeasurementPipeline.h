@@ -0,0 +1,153 @@
+#ifndef MEASUREMENT_PIPELINE_H
+#define MEASUREMENT_PIPELINE_H
+
+#include <stdint.h>
+#include "config.h"
+#include "AlertMonitor.h"
+#include "DisplayPage.h"
+#include "ExposureAccumulator.h"
+#include "HistoryCodec.h"
+#include "PageManager.h"
+#include "PressureCompensator.h"
+#include "SensorFilter.h"
+#include "SensorManager.h"
+#include "TraceRecorder.h"
+#include "VentilationEstimator.h"
+
+/**
+ * @file MeasurementPipeline.h
+ * @brief The per-sample path from the sensors through the filters and alerts to the display.
+ */
+
+/**
+ * @brief Timed stages of the pipeline.
+ */
+enum PipelineStage {
+    STAGE_POLL,    ///< `SensorManager::isDataAvailable()`
+    STAGE_READ,    ///< Reading the SCD30 and BMP280 values
+    STAGE_PROCESS, ///< Filter, pressure compensation, exposure and ventilation
+    STAGE_ALERT,   ///< Alert evaluation
+    STAGE_DISPLAY, ///< Display model update, page selection and rendering
+    STAGE_COUNT    ///< Number of stages
+};
+
+/**
+ * @struct PipelineStageTiming
+ * @brief Execution time statistics of one stage.
+ */
+struct PipelineStageTiming {
+    uint32_t lastUs; ///< Duration of the last run in us
+    uint32_t maxUs; ///< Longest run in us
+    uint32_t count; ///< Number of runs
+    uint64_t totalUs; ///< Sum of all runs in us
+};
+
+/**
+ * @struct PipelineReadings
+ * @brief Results of the last processed sample.
+ */
+struct PipelineReadings {
+    HistorySample raw; ///< Raw readings as taken from the sensors
+    float co2; ///< Filtered CO2 in ppm
+    float temperatureSCD; ///< SCD30 temperature without the self-heating bias in °C
+    AlertLevel alertLevel; ///< Alert level of the filtered CO2
+};
+
+/**
+ * @class MeasurementPipeline
+ * @brief Runs one sensor poll per call and, when data is ready, the complete sample path.
+ *
+ * `loop()` and the host replay harness (`tools/trace-replay`) share this code, so a
+ * recorded trace exercises exactly what runs on the device. Every `isDataAvailable()` call
+ * and every sample is handed to the `TraceRecorder`, and each stage is timed with `micros()`.
+ *
+ * All timestamps come from the `now` argument, including the blink phase of the alert
+ * page, so the pipeline runs deterministically under a virtual clock.
+ */
+class MeasurementPipeline {
+private:
+    SensorManager& sensorManager; ///< Source of the readings
+    SensorFilter& sensorFilter; ///< CO2 smoothing and temperature fusion
+    PressureCompensator& pressureCompensator; ///< Ambient pressure forwarding
+    ExposureAccumulator& exposureAccumulator; ///< Exposure rollups
+    VentilationEstimator& ventilationEstimator; ///< Air change rate estimation
+    AlertMonitor& alertMonitor; ///< Alert thresholds and level
+    PageManager& pageManager; ///< Selection and rendering of the pages
+    DisplayModel& displayModel; ///< Values shown by the pages
+    TraceRecorder& traceRecorder; ///< Recorder of the raw stream
+
+    PipelineReadings readings = {}; ///< Results of the last sample
+    PipelineStageTiming timing[STAGE_COUNT] = {}; ///< Timing per stage
+
+    /**
+     * @brief Adds one run to the statistics of a stage.
+     *
+     * @param stage The stage.
+     * @param startUs `micros()` at the start of the run.
+     * @return `micros()` at the end of the run, i.e. the start of the next stage.
+     */
+    uint32_t endStage(PipelineStage stage, uint32_t startUs);
+
+    /**
+     * @brief Copies the sample into the display model and selects the page.
+     *
+     * @param now The sample time in ms.
+     * @param previousLevel The alert level of the previous sample.
+     * @param ventilationCompleted Whether the sample completed a ventilation episode.
+     */
+    void updateDisplay(unsigned long now, AlertLevel previousLevel, bool ventilationCompleted);
+
+public:
+    /**
+     * @brief Constructs the pipeline.
+     *
+     * @param sensorManager The source of the readings.
+     * @param sensorFilter The CO2 and temperature filter.
+     * @param pressureCompensator The ambient pressure compensator.
+     * @param exposureAccumulator The exposure accumulator.
+     * @param ventilationEstimator The ventilation estimator.
+     * @param alertMonitor The alert monitor.
+     * @param pageManager The page manager, e.g. showing the `MeterPages`.
+     * @param displayModel The values shown by the pages.
+     * @param traceRecorder The recorder of the raw stream.
+     */
+    MeasurementPipeline(SensorManager& sensorManager, SensorFilter& sensorFilter,
+                        PressureCompensator& pressureCompensator, ExposureAccumulator& exposureAccumulator,
+                        VentilationEstimator& ventilationEstimator, AlertMonitor& alertMonitor,
+                        PageManager& pageManager, DisplayModel& displayModel, TraceRecorder& traceRecorder);
+
+    /**
+     * @brief Polls the sensors and processes a sample if one is ready.
+     *
+     * @param now The current time in ms.
+     * @return `true` if a sample was processed, `false` if no data was available.
+     */
+    bool poll(unsigned long now);
+
+    /**
+     * @brief Retrieves the results of the last processed sample.
+     */
+    const PipelineReadings& getReadings() const;
+
+    /**
+     * @brief Retrieves the timing statistics of a stage.
+     *
+     * @param stage The stage.
+     */
+    const PipelineStageTiming& getTiming(PipelineStage stage) const;
+
+    /**
+     * @brief Clears the timing statistics.
+     */
+    void resetTiming();
+
+    /**
+     * @brief Retrieves the name of a stage.
+     *
+     * @param stage The stage.
+     * @return A short lower-case name.
+     */
+    static const char* getStageName(PipelineStage stage);
+};
+
+#endif // MEASUREMENT_PIPELINE_H
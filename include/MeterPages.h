@@ -0,0 +1,174 @@
+#ifndef METER_PAGES_H
+#define METER_PAGES_H
+
+#include "DisplayPage.h"
+#include "SensorGroup.h"
+
+/**
+ * @file MeterPages.h
+ * @brief The pages of the CO2 meter.
+ */
+
+/**
+ * @brief Indices of the pages in `MeterPages::getPages()`.
+ *
+ * The pages before `PAGE_ALERT` take part in the rotation; the alert page is only shown
+ * while an alert is active.
+ */
+enum MeterPage {
+    PAGE_OVERVIEW,    ///< CO2 in a large font with the alert state, temperature and humidity
+    PAGE_DETAIL,      ///< All readings
+    PAGE_EXPOSURE,    ///< Exposure of the running day
+    PAGE_VENTILATION, ///< Result of the last ventilation episode
+    PAGE_HEALTH,      ///< Uptime, heap and timing
+    PAGE_ALERT,       ///< Blinking warning alternating with the readings
+    PAGE_COUNT        ///< Number of pages
+};
+
+#define PAGE_ROTATION_COUNT PAGE_ALERT ///< Number of pages in the rotation
+
+/**
+ * @class OverviewPage
+ * @brief Shows the CO2 concentration in a large font.
+ */
+class OverviewPage : public DisplayPage {
+private:
+    const DisplayModel& model; ///< Values shown
+
+public:
+    explicit OverviewPage(const DisplayModel& model);
+    uint8_t getInputs() const override;
+    void drawBackground(DisplayManager& display) override;
+    void drawContent(DisplayManager& display, unsigned long now) override;
+};
+
+/**
+ * @class DetailPage
+ * @brief Shows all readings with their labels.
+ */
+class DetailPage : public DisplayPage {
+private:
+    const DisplayModel& model; ///< Values shown
+
+public:
+    explicit DetailPage(const DisplayModel& model);
+    uint8_t getInputs() const override;
+    void drawBackground(DisplayManager& display) override;
+    void drawContent(DisplayManager& display, unsigned long now) override;
+};
+
+/**
+ * @class ExposurePage
+ * @brief Shows the time and exposure above the alert thresholds today.
+ */
+class ExposurePage : public DisplayPage {
+private:
+    const DisplayModel& model; ///< Values shown
+
+public:
+    explicit ExposurePage(const DisplayModel& model);
+    uint8_t getInputs() const override;
+    void drawBackground(DisplayManager& display) override;
+    void drawContent(DisplayManager& display, unsigned long now) override;
+};
+
+/**
+ * @class VentilationPage
+ * @brief Shows the air change rate of the last ventilation episode.
+ */
+class VentilationPage : public DisplayPage {
+private:
+    const DisplayModel& model; ///< Values shown
+
+public:
+    explicit VentilationPage(const DisplayModel& model);
+    uint8_t getInputs() const override;
+    void drawBackground(DisplayManager& display) override;
+    void drawContent(DisplayManager& display, unsigned long now) override;
+};
+
+/**
+ * @class HealthPage
+ * @brief Shows the uptime, free heap, sample count and the loop and render times.
+ */
+class HealthPage : public DisplayPage {
+private:
+    const DisplayModel& model; ///< Values shown
+
+public:
+    explicit HealthPage(const DisplayModel& model);
+    uint8_t getInputs() const override;
+    void drawBackground(DisplayManager& display) override;
+    void drawContent(DisplayManager& display, unsigned long now) override;
+};
+
+/**
+ * @class AlertPage
+ * @brief Alternates the warning with the readings at the blink interval of the display.
+ *
+ * The blink phase is derived from `now`, so the page needs no state and blinks in step
+ * with the virtual clock of the replay harness.
+ */
+class AlertPage : public DisplayPage {
+private:
+    const DisplayModel& model; ///< Values shown
+    const DisplayManager& displayManager; ///< Source of the blink interval
+
+public:
+    AlertPage(const DisplayModel& model, const DisplayManager& displayManager);
+    uint8_t getInputs() const override;
+    unsigned long getRefreshInterval() const override;
+    void drawBackground(DisplayManager& display) override;
+    void drawContent(DisplayManager& display, unsigned long now) override;
+};
+
+/**
+ * @class RoomsPage
+ * @brief Lists the filtered CO2 and alert state of every room of a `SensorGroup`.
+ *
+ * One row of 8 pixels per room fits the eight channels of a TCA9548A.
+ */
+class RoomsPage : public DisplayPage {
+private:
+    const SensorGroup& sensorGroup; ///< Rooms shown
+
+public:
+    explicit RoomsPage(const SensorGroup& sensorGroup);
+    uint8_t getInputs() const override;
+    void drawBackground(DisplayManager& display) override;
+    void drawContent(DisplayManager& display, unsigned long now) override;
+};
+
+/**
+ * @class MeterPages
+ * @brief Owns one instance of every page, indexed by `MeterPage`.
+ */
+class MeterPages {
+private:
+    OverviewPage overview; ///< `PAGE_OVERVIEW`
+    DetailPage detail; ///< `PAGE_DETAIL`
+    ExposurePage exposure; ///< `PAGE_EXPOSURE`
+    VentilationPage ventilation; ///< `PAGE_VENTILATION`
+    HealthPage health; ///< `PAGE_HEALTH`
+    AlertPage alert; ///< `PAGE_ALERT`
+    DisplayPage* pages[PAGE_COUNT]; ///< The pages above in `MeterPage` order
+
+public:
+    /**
+     * @brief Constructs the pages.
+     *
+     * @param model The values shown.
+     * @param displayManager The display, for the blink interval of the alert page.
+     */
+    MeterPages(const DisplayModel& model, const DisplayManager& displayManager);
+
+    MeterPages(const MeterPages&) = delete;
+    MeterPages& operator=(const MeterPages&) = delete;
+
+    /**
+     * @brief Retrieves the pages in `MeterPage` order.
+     */
+    DisplayPage* const* getPages();
+};
+
+#endif // METER_PAGES_H
@@ -0,0 +1,100 @@
+#ifndef METRICS_PAGE_H
+#define METRICS_PAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @file MetricsPage.h
+ * @brief Pre-rendered Prometheus response whose values are patched in place.
+ */
+
+/**
+ * @brief The values exposed on the metrics page.
+ */
+enum MetricField {
+    METRIC_CO2,                ///< Raw CO2 concentration in ppm
+    METRIC_CO2_FILTERED,       ///< Filtered CO2 concentration in ppm
+    METRIC_TEMPERATURE_SCD,    ///< SCD30 temperature (self-heating compensated) in °C
+    METRIC_TEMPERATURE_BMP,    ///< BMP280 temperature in °C
+    METRIC_HUMIDITY,           ///< Relative humidity in %
+    METRIC_PRESSURE,           ///< Pressure in hPa
+    METRIC_ALERT_LEVEL,        ///< `AlertLevel` (0 = none, 1 = moderate, 2 = critical)
+    METRIC_SAMPLES,            ///< Samples processed since boot
+    METRIC_LOOP_LAST,          ///< Busy time of the last `loop()` iteration in s
+    METRIC_LOOP_MAX,           ///< Longest busy time of a `loop()` iteration in s
+    METRIC_FREE_HEAP,          ///< Free heap in bytes
+    METRIC_UPTIME,             ///< Uptime in s
+    METRIC_SCRAPES,            ///< Scrapes served since boot
+    METRIC_FIELD_COUNT         ///< Number of fields
+};
+
+/**
+ * @class MetricsPage
+ * @brief Complete HTTP response with a Prometheus text body in one fixed buffer.
+ *
+ * The response, including the status line and headers, is rendered once at construction.
+ * Every value occupies a fixed-width, space-padded slot, so the body length never changes
+ * and `setValue()` only overwrites the digits of one slot. A scrape therefore costs no
+ * formatting and is served straight from `getResponse()`.
+ *
+ * While a response is being sent in several pieces, `hold()` defers updates so a slot is
+ * never changed half-way through its transmission; `release()` applies them.
+ */
+class MetricsPage {
+private:
+    char buffer[METRICS_BUFFER_SIZE]; ///< Headers followed by the body
+    size_t length = 0; ///< Length of the response in bytes
+    uint16_t offsets[METRIC_FIELD_COUNT] = {}; ///< Position of each value slot in `buffer`
+    uint8_t decimals[METRIC_FIELD_COUNT] = {}; ///< Decimals printed per field
+    bool held = false; ///< Whether updates are deferred
+    double pending[METRIC_FIELD_COUNT] = {}; ///< Deferred values
+    uint32_t pendingMask = 0; ///< Fields with a deferred value
+
+    /**
+     * @brief Appends text to the response while rendering.
+     */
+    void append(const char* text);
+
+    /**
+     * @brief Writes a value into its slot.
+     */
+    void patch(MetricField field, double value);
+
+public:
+    /**
+     * @brief Renders the response with all values set to NaN.
+     */
+    MetricsPage();
+
+    /**
+     * @brief Updates one value.
+     *
+     * @param field The field to update.
+     * @param value The new value; values that do not fit the slot are shown as NaN.
+     */
+    void setValue(MetricField field, double value);
+
+    /**
+     * @brief Defers updates until `release()`.
+     */
+    void hold();
+
+    /**
+     * @brief Applies deferred updates and resumes immediate updates.
+     */
+    void release();
+
+    /**
+     * @brief Retrieves the complete HTTP response.
+     */
+    const char* getResponse() const;
+
+    /**
+     * @brief Retrieves the length of the complete HTTP response in bytes.
+     */
+    size_t getResponseLength() const;
+};
+
+#endif // METRICS_PAGE_H
\ No newline at end of file
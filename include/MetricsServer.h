@@ -0,0 +1,127 @@
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "HttpRequestScanner.h"
+#include "MetricsPage.h"
+
+/**
+ * @file MetricsServer.h
+ * @brief Non-blocking HTTP server for the Prometheus metrics page.
+ */
+
+/**
+ * @class MetricsSocket
+ * @brief Listening TCP socket that serves one connection at a time.
+ *
+ * Implemented by `WiFiMetricsSocket` on the device. A host implementation over POSIX
+ * sockets can be used to scrape `MetricsServer` on Linux.
+ */
+class MetricsSocket {
+public:
+    virtual ~MetricsSocket() {}
+
+    /**
+     * @brief Starts listening.
+     */
+    virtual void begin() = 0;
+
+    /**
+     * @brief Accepts a waiting connection without blocking.
+     *
+     * @return `true` if a connection was accepted, `false` if none is waiting.
+     */
+    virtual bool accept() = 0;
+
+    /**
+     * @brief Retrieves the number of received bytes that can be read.
+     */
+    virtual int available() = 0;
+
+    /**
+     * @brief Reads one received byte.
+     *
+     * @return The byte, or -1 if none is available.
+     */
+    virtual int read() = 0;
+
+    /**
+     * @brief Retrieves the number of bytes the send buffer accepts without blocking.
+     */
+    virtual size_t availableForWrite() = 0;
+
+    /**
+     * @brief Queues bytes for sending.
+     *
+     * @param data The bytes.
+     * @param length The number of bytes, at most `availableForWrite()`.
+     * @return The number of bytes queued.
+     */
+    virtual size_t write(const uint8_t* data, size_t length) = 0;
+
+    /**
+     * @brief Checks whether the peer is still connected or unread data remains.
+     */
+    virtual bool connected() = 0;
+
+    /**
+     * @brief Closes the connection; queued data is still sent.
+     */
+    virtual void close() = 0;
+};
+
+/**
+ * @class MetricsServer
+ * @brief Serves `MetricsPage` on `METRICS_PORT` without ever blocking `loop()`.
+ *
+ * One connection is handled at a time. Each call to `poll()` reads at most
+ * `METRICS_MAX_BYTES_PER_POLL` request bytes and writes at most as much of the response
+ * as the TCP send buffer accepts, straight from the page buffer. Connections that do not
+ * complete within `METRICS_CLIENT_TIMEOUT_MS` are dropped.
+ */
+class MetricsServer {
+private:
+    MetricsSocket& socket; ///< Listening socket and the connection being served
+    MetricsPage& page; ///< Page served for `/metrics`
+    HttpRequestScanner scanner; ///< Scanner of the current request
+
+    bool active = false; ///< Whether a connection is being served
+    bool holding = false; ///< Whether the page is held for the current response
+    const char* response = nullptr; ///< Response being sent, or `nullptr` while reading
+    size_t responseLength = 0; ///< Length of `response` in bytes
+    size_t sent = 0; ///< Bytes of `response` sent so far
+    unsigned long clientStart = 0; ///< Time the connection was accepted in ms
+    uint32_t scrapes = 0; ///< Metrics responses started since boot
+
+    /**
+     * @brief Closes the connection and releases the page.
+     */
+    void finish();
+
+public:
+    /**
+     * @brief Constructs the server.
+     *
+     * @param socket The socket to serve on.
+     * @param page The page served for `/metrics`.
+     */
+    MetricsServer(MetricsSocket& socket, MetricsPage& page);
+
+    /**
+     * @brief Starts listening.
+     */
+    void begin();
+
+    /**
+     * @brief Accepts, reads and answers requests incrementally.
+     *
+     * Call once per `loop()` iteration.
+     *
+     * @param now The current time in ms.
+     */
+    void poll(unsigned long now);
+};
+
+#endif // METRICS_SERVER_H
\ No newline at end of file
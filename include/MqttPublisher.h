@@ -0,0 +1,181 @@
+#ifndef MQTT_PUBLISHER_H
+#define MQTT_PUBLISHER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "HistoryCodec.h"
+
+/**
+ * @file MqttPublisher.h
+ * @brief Publishes batches of readings to an MQTT broker with offline queueing.
+ */
+
+/**
+ * @class MqttTransport
+ * @brief Connection to an MQTT broker.
+ *
+ * Implemented by `PubSubMqttTransport` on the device. A host-side fake or a client for a
+ * local broker can be used to exercise `MqttPublisher` on Linux.
+ */
+class MqttTransport {
+public:
+    virtual ~MqttTransport() {}
+
+    /**
+     * @brief Attempts to (re)connect to the broker.
+     *
+     * @return `true` if the transport is connected afterwards, `false` otherwise.
+     */
+    virtual bool connect() = 0;
+
+    /**
+     * @brief Checks whether the transport is connected.
+     */
+    virtual bool isConnected() = 0;
+
+    /**
+     * @brief Publishes one message.
+     *
+     * @param topic The topic.
+     * @param payload The message payload.
+     * @param length The payload length in bytes.
+     * @return `true` if the message was handed to the broker, `false` otherwise.
+     */
+    virtual bool publish(const char* topic, const char* payload, size_t length) = 0;
+
+    /**
+     * @brief Services the connection (keep-alive, incoming packets).
+     */
+    virtual void loop() = 0;
+};
+
+/**
+ * @struct MqttPublisherStats
+ * @brief Counters describing the publishing and queueing behaviour.
+ */
+struct MqttPublisherStats {
+    uint32_t published; ///< Messages handed to the broker
+    uint32_t failures; ///< Publish attempts that failed
+    uint32_t dropped; ///< Queued messages discarded because the queue was full
+    uint32_t rejected; ///< Samples discarded because their row did not fit the row buffer
+    uint32_t reconnects; ///< Successful (re)connections
+    uint8_t queueDepth; ///< Complete messages waiting to be published
+    uint8_t maxQueueDepth; ///< Highest queue depth seen
+    float messagesPerSecond; ///< Publish rate over the last `MQTT_RATE_WINDOW_MS`
+};
+
+/**
+ * @class MqttPublisher
+ * @brief Batches readings into JSON messages and drains them to an `MqttTransport`.
+ *
+ * Samples are appended to the open batch as they arrive, so closing a batch costs no
+ * formatting. A batch is closed every `MQTT_BATCH_INTERVAL_MS` or when it is full:
+ *
+ *     {"device":"co2-meter","seq":7,"samples":[[uptime_ms,co2,temp_scd30,temp_bmp280,humidity,pressure],...]}
+ *
+ * Batches are built in place in a ring of `MQTT_QUEUE_SLOTS` fixed-size slots. While the
+ * broker is unreachable they accumulate there; when the ring is full the oldest message is
+ * dropped. On reconnect the queue is drained at no more than one message per `poll()` and
+ * per `MQTT_DRAIN_INTERVAL_MS`, so a long backlog never starves the sampling loop.
+ * Reconnection attempts back off exponentially from `MQTT_RECONNECT_MIN_MS` to
+ * `MQTT_RECONNECT_MAX_MS`.
+ */
+class MqttPublisher {
+private:
+    /**
+     * @struct Slot
+     * @brief One queued message.
+     */
+    struct Slot {
+        uint16_t length; ///< Payload length in bytes
+        char payload[MQTT_PAYLOAD_SIZE]; ///< JSON payload
+    };
+
+    MqttTransport& transport; ///< Connection to the broker
+    const char* topic; ///< Topic the batches are published to
+    const char* deviceId; ///< Device identifier written into each batch
+
+    Slot slots[MQTT_QUEUE_SLOTS]; ///< Message ring; the slot after the queued ones holds the open batch
+    uint8_t head = 0; ///< Slot of the oldest queued message
+    uint8_t queued = 0; ///< Number of complete messages in the ring
+    bool batchOpen = false; ///< Whether the slot after the queued ones holds an open batch
+    uint16_t batchSamples = 0; ///< Samples in the open batch
+    unsigned long batchStart = 0; ///< Time the open batch was started in ms
+    uint32_t sequence = 0; ///< Sequence number of the next batch
+
+    bool connected = false; ///< Connection state seen by the last `poll()`
+    unsigned long lastConnectAttempt = 0; ///< Time of the last connection attempt in ms
+    unsigned long reconnectDelay = MQTT_RECONNECT_MIN_MS; ///< Current backoff in ms
+    unsigned long lastPublish = 0; ///< Time of the last publish attempt in ms
+
+    unsigned long rateWindowStart = 0; ///< Start of the current rate window in ms
+    uint32_t rateWindowCount = 0; ///< Messages published in the current rate window
+    MqttPublisherStats stats = {}; ///< Counters
+
+    /**
+     * @brief Starts a new batch in the slot after the queued messages.
+     *
+     * Drops the oldest message if the ring is full.
+     *
+     * @param now The current time in ms.
+     */
+    void openBatch(unsigned long now);
+
+    /**
+     * @brief Terminates the open batch and appends it to the queue.
+     */
+    void closeBatch();
+
+    /**
+     * @brief Retrieves the slot holding the open batch.
+     */
+    Slot& batchSlot();
+
+    /**
+     * @brief Handles connection state changes and reconnection with backoff.
+     *
+     * @param now The current time in ms.
+     * @return `true` if the transport is connected, `false` otherwise.
+     */
+    bool maintainConnection(unsigned long now);
+
+public:
+    /**
+     * @brief Constructs the publisher.
+     *
+     * @param transport The connection to the broker.
+     * @param topic The topic to publish to.
+     * @param deviceId The device identifier written into each batch.
+     */
+    MqttPublisher(MqttTransport& transport, const char* topic = MQTT_TOPIC, const char* deviceId = MQTT_CLIENT_ID);
+
+    /**
+     * @brief Appends a sample to the open batch.
+     *
+     * @param sample The readings to publish.
+     * @param now The current time in ms.
+     */
+    void addSample(const HistorySample& sample, unsigned long now);
+
+    /**
+     * @brief Closes due batches, keeps the connection alive and publishes at most one message.
+     *
+     * Call once per `loop()` iteration.
+     *
+     * @param now The current time in ms.
+     */
+    void poll(unsigned long now);
+
+    /**
+     * @brief Retrieves the publishing statistics.
+     */
+    const MqttPublisherStats& getStatistics() const;
+
+    /**
+     * @brief Logs the publishing statistics.
+     */
+    void logStatistics() const;
+};
+
+#endif // MQTT_PUBLISHER_H
\ No newline at end of file
@@ -0,0 +1,163 @@
+#ifndef PAGE_MANAGER_H
+#define PAGE_MANAGER_H
+
+#include <stdint.h>
+#include "config.h"
+#include "DisplayManager.h"
+#include "DisplayPage.h"
+
+/**
+ * @file PageManager.h
+ * @brief Page selection, rotation and lazy rendering of the display pages.
+ */
+
+/**
+ * @struct PageManagerStats
+ * @brief Rendering statistics of the page manager.
+ */
+struct PageManagerStats {
+    uint32_t renders; ///< Number of rendered frames
+    uint32_t switches; ///< Number of page switches
+    uint32_t backgroundHits; ///< Renders that restored a cached background
+    uint32_t backgroundMisses; ///< Renders that drew the background
+    uint32_t lastRenderUs; ///< Duration of the last render including the transfer in us
+    uint32_t maxRenderUs; ///< Longest render in us
+};
+
+/**
+ * @class PageManager
+ * @brief Shows one of a set of pages and redraws it only when needed.
+ *
+ * Producers report changed values with `invalidate()`, which only records the changed
+ * `DisplayInput` groups. `update()` renders the visible page at most once per call, and
+ * only after a page switch, a change of one of its inputs or when its refresh interval
+ * elapses, so hidden pages cost nothing and an unchanged page is not transferred again.
+ *
+ * The static background of a page is kept as a bitmap in one of `DISPLAY_BACKGROUND_SLOTS`
+ * slots, evicted least recently used. A render restores the bitmap and draws only the
+ * values on top; a switch back to a recently shown page does not redraw its background.
+ *
+ * The first `rotationCount` pages are cycled every `DISPLAY_PAGE_INTERVAL_MS`. `next()`
+ * and `show()` hold the rotation, e.g. after a button press or for an alert. A page shown
+ * until `release()` stays pinned: other pages shown meanwhile return to it after their
+ * hold, and `next()` holds them only for `DISPLAY_PAGE_INTERVAL_MS`.
+ */
+class PageManager {
+private:
+    /**
+     * @struct BackgroundSlot
+     * @brief Cached background of one page.
+     */
+    struct BackgroundSlot {
+        int8_t page; ///< Page the bitmap belongs to, or -1 if unused
+        uint32_t lastUse; ///< Value of `useCounter` when the slot was last used
+        uint8_t pixels[DISPLAY_BUFFER_BYTES]; ///< The background bitmap
+    };
+
+    DisplayManager& displayManager; ///< Target of the rendering
+    DisplayPage* const* pages; ///< The pages
+    uint8_t pageCount; ///< Number of pages
+    uint8_t rotationCount; ///< Number of pages in the rotation
+
+    BackgroundSlot slots[DISPLAY_BACKGROUND_SLOTS]; ///< Background cache
+    uint32_t useCounter = 0; ///< Clock of the least recently used eviction
+    int currentSlot = -1; ///< Slot holding the background of the current page
+
+    uint8_t currentPage = 0; ///< Visible page
+    bool switched = true; ///< Whether the page changed since the last render
+    uint8_t pendingInputs = 0; ///< `DisplayInput` groups changed since the last render
+    bool rendered = false; ///< Whether `lastRenderTime` is valid
+    unsigned long lastRenderTime = 0; ///< Time of the last render in ms
+    unsigned long lastSwitchTime = 0; ///< Time of the last page switch in ms
+    unsigned long holdStart = 0; ///< Start of the rotation hold in ms
+    unsigned long holdDuration = 0; ///< Duration of the rotation hold in ms
+    bool held = false; ///< Whether the rotation is held
+    bool holdForever = false; ///< Whether the hold lasts until `release()`
+    int16_t pinnedPage = -1; ///< Page shown until `release()`, or -1
+
+    PageManagerStats stats = {}; ///< Rendering statistics
+
+    /**
+     * @brief Makes a page visible.
+     *
+     * @param page The page index.
+     * @param now The current time in ms.
+     */
+    void switchTo(uint8_t page, unsigned long now);
+
+    /**
+     * @brief Restores the cached background of the current page, drawing it on a miss.
+     */
+    void prepareBackground();
+
+    /**
+     * @brief Draws the current page and transfers it to the panel.
+     *
+     * @param now The current time in ms.
+     */
+    void render(unsigned long now);
+
+public:
+    /**
+     * @brief Constructs the page manager.
+     *
+     * @param displayManager The display the pages are drawn on.
+     * @param pages The pages; the array must outlive the page manager.
+     * @param pageCount Number of pages.
+     * @param rotationCount Number of leading pages cycled by the rotation and `next()`.
+     */
+    PageManager(DisplayManager& displayManager, DisplayPage* const* pages, uint8_t pageCount, uint8_t rotationCount);
+
+    /**
+     * @brief Shows the next page of the rotation and holds it for `DISPLAY_PAGE_HOLD_MS`.
+     *
+     * While a page is pinned, the next page is held for `DISPLAY_PAGE_INTERVAL_MS` only.
+     *
+     * @param now The current time in ms.
+     */
+    void next(unsigned long now);
+
+    /**
+     * @brief Shows a page and holds the rotation.
+     *
+     * @param page The page index.
+     * @param now The current time in ms.
+     * @param holdMs How long the rotation is held in ms, or 0 to pin the page until `release()`.
+     */
+    void show(uint8_t page, unsigned long now, unsigned long holdMs);
+
+    /**
+     * @brief Unpins the page, ends any hold and resumes the rotation from a page.
+     *
+     * @param page The page index.
+     * @param now The current time in ms.
+     */
+    void release(uint8_t page, unsigned long now);
+
+    /**
+     * @brief Records that values of the given input groups changed.
+     *
+     * @param inputs A combination of `DisplayInput` flags.
+     */
+    void invalidate(uint8_t inputs);
+
+    /**
+     * @brief Advances the rotation and renders the visible page if needed.
+     *
+     * @param now The current time in ms.
+     * @return `true` if a frame was rendered, `false` otherwise.
+     */
+    bool update(unsigned long now);
+
+    /**
+     * @brief Retrieves the index of the visible page.
+     */
+    uint8_t getCurrentPage() const;
+
+    /**
+     * @brief Retrieves the rendering statistics.
+     */
+    const PageManagerStats& getStatistics() const;
+};
+
+#endif // PAGE_MANAGER_H
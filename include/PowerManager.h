@@ -0,0 +1,200 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "ExposureAccumulator.h"
+#include "HistoryCodec.h"
+#include "PressureCompensator.h"
+#include "SensorFilter.h"
+
+/**
+ * @file PowerManager.h
+ * @brief Wake/sleep schedule and state retention of the low-power duty cycle.
+ */
+
+/**
+ * @class RtcStore
+ * @brief Memory that survives deep sleep but not a power cycle.
+ *
+ * Implemented by `EspRtcStore` for the ESP8266 RTC user memory. A host-side fake backed by
+ * a plain array can be used to exercise `PowerManager` on Linux.
+ */
+class RtcStore {
+public:
+    virtual ~RtcStore() {}
+
+    /**
+     * @brief Reads the retained record.
+     *
+     * @param data Receives the record; must be 4-byte aligned.
+     * @param size The record size in bytes, a multiple of 4.
+     * @return `true` if the read succeeded, `false` otherwise.
+     */
+    virtual bool read(void* data, size_t size) = 0;
+
+    /**
+     * @brief Writes the retained record.
+     *
+     * @param data The record; must be 4-byte aligned.
+     * @param size The record size in bytes, a multiple of 4.
+     * @return `true` if the write succeeded, `false` otherwise.
+     */
+    virtual bool write(const void* data, size_t size) = 0;
+};
+
+/**
+ * @brief Cause of the current boot.
+ */
+enum WakeReason {
+    WAKE_COLD_BOOT, ///< Power-on or any restart without valid retained state
+    WAKE_TIMER,     ///< Scheduled wake from deep sleep
+    WAKE_BUTTON     ///< Reset button pressed while sleeping
+};
+
+/**
+ * @struct RetainedState
+ * @brief Application state carried from one wake to the next.
+ */
+struct RetainedState {
+    HistorySample lastSample; ///< Last raw readings, timestamped in monotonic time
+    uint32_t samples; ///< Samples taken since the cold boot
+    uint32_t missedSamples; ///< Wakes on which the SCD30 had no data in time
+    uint8_t alertLevel; ///< `AlertLevel` of the last sample
+    uint8_t calibrated; ///< Whether the EEPROM calibration check has been done
+    uint8_t displayOn; ///< Whether the display was left switched on
+    uint8_t sensorsStarted; ///< Whether the sensors were started and the state below initialized
+    float moderateThreshold; ///< Moderate alert threshold in ppm
+    float criticalThreshold; ///< Critical alert threshold in ppm
+    SensorFilterState filter; ///< Kalman filter state
+    ExposureRunningState exposure; ///< Unsaved part of the exposure accumulation
+    PressureCompensatorState pressure; ///< Last compensation write and its statistics
+};
+
+/**
+ * @class PowerManager
+ * @brief Plans the deep-sleep schedule and keeps `RetainedState` in RTC memory.
+ *
+ * `millis()` restarts at zero on every wake, so the manager keeps a monotonic clock: each
+ * record stores the time at which the next boot starts, i.e. the time the device went to
+ * sleep plus the planned sleep. Samples are due every `LOW_POWER_SAMPLE_INTERVAL_MS` on
+ * that clock, keeping their phase even when the display requests an extra wake in between.
+ *
+ * The record is protected by a magic number and a checksum; anything else found in RTC
+ * memory (power-on garbage, another firmware) yields a cold boot.
+ */
+class PowerManager {
+private:
+    /**
+     * @struct Record
+     * @brief Layout of the RTC memory.
+     */
+    struct Record {
+        uint32_t magic; ///< Marks a record of this layout
+        uint32_t wakeCount; ///< Wakes since the cold boot
+        uint32_t clockMs; ///< Monotonic time at which the current boot started in ms
+        uint32_t nextSampleMs; ///< Monotonic time the next sample is due in ms
+        uint32_t displayUntilMs; ///< Monotonic time until which the display stays on in ms
+        RetainedState state; ///< Application state
+        uint32_t checksum; ///< Checksum over all preceding fields
+    };
+
+    RtcStore& store; ///< Backing memory
+    Record record; ///< Working copy of the record
+    WakeReason wakeReason = WAKE_COLD_BOOT; ///< Cause of the current boot
+
+    /**
+     * @brief Computes the checksum of the record.
+     *
+     * @return The checksum over all fields except `checksum` itself.
+     */
+    uint32_t computeChecksum() const;
+
+public:
+    /**
+     * @brief Constructs the manager.
+     *
+     * @param store The memory holding the record.
+     */
+    explicit PowerManager(RtcStore& store);
+
+    /**
+     * @brief Restores the record from RTC memory.
+     *
+     * @param reason The cause of the boot reported by the hardware.
+     * @return `true` if the state was restored, `false` if this is treated as a cold boot.
+     */
+    bool begin(WakeReason reason);
+
+    /**
+     * @brief Retrieves the cause of the current boot after `begin()`.
+     */
+    WakeReason getWakeReason() const;
+
+    /**
+     * @brief Retrieves the number of wakes since the cold boot.
+     */
+    uint32_t getWakeCount() const;
+
+    /**
+     * @brief Accesses the application state.
+     */
+    RetainedState& getState();
+
+    /**
+     * @brief Converts a `millis()` value of the current boot to monotonic time.
+     *
+     * @param millisNow Milliseconds since the current boot.
+     * @return The monotonic time in ms.
+     */
+    uint32_t getTimeMs(uint32_t millisNow) const;
+
+    /**
+     * @brief Checks whether a sample should be taken on this wake.
+     *
+     * @param millisNow Milliseconds since the current boot.
+     */
+    bool isSampleDue(uint32_t millisNow) const;
+
+    /**
+     * @brief Schedules the next sample after one has been taken.
+     *
+     * @param millisNow Milliseconds since the current boot.
+     */
+    void sampleTaken(uint32_t millisNow);
+
+    /**
+     * @brief Keeps the display on for a while.
+     *
+     * @param millisNow Milliseconds since the current boot.
+     * @param durationMs How long the display stays on in ms.
+     */
+    void holdDisplay(uint32_t millisNow, uint32_t durationMs);
+
+    /**
+     * @brief Checks whether the display is still held on.
+     *
+     * @param millisNow Milliseconds since the current boot.
+     */
+    bool isDisplayHeld(uint32_t millisNow) const;
+
+    /**
+     * @brief Computes how long to sleep until the next sample or display timeout.
+     *
+     * @param millisNow Milliseconds since the current boot.
+     * @return The sleep duration in ms.
+     */
+    uint32_t planSleep(uint32_t millisNow) const;
+
+    /**
+     * @brief Writes the record before going to sleep.
+     *
+     * @param millisNow Milliseconds since the current boot.
+     * @param sleepMs The sleep duration that follows in ms.
+     * @return `true` if the write succeeded, `false` otherwise.
+     */
+    bool save(uint32_t millisNow, uint32_t sleepMs);
+};
+
+#endif // POWER_MANAGER_H
@@ -0,0 +1,124 @@
+#ifndef PRESSURE_COMPENSATOR_H
+#define PRESSURE_COMPENSATOR_H
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @file PressureCompensator.h
+ * @brief Forwards the BMP280 pressure to the SCD30 ambient pressure compensation.
+ */
+
+/**
+ * @class AmbientPressureSink
+ * @brief Receiver of ambient pressure compensation commands.
+ *
+ * Implemented by `SensorManager` for the real SCD30. A host-side fake can record the
+ * commands it receives instead.
+ */
+class AmbientPressureSink {
+public:
+    virtual ~AmbientPressureSink() {}
+
+    /**
+     * @brief Sets the ambient pressure used for CO2 compensation.
+     *
+     * @param pressureMbar The ambient pressure in mbar (equal to hPa).
+     * @return `true` if the command was accepted, `false` otherwise.
+     */
+    virtual bool setAmbientPressure(uint16_t pressureMbar) = 0;
+};
+
+/**
+ * @struct PressureCompensationStats
+ * @brief Counters describing how often compensation writes were issued or avoided.
+ */
+struct PressureCompensationStats {
+    uint32_t writes; ///< Successful compensation writes
+    uint32_t failures; ///< Writes rejected by the sensor
+    uint32_t skippedDeadband; ///< Updates within the deadband of the last written value
+    uint32_t skippedRateLimit; ///< Updates outside the deadband that arrived too early
+    uint32_t rejected; ///< Updates outside the range accepted by the SCD30
+};
+
+/**
+ * @struct PressureCompensatorState
+ * @brief Snapshot of the compensator state, e.g. for retention across deep sleep.
+ */
+struct PressureCompensatorState {
+    uint8_t hasWritten; ///< Whether a value has been written
+    uint8_t reserved; ///< Padding
+    uint16_t lastWrittenMbar; ///< Last value written to the sensor in mbar
+    uint32_t lastWriteTime; ///< Timestamp of the last write in ms
+    PressureCompensationStats stats; ///< Write statistics
+};
+
+/**
+ * @class PressureCompensator
+ * @brief Pushes pressure changes to the SCD30 with a deadband and a rate limit.
+ *
+ * Every compensation command restarts the SCD30 measurement and is stored in its
+ * non-volatile memory. A new value is therefore only written once the pressure has moved
+ * `PRESSURE_COMP_DEADBAND_HPA` away from the last written value, and never more often than
+ * every `PRESSURE_COMP_MIN_INTERVAL_MS`.
+ */
+class PressureCompensator {
+private:
+    AmbientPressureSink& sink; ///< Receiver of the compensation commands
+    float deadband; ///< Pressure change that triggers a write in hPa
+    unsigned long minInterval; ///< Minimum time between writes in ms
+
+    bool hasWritten = false; ///< Whether a value has been written since startup
+    uint16_t lastWrittenMbar = 0; ///< Last value written to the sensor in mbar
+    unsigned long lastWriteTime = 0; ///< Timestamp of the last write in ms
+    PressureCompensationStats stats = {}; ///< Write statistics
+
+public:
+    /**
+     * @brief Constructs the compensator.
+     *
+     * @param sink The receiver of the compensation commands.
+     * @param deadband Pressure change that triggers a write in hPa.
+     * @param minInterval Minimum time between writes in ms.
+     */
+    PressureCompensator(AmbientPressureSink& sink,
+                        float deadband = PRESSURE_COMP_DEADBAND_HPA,
+                        unsigned long minInterval = PRESSURE_COMP_MIN_INTERVAL_MS);
+
+    /**
+     * @brief Processes a new pressure reading and writes it to the sensor if needed.
+     *
+     * @param pressureHpa The ambient pressure in hPa.
+     * @param timestampMs The reading timestamp in ms (e.g. from `millis()`).
+     * @return `true` if a compensation value was written, `false` otherwise.
+     */
+    bool update(float pressureHpa, unsigned long timestampMs);
+
+    /**
+     * @brief Retrieves the write statistics.
+     *
+     * @return The counters since startup.
+     */
+    const PressureCompensationStats& getStatistics() const;
+
+    /**
+     * @brief Captures the compensator state.
+     *
+     * @param state Receives the snapshot.
+     */
+    void getState(PressureCompensatorState& state) const;
+
+    /**
+     * @brief Continues from a previously captured state.
+     *
+     * @param state The snapshot.
+     */
+    void setState(const PressureCompensatorState& state);
+
+    /**
+     * @brief Logs the write statistics.
+     */
+    void logStatistics() const;
+};
+
+#endif // PRESSURE_COMPENSATOR_H
\ No newline at end of file
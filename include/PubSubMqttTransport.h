@@ -0,0 +1,71 @@
+#ifndef PUBSUB_MQTT_TRANSPORT_H
+#define PUBSUB_MQTT_TRANSPORT_H
+
+#include <ESP8266WiFi.h>
+#include <PubSubClient.h>
+#include "config.h"
+#include "MqttPublisher.h"
+
+/**
+ * @file PubSubMqttTransport.h
+ * @brief MQTT transport over WiFi using the PubSubClient library.
+ */
+
+/**
+ * @class PubSubMqttTransport
+ * @brief Connects to `WIFI_SSID` and the broker at `MQTT_HOST`:`MQTT_PORT`.
+ *
+ * WiFi is started by `setup()` and associates in the background, so attempts before the
+ * association fail immediately. Only the TCP connect and the wait for the broker's
+ * CONNACK block, each for at most `MQTT_CONNECT_TIMEOUT_MS` (PubSubClient would otherwise
+ * wait 15 s for a broker that accepts the socket but does not answer). Publishing is
+ * disabled while `WIFI_SSID` is empty.
+ */
+class PubSubMqttTransport : public MqttTransport {
+private:
+    WiFiClient wifiClient; ///< TCP connection to the broker
+    PubSubClient client; ///< MQTT protocol client
+    const char* host; ///< Broker host name or address
+    uint16_t port; ///< Broker port
+    const char* clientId; ///< MQTT client identifier
+    bool configured = false; ///< Whether the client was set up for the broker
+
+public:
+    /**
+     * @brief Constructs the transport.
+     *
+     * @param host The broker host name or address.
+     * @param port The broker port.
+     * @param clientId The MQTT client identifier.
+     */
+    PubSubMqttTransport(const char* host = MQTT_HOST, uint16_t port = MQTT_PORT, const char* clientId = MQTT_CLIENT_ID);
+
+    /**
+     * @brief Connects to the broker once WiFi is associated.
+     *
+     * @return `true` if connected to the broker, `false` otherwise.
+     */
+    bool connect() override;
+
+    /**
+     * @brief Checks whether the broker connection is up.
+     */
+    bool isConnected() override;
+
+    /**
+     * @brief Publishes one message.
+     *
+     * @param topic The topic.
+     * @param payload The message payload.
+     * @param length The payload length in bytes.
+     * @return `true` if the message was sent, `false` otherwise.
+     */
+    bool publish(const char* topic, const char* payload, size_t length) override;
+
+    /**
+     * @brief Services keep-alive and incoming packets.
+     */
+    void loop() override;
+};
+
+#endif // PUBSUB_MQTT_TRANSPORT_H
\ No newline at end of file
@@ -0,0 +1,123 @@
+#ifndef SENSOR_FILTER_H
+#define SENSOR_FILTER_H
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @file SensorFilter.h
+ * @brief Smooths CO2 readings and fuses the SCD30 and BMP280 temperatures.
+ */
+
+/**
+ * @brief Signed Q16.16 fixed-point number.
+ */
+typedef int32_t fixed_t;
+
+/**
+ * @struct SensorFilterState
+ * @brief Snapshot of the filter state, e.g. for retention across deep sleep.
+ */
+struct SensorFilterState {
+    uint32_t initialized; ///< Whether the snapshot holds a valid estimate
+    fixed_t co2; ///< Filtered CO2 in ppm
+    fixed_t co2Variance; ///< Variance of the CO2 estimate in ppm^2
+    fixed_t temperature; ///< Fused temperature in °C
+    fixed_t temperatureVariance; ///< Variance of the temperature estimate in °C^2
+    fixed_t selfHeatingBias; ///< SCD30 temperature offset against the BMP280 in °C
+};
+
+/**
+ * @class SensorFilter
+ * @brief Fixed-point Kalman filter stage between `SensorManager` and its consumers.
+ *
+ * The ESP8266 has no floating-point unit, so every float operation is emulated in software.
+ * The filter converts each reading to Q16.16 once and runs all arithmetic on integers.
+ *
+ * - CO2 is smoothed by a scalar random-walk Kalman filter. The measurement noise grows with
+ *   the concentration (`FILTER_CO2_NOISE_PPM` + `FILTER_CO2_NOISE_RELATIVE` * CO2). Large
+ *   innovations reopen the covariance, so real steps (a window opening) are not lagged.
+ * - The SCD30 warms itself and reads high. Its offset against the BMP280 is tracked as a slowly
+ *   adapting bias. Both temperatures are then fused by a Kalman update per source.
+ */
+class SensorFilter {
+private:
+    bool initialized = false; ///< Whether the first sample has been seen
+
+    fixed_t co2 = 0; ///< Filtered CO2 in ppm
+    fixed_t co2Variance = 0; ///< Variance of the CO2 estimate in ppm^2
+
+    fixed_t temperature = 0; ///< Fused temperature in °C
+    fixed_t temperatureVariance = 0; ///< Variance of the temperature estimate in °C^2
+    fixed_t selfHeatingBias = 0; ///< SCD30 temperature offset against the BMP280 in °C
+
+    /**
+     * @brief Applies one Kalman measurement update to a scalar state.
+     *
+     * @param state The state estimate, updated in place.
+     * @param variance The state variance, updated in place.
+     * @param measurement The measurement.
+     * @param noiseVariance The measurement noise variance.
+     */
+    static void kalmanUpdate(fixed_t& state, fixed_t& variance, fixed_t measurement, fixed_t noiseVariance);
+
+public:
+    /**
+     * @brief Feeds one set of raw readings into the filters.
+     *
+     * @param rawCO2 The CO2 concentration from the SCD30 in ppm.
+     * @param temperatureSCD The temperature from the SCD30 in °C.
+     * @param temperatureBMP The temperature from the BMP280 in °C.
+     */
+    void update(float rawCO2, float temperatureSCD, float temperatureBMP);
+
+    /**
+     * @brief Discards the filter state; the next sample reinitializes it.
+     */
+    void reset();
+
+    /**
+     * @brief Captures the filter state.
+     *
+     * @param state Receives the snapshot.
+     */
+    void getState(SensorFilterState& state) const;
+
+    /**
+     * @brief Continues from a previously captured state.
+     *
+     * @param state The snapshot.
+     */
+    void setState(const SensorFilterState& state);
+
+    /**
+     * @brief Retrieves the filtered CO2 concentration.
+     *
+     * @return The CO2 concentration in ppm.
+     */
+    float getCO2() const;
+
+    /**
+     * @brief Retrieves the fused temperature.
+     *
+     * @return The temperature in °C.
+     */
+    float getTemperature() const;
+
+    /**
+     * @brief Retrieves the estimated SCD30 self-heating bias.
+     *
+     * @return The offset of the SCD30 temperature against the BMP280 in °C.
+     */
+    float getSelfHeatingBias() const;
+
+    /**
+     * @brief Converts an SCD30 temperature reading by removing the self-heating bias.
+     *
+     * @param temperatureSCD The temperature from the SCD30 in °C.
+     * @return The compensated temperature in °C.
+     */
+    float compensateTemperatureSCD(float temperatureSCD) const;
+};
+
+#endif // SENSOR_FILTER_H
\ No newline at end of file
@@ -0,0 +1,239 @@
+#ifndef SENSOR_GROUP_H
+#define SENSOR_GROUP_H
+
+#include <stdint.h>
+#include "config.h"
+#include "AlertMonitor.h"
+#include "HistoryCodec.h"
+#include "SensorFilter.h"
+
+/**
+ * @file SensorGroup.h
+ * @brief Several SCD30/BMP280 sets behind an I2C multiplexer, one per room.
+ */
+
+/**
+ * @class MuxBus
+ * @brief Connects the controller to one downstream channel of an I2C multiplexer.
+ */
+class MuxBus {
+public:
+    virtual ~MuxBus() {}
+
+    /**
+     * @brief Routes the I2C bus to one channel.
+     *
+     * @param channel The channel (0 to 7 on a TCA9548A).
+     * @return `true` if the multiplexer acknowledged, `false` otherwise.
+     */
+    virtual bool selectChannel(uint8_t channel) = 0;
+};
+
+/**
+ * @class RoomSensor
+ * @brief The sensors of one room, reached once the multiplexer selected their channel.
+ */
+class RoomSensor {
+public:
+    virtual ~RoomSensor() {}
+
+    /**
+     * @brief Initializes the sensors.
+     *
+     * @param startMeasurement Whether to (re)start the continuous measurement.
+     * @return `true` if all sensors answered, `false` otherwise.
+     */
+    virtual bool initializeSensors(bool startMeasurement) = 0;
+
+    /**
+     * @brief Sets the measurement interval of the CO2 sensor.
+     *
+     * @param seconds The interval in s.
+     * @return `true` if the command was accepted, `false` otherwise.
+     */
+    virtual bool setMeasurementInterval(uint16_t seconds) = 0;
+
+    /**
+     * @brief Checks if a new measurement is ready.
+     */
+    virtual bool isDataAvailable() = 0;
+
+    /**
+     * @brief Reads the measurement.
+     *
+     * @param values Receives the readings indexed by `HistoryChannel`.
+     */
+    virtual void readSample(float values[HISTORY_CHANNEL_COUNT]) = 0;
+};
+
+/**
+ * @struct SensorRoom
+ * @brief State of one room.
+ */
+struct SensorRoom {
+    RoomSensor* sensor; ///< The sensors of the room
+    uint8_t channel; ///< Multiplexer channel of the sensors
+    bool online; ///< Whether the sensors initialized and keep delivering samples
+    SensorFilter filter; ///< CO2 smoothing and temperature fusion of the room
+    AlertMonitor alertMonitor; ///< Alert thresholds and level of the room
+    HistorySample lastSample; ///< Raw readings of the last sample
+    float co2; ///< Filtered CO2 in ppm
+    unsigned long nextReadyMs; ///< Expected time of the next measurement, or of the next restart attempt while offline, in ms
+    unsigned long lastSampleMs; ///< Time of the last sample, or of coming online, in ms
+    uint32_t samples; ///< Samples read
+    uint32_t notReady; ///< Checks that found no new measurement
+};
+
+/**
+ * @struct SensorGroupStats
+ * @brief Bus traffic of the sensor group.
+ */
+struct SensorGroupStats {
+    uint32_t passes; ///< Calls to `poll()` that checked at least one room
+    uint32_t channelSwitches; ///< Writes to the multiplexer
+    uint32_t dataChecks; ///< `isDataAvailable()` calls
+    uint32_t samples; ///< Samples read from all rooms
+    uint32_t restarts; ///< Attempts to initialize an offline room again
+};
+
+/**
+ * @class SensorGroup
+ * @brief Polls the sensors of several rooms through one multiplexer with as little bus traffic as possible.
+ *
+ * The SCD30 delivers a measurement every interval, so the group predicts when each room
+ * has data and only visits rooms that are due. One `poll()` pass visits the due rooms in
+ * the order of their expected data-ready time, starting with the room on the channel that
+ * is still selected; the multiplexer is only written when the channel actually changes.
+ * A room that is not ready yet is checked again after `SENSOR_GROUP_RETRY_MS`. After a
+ * read, the next check is planned one retry period before the next expected measurement,
+ * so the prediction follows the clock drift of each sensor and a measurement is read at
+ * most about one retry period after it became available.
+ *
+ * A room that delivers no sample for `SENSOR_GROUP_OFFLINE_MS` is taken offline, as is a
+ * room whose sensors failed to initialize. `poll()` initializes at most one offline room
+ * per call again, each no more often than every `SENSOR_GROUP_RESTART_MS`, so a sensor that
+ * was missing at boot or dropped off the multiplexer comes back without a reboot.
+ *
+ * Every room has its own filter and alert monitor. The class does no I/O of its own, so it
+ * runs on the host against simulated sensors (`tools/sensor-group-sim`).
+ */
+class SensorGroup {
+private:
+    MuxBus& mux; ///< The multiplexer
+    unsigned long measurementIntervalMs; ///< Measurement interval of the sensors in ms
+    SensorRoom rooms[SENSOR_GROUP_MAX_ROOMS] = {}; ///< The rooms
+    uint8_t roomCount = 0; ///< Number of rooms
+    int currentChannel = -1; ///< Selected channel, or -1 if unknown
+    uint8_t alertChanges = 0; ///< Rooms whose alert level changed in the last `poll()`
+    uint8_t onlineChanges = 0; ///< Rooms that went offline or came back in the last `poll()`
+    SensorGroupStats stats = {}; ///< Bus traffic
+
+    /**
+     * @brief Selects a channel unless it is already selected.
+     *
+     * @param channel The channel.
+     * @return `true` if the channel is selected, `false` if the multiplexer did not answer.
+     */
+    bool selectChannel(uint8_t channel);
+
+    /**
+     * @brief Reads and processes the measurement of a room whose channel is selected.
+     *
+     * @param room The room.
+     * @param now The current time in ms.
+     */
+    void readRoom(SensorRoom& room, unsigned long now);
+
+    /**
+     * @brief Initializes the sensors of a room and sets their measurement interval.
+     *
+     * @param room The room.
+     * @param now The current time in ms.
+     * @return `true` if the room is online, `false` if it waits for the next attempt.
+     */
+    bool startRoom(SensorRoom& room, unsigned long now);
+
+public:
+    /**
+     * @brief Constructs an empty group.
+     *
+     * @param mux The multiplexer.
+     * @param measurementIntervalMs The measurement interval set on every sensor in ms.
+     */
+    SensorGroup(MuxBus& mux, unsigned long measurementIntervalMs);
+
+    /**
+     * @brief Adds a room.
+     *
+     * @param sensor The sensors of the room; they must outlive the group.
+     * @param channel The multiplexer channel of the sensors.
+     * @return `true` if the room was added, `false` if the group is full.
+     */
+    bool addRoom(RoomSensor& sensor, uint8_t channel);
+
+    /**
+     * @brief Initializes the sensors of all rooms and sets their measurement interval.
+     *
+     * @param now The current time in ms.
+     * @return The number of rooms that are online.
+     */
+    uint8_t begin(unsigned long now);
+
+    /**
+     * @brief Reads every room whose measurement is due.
+     *
+     * @param now The current time in ms.
+     * @return A bit mask of the rooms that delivered a new sample.
+     */
+    uint8_t poll(unsigned long now);
+
+    /**
+     * @brief Selects the channel of a room, e.g. to calibrate its sensors.
+     *
+     * @param index The room index.
+     * @return `true` if the channel is selected, `false` otherwise.
+     */
+    bool selectRoom(uint8_t index);
+
+    /**
+     * @brief Sets the alert thresholds of every room.
+     *
+     * @param moderate The moderate threshold in ppm.
+     * @param critical The critical threshold in ppm.
+     * @return `true` if the thresholds were accepted, `false` if they are not ordered or not positive.
+     */
+    bool setThresholds(float moderate, float critical);
+
+    /**
+     * @brief Retrieves the rooms whose alert level changed in the last `poll()`.
+     *
+     * @return A bit mask of room indices.
+     */
+    uint8_t getAlertChanges() const;
+
+    /**
+     * @brief Retrieves the rooms that went offline or came back online in the last `poll()`.
+     *
+     * @return A bit mask of room indices.
+     */
+    uint8_t getOnlineChanges() const;
+
+    /**
+     * @brief Retrieves the number of rooms.
+     */
+    uint8_t getRoomCount() const;
+
+    /**
+     * @brief Retrieves the state of a room.
+     *
+     * @param index The room index.
+     */
+    const SensorRoom& getRoom(uint8_t index) const;
+
+    /**
+     * @brief Retrieves the bus traffic statistics.
+     */
+    const SensorGroupStats& getStatistics() const;
+};
+
+#endif // SENSOR_GROUP_H
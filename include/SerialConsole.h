@@ -0,0 +1,180 @@
+#ifndef SERIAL_CONSOLE_H
+#define SERIAL_CONSOLE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "AlertMonitor.h"
+#include "DisplayManager.h"
+#include "ExposureAccumulator.h"
+#include "HistoryArchive.h"
+#include "MeasurementPipeline.h"
+#include "MqttPublisher.h"
+#include "PageManager.h"
+#include "PressureCompensator.h"
+#include "SensorGroup.h"
+#include "SensorManager.h"
+#include "TraceRecorder.h"
+#include "VentilationEstimator.h"
+
+/**
+ * @file SerialConsole.h
+ * @brief Line-oriented command console for runtime tuning over the serial port.
+ */
+
+/**
+ * @class SerialConsole
+ * @brief Reads commands from a stream without blocking and dispatches them.
+ *
+ * Input is collected in a fixed buffer, tokenized in place and dispatched through a
+ * constant command table, so the console never allocates. Each call to `poll()` consumes
+ * at most `CONSOLE_MAX_BYTES_PER_POLL` bytes, executes at most one command and emits at
+ * most one line of a running dump, which bounds its cost per `loop()` iteration.
+ *
+ * Supported commands: `help`, `loglevel`, `threshold`, `interval`, `calibrate`, `resetcal`,
+ * `stats`, `trace start|stop`, `dump history`, `dump compressed` and `dump trace`.
+ *
+ * In multi-room builds `setRooms()` routes the sensor commands to the rooms: `calibrate`
+ * takes a room number, `threshold` applies to every room and `stats` reports per room.
+ */
+class SerialConsole {
+private:
+    /**
+     * @struct Command
+     * @brief Entry of the command table.
+     */
+    struct Command {
+        const char* name; ///< Command word
+        void (SerialConsole::*handler)(int argc, char* argv[]); ///< Handler; argv[0] is the command word
+        const char* usage; ///< Usage shown by `help`
+    };
+
+    Stream& stream; ///< Stream commands are read from and answered on
+    SensorManager& sensorManager; ///< Target of the calibration commands
+    DisplayManager& displayManager; ///< Target of the blink interval command
+    AlertMonitor& alertMonitor; ///< Target of the threshold command
+    ExposureAccumulator& exposureAccumulator; ///< Source of the history dump
+    PressureCompensator& pressureCompensator; ///< Source of statistics
+    VentilationEstimator& ventilationEstimator; ///< Source of statistics
+    HistoryArchive& historyArchive; ///< Source of the compressed history dump
+    MqttPublisher& mqttPublisher; ///< Source of statistics
+    TraceRecorder& traceRecorder; ///< Target of the trace command and source of the trace dump
+    MeasurementPipeline& measurementPipeline; ///< Source of the stage timing
+    PageManager& pageManager; ///< Source of the render statistics
+    SensorGroup* sensorGroup = nullptr; ///< Rooms of a multi-room build, or `nullptr`
+    SensorManager* roomSensors = nullptr; ///< Sensors of each room, indexed like the rooms
+
+    char line[CONSOLE_BUFFER_SIZE]; ///< Current input line
+    size_t length = 0; ///< Number of characters in `line`
+    bool overflow = false; ///< Whether the current line exceeded the buffer
+    int dumpIndex = -1; ///< Next history entry to dump, or -1 when no dump is running
+    int blockDumpIndex = -1; ///< Next compressed history block to dump, or -1 when no dump is running
+    int traceDumpIndex = -1; ///< Next trace block to dump, or -1 when no dump is running
+
+    /**
+     * @brief Tokenizes the current line in place and runs the matching command.
+     */
+    void execute();
+
+    /**
+     * @brief Prints a formatted response line.
+     *
+     * @param format The printf-style format string.
+     */
+    void respond(const char* format, ...);
+
+    /**
+     * @brief Prints one encoded block as a base64 line.
+     *
+     * @param prefix The line prefix, e.g. `HIST:`.
+     * @param data The block.
+     * @param size The size of the block in bytes.
+     */
+    void printBlock(const char* prefix, const uint8_t* data, size_t size);
+
+    /**
+     * @brief Prints one exposure rollup, independent of the log level.
+     *
+     * @param index An hour (0 to `EXPOSURE_HOUR_COUNT` - 1) or day index, newest first.
+     */
+    void printExposureEntry(uint8_t index);
+
+    /**
+     * @brief Prints one line per room and the bus traffic of a multi-room build.
+     */
+    void printRoomStats();
+
+    void cmdHelp(int argc, char* argv[]); ///< Lists the commands
+    void cmdLogLevel(int argc, char* argv[]); ///< Shows or sets the log level
+    void cmdThreshold(int argc, char* argv[]); ///< Shows or sets an alert threshold
+    void cmdInterval(int argc, char* argv[]); ///< Shows or sets the blink interval
+    void cmdCalibrate(int argc, char* argv[]); ///< Forces an SCD30 recalibration of the sensor or a room
+    void cmdResetCalibration(int argc, char* argv[]); ///< Clears the calibration flag
+    void cmdStats(int argc, char* argv[]); ///< Prints runtime statistics
+    void cmdTrace(int argc, char* argv[]); ///< Starts or stops the trace recording
+    void cmdDump(int argc, char* argv[]); ///< Starts a history, compressed history or trace dump
+
+    /**
+     * @brief The command table.
+     */
+    static constexpr Command commands[] = {
+        { "help", &SerialConsole::cmdHelp, "help" },
+        { "loglevel", &SerialConsole::cmdLogLevel, "loglevel [0-4]" },
+        { "threshold", &SerialConsole::cmdThreshold, "threshold [moderate|critical <ppm>]" },
+        { "interval", &SerialConsole::cmdInterval, "interval [<ms>]" },
+        { "calibrate", &SerialConsole::cmdCalibrate, "calibrate [<room>]" },
+        { "resetcal", &SerialConsole::cmdResetCalibration, "resetcal" },
+        { "stats", &SerialConsole::cmdStats, "stats" },
+        { "trace", &SerialConsole::cmdTrace, "trace [start|stop]" },
+        { "dump", &SerialConsole::cmdDump, "dump history|compressed|trace" },
+    };
+
+public:
+    /**
+     * @brief Constructs the console.
+     *
+     * @param stream The stream to read commands from and answer on (usually `Serial`).
+     * @param sensorManager The sensor manager for calibration commands.
+     * @param displayManager The display manager for the blink interval.
+     * @param alertMonitor The alert monitor for the thresholds.
+     * @param exposureAccumulator The exposure accumulator for the history dump.
+     * @param pressureCompensator The pressure compensator for statistics.
+     * @param ventilationEstimator The ventilation estimator for statistics.
+     * @param historyArchive The compressed history for the compressed dump.
+     * @param mqttPublisher The MQTT publisher for statistics.
+     * @param traceRecorder The trace recorder for the trace commands.
+     * @param measurementPipeline The pipeline for the stage timing.
+     * @param pageManager The page manager for the render statistics.
+     */
+    SerialConsole(Stream& stream, SensorManager& sensorManager, DisplayManager& displayManager,
+                  AlertMonitor& alertMonitor, ExposureAccumulator& exposureAccumulator,
+                  PressureCompensator& pressureCompensator, VentilationEstimator& ventilationEstimator,
+                  HistoryArchive& historyArchive, MqttPublisher& mqttPublisher,
+                  TraceRecorder& traceRecorder, MeasurementPipeline& measurementPipeline,
+                  PageManager& pageManager);
+
+    /**
+     * @brief Routes the sensor commands to the rooms of a multi-room build.
+     *
+     * @param sensorGroup The rooms.
+     * @param roomSensors The sensors of each room, indexed like the rooms; the array must
+     *                    outlive the console.
+     */
+    void setRooms(SensorGroup& sensorGroup, SensorManager* roomSensors);
+
+    /**
+     * @brief Processes pending input without blocking.
+     *
+     * Call once per `loop()` iteration.
+     */
+    void poll();
+
+    /**
+     * @brief Feeds one character into the line parser.
+     *
+     * @param c The received character.
+     * @return `true` if the character completed a command line, `false` otherwise.
+     */
+    bool feed(char c);
+};
+
+#endif // SERIAL_CONSOLE_H
\ No newline at end of file
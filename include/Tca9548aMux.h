@@ -0,0 +1,43 @@
+#ifndef TCA9548A_MUX_H
+#define TCA9548A_MUX_H
+
+#include <Wire.h>
+#include "config.h"
+#include "SensorGroup.h"
+
+/**
+ * @file Tca9548aMux.h
+ * @brief TCA9548A 8-channel I2C multiplexer.
+ */
+
+/**
+ * @class Tca9548aMux
+ * @brief Selects one downstream channel of a TCA9548A by writing its control register.
+ *
+ * Devices on the upstream bus, such as the display, stay reachable whatever channel is
+ * selected.
+ */
+class Tca9548aMux : public MuxBus {
+private:
+    TwoWire& wire; ///< Upstream bus
+    uint8_t address; ///< I2C address of the multiplexer
+
+public:
+    /**
+     * @brief Constructs the multiplexer.
+     *
+     * @param wire The upstream bus.
+     * @param address The I2C address (0x70 to 0x77).
+     */
+    Tca9548aMux(TwoWire& wire, uint8_t address = TCA9548A_ADDRESS);
+
+    /**
+     * @brief Routes the I2C bus to one channel.
+     *
+     * @param channel The channel (0 to 7).
+     * @return `true` if the multiplexer acknowledged, `false` otherwise.
+     */
+    bool selectChannel(uint8_t channel) override;
+};
+
+#endif // TCA9548A_MUX_H
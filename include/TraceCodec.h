@@ -0,0 +1,140 @@
+#ifndef TRACE_CODEC_H
+#define TRACE_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "HistoryCodec.h"
+
+/**
+ * @file TraceCodec.h
+ * @brief Compact block encoding of the raw sensor stream for recording and replay.
+ */
+
+#define TRACE_FORMAT_VERSION 1 ///< Version byte at the start of every block
+#define TRACE_HEADER_BYTES 4   ///< Version, reserved byte and 16-bit event count
+#define TRACE_MAX_EVENT_BYTES (2 * 5 + HISTORY_CHANNEL_COUNT * 5) ///< Worst-case size of one encoded event
+
+/**
+ * @brief Kind of a trace event.
+ */
+enum TraceEventType {
+    TRACE_POLL_EMPTY = 0, ///< `isDataAvailable()` returned `false`
+    TRACE_SAMPLE = 1      ///< `isDataAvailable()` returned `true` and the readings were taken
+};
+
+/**
+ * @struct TraceEvent
+ * @brief One call of `SensorManager::isDataAvailable()` and, for samples, the raw readings.
+ */
+struct TraceEvent {
+    uint32_t timestampMs; ///< `millis()` at the time of the call
+    uint32_t pollMicros; ///< Duration of the `isDataAvailable()` call in us
+    TraceEventType type; ///< Whether data was available
+    float values[HISTORY_CHANNEL_COUNT]; ///< Raw readings indexed by `HistoryChannel` (samples only)
+};
+
+/**
+ * @class TraceEncoder
+ * @brief Encodes trace events incrementally into one fixed-size block.
+ *
+ * Every event is a sequence of LEB128 varints:
+ * - the timestamp delta to the previous event, shifted left by one with the event type in
+ *   the lowest bit,
+ * - the poll duration in us,
+ * - for samples, the zigzag delta of each value (quantized like the history to
+ *   1/`HISTORY_VALUE_RESOLUTION`) to the previous sample of the block.
+ *
+ * A poll costs 3 to 4 bytes and a sample typically 10 to 14. Each block starts from zero
+ * and can be decoded on its own. Like the history codec, it needs no Arduino headers.
+ */
+class TraceEncoder {
+private:
+    uint8_t buffer[TRACE_BLOCK_BYTES]; ///< Header followed by the events
+    size_t size; ///< Number of bytes written including the header
+    uint16_t eventCount; ///< Number of events in the block
+    uint32_t lastTimestamp; ///< Timestamp of the previous event in ms
+    int32_t lastValues[HISTORY_CHANNEL_COUNT]; ///< Quantized values of the previous sample
+
+public:
+    /**
+     * @brief Constructs an empty block.
+     */
+    TraceEncoder();
+
+    /**
+     * @brief Discards the block contents.
+     */
+    void reset();
+
+    /**
+     * @brief Appends one event.
+     *
+     * @param event The event; its timestamp must not precede the previous one.
+     * @return `true` if the event was stored, `false` if the block is full.
+     */
+    bool append(const TraceEvent& event);
+
+    /**
+     * @brief Retrieves the encoded block.
+     */
+    const uint8_t* getData() const;
+
+    /**
+     * @brief Retrieves the size of the encoded block in bytes.
+     */
+    size_t getSize() const;
+
+    /**
+     * @brief Retrieves the number of events in the block.
+     */
+    uint16_t getEventCount() const;
+};
+
+/**
+ * @class TraceDecoder
+ * @brief Reads the events back from one encoded block.
+ */
+class TraceDecoder {
+private:
+    const uint8_t* data = nullptr; ///< The encoded block
+    size_t size = 0; ///< Size of the block in bytes
+    size_t position = 0; ///< Read position in bytes
+    uint16_t eventCount = 0; ///< Number of events in the block
+    uint16_t eventsRead = 0; ///< Number of events decoded so far
+    uint32_t lastTimestamp = 0; ///< Timestamp of the previous event in ms
+    int32_t lastValues[HISTORY_CHANNEL_COUNT] = {}; ///< Quantized values of the previous sample
+
+    /**
+     * @brief Reads one LEB128 varint.
+     *
+     * @param value Receives the value.
+     * @return `true` on success, `false` if the block ends early.
+     */
+    bool readVarint(uint32_t& value);
+
+public:
+    /**
+     * @brief Starts decoding a block.
+     *
+     * @param data The encoded block.
+     * @param size The size of the block in bytes.
+     * @return `true` if the header is valid, `false` otherwise.
+     */
+    bool begin(const uint8_t* data, size_t size);
+
+    /**
+     * @brief Decodes the next event.
+     *
+     * @param event Receives the event.
+     * @return `true` if an event was decoded, `false` at the end of the block or on corrupt data.
+     */
+    bool next(TraceEvent& event);
+
+    /**
+     * @brief Retrieves the number of events announced by the header.
+     */
+    uint16_t getEventCount() const;
+};
+
+#endif // TRACE_CODEC_H
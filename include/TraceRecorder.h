@@ -0,0 +1,86 @@
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <stdint.h>
+#include "config.h"
+#include "BuildProfile.h"
+#include "TraceCodec.h"
+
+/**
+ * @file TraceRecorder.h
+ * @brief Ring of trace blocks recording the raw sensor stream for later replay.
+ */
+
+/**
+ * @class TraceRecorder
+ * @brief Keeps the most recent `TRACE_BLOCK_COUNT` encoded trace blocks while recording.
+ *
+ * Recording is started and stopped at runtime (console `trace start|stop`). Like a flight
+ * recorder, the oldest block is reused once the ring is full, so the trace always ends with
+ * the latest events. The memory footprint is fixed at `TRACE_BLOCK_COUNT` * `TRACE_BLOCK_BYTES`,
+ * or a single block in build profiles without tracing.
+ */
+class TraceRecorder {
+private:
+    static constexpr uint8_t BLOCK_COUNT = ACTIVE_PROFILE.traceRecorder ? TRACE_BLOCK_COUNT : 1; ///< Blocks in the ring
+
+    TraceEncoder blocks[BLOCK_COUNT]; ///< Block ring
+    uint8_t newest = 0; ///< Index of the block receiving events
+    uint8_t count = 1; ///< Number of blocks in use
+    uint32_t events = 0; ///< Events recorded since the last start
+    uint32_t samples = 0; ///< Samples recorded since the last start
+    bool recording = false; ///< Whether events are recorded
+
+public:
+    /**
+     * @brief Discards the previous trace and starts recording.
+     */
+    void start();
+
+    /**
+     * @brief Stops recording and keeps the trace for export.
+     */
+    void stop();
+
+    /**
+     * @brief Checks whether events are being recorded.
+     */
+    bool isRecording() const;
+
+    /**
+     * @brief Records one event if recording, starting a new block if the current one is full.
+     *
+     * @param event The event.
+     */
+    void record(const TraceEvent& event);
+
+    /**
+     * @brief Retrieves the number of blocks in use.
+     */
+    uint8_t getBlockCount() const;
+
+    /**
+     * @brief Retrieves a block.
+     *
+     * @param index 0 for the oldest block up to `getBlockCount()` - 1 for the newest.
+     * @return The block.
+     */
+    const TraceEncoder& getBlock(uint8_t index) const;
+
+    /**
+     * @brief Retrieves the number of events recorded since the last start.
+     */
+    uint32_t getTotalEvents() const;
+
+    /**
+     * @brief Retrieves the number of samples recorded since the last start.
+     */
+    uint32_t getTotalSamples() const;
+
+    /**
+     * @brief Retrieves the number of encoded bytes currently held.
+     */
+    uint32_t getStoredBytes() const;
+};
+
+#endif // TRACE_RECORDER_H
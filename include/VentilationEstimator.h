@@ -0,0 +1,130 @@
+#ifndef VENTILATION_ESTIMATOR_H
+#define VENTILATION_ESTIMATOR_H
+
+#include "config.h"
+
+/**
+ * @file VentilationEstimator.h
+ * @brief Estimates the air change rate of a room from CO2 decay episodes.
+ */
+
+/**
+ * @class VentilationEstimator
+ * @brief Detects CO2 decay episodes and fits the air change rate online.
+ *
+ * After a room is ventilated, the CO2 excess over outdoor air decays exponentially:
+ * `C(t) - C_out = (C0 - C_out) * exp(-ACH * t)`. Taking the logarithm turns this into
+ * a straight line whose slope is the air change rate. The estimator feeds every sample
+ * of a decay episode into an incremental least-squares fit (Welford-style co-moments),
+ * so it runs in constant memory and never buffers the episode.
+ */
+class VentilationEstimator {
+private:
+    float outdoorCO2; ///< CO2 level the decay converges to in ppm
+
+    // Episode detection
+    bool episodeActive = false; ///< Whether a decay episode is being fitted
+    bool hasLastSample = false; ///< Whether lastTimestamp holds a valid sample
+    unsigned long lastTimestamp = 0; ///< Timestamp of the previous sample in ms
+    unsigned long episodeStart = 0; ///< Timestamp of the first sample of the episode in ms
+    float smoothedCO2 = 0.0f; ///< Exponentially smoothed CO2 used for episode detection in ppm
+    float peakCO2 = 0.0f; ///< Running smoothed peak while no episode is active in ppm
+    float minCO2 = 0.0f; ///< Lowest smoothed CO2 seen in the running episode in ppm
+
+    // Incremental regression of ln(CO2 - outdoorCO2) over time
+    unsigned int count = 0; ///< Number of samples in the fit
+    float episodeSeconds = 0.0f; ///< Time of the latest fitted sample in s since episode start
+    float meanT = 0.0f; ///< Mean sample time in s since episode start
+    float meanY = 0.0f; ///< Mean log excess
+    float coMomentTY = 0.0f; ///< Sum of (t - meanT) * (y - meanY)
+    float momentTT = 0.0f; ///< Sum of (t - meanT)^2
+    float momentYY = 0.0f; ///< Sum of (y - meanY)^2
+
+    // Last completed episode
+    bool estimateAvailable = false; ///< Whether a valid estimate has been produced
+    float lastAirChangeRate = 0.0f; ///< Air changes per hour of the last episode
+    float lastFitQuality = 0.0f; ///< R^2 of the last episode fit
+    float lastEpisodeMinutes = 0.0f; ///< Duration of the last episode in minutes
+
+    /**
+     * @brief Starts a new episode with the given sample as its first point.
+     *
+     * @param co2 The CO2 concentration in ppm.
+     * @param timestampMs The sample timestamp in ms.
+     */
+    void startEpisode(float co2, unsigned long timestampMs);
+
+    /**
+     * @brief Adds one point to the running regression.
+     *
+     * @param co2 The CO2 concentration in ppm.
+     * @param timestampMs The sample timestamp in ms.
+     */
+    void addPoint(float co2, unsigned long timestampMs);
+
+    /**
+     * @brief Closes the running episode and evaluates the fit.
+     *
+     * @return `true` if the episode produced a valid estimate, `false` otherwise.
+     */
+    bool finishEpisode();
+
+public:
+    /**
+     * @brief Constructs the estimator.
+     *
+     * @param outdoorCO2 The CO2 level the decay converges to in ppm.
+     */
+    explicit VentilationEstimator(float outdoorCO2 = FRESH_AIR_CO2);
+
+    /**
+     * @brief Feeds one CO2 sample into the estimator.
+     *
+     * @param co2 The CO2 concentration in ppm.
+     * @param timestampMs The sample timestamp in ms (e.g. from `millis()`).
+     * @return `true` if this sample completed an episode with a valid estimate.
+     */
+    bool addSample(float co2, unsigned long timestampMs);
+
+    /**
+     * @brief Discards the running episode and the detection state.
+     */
+    void reset();
+
+    /**
+     * @brief Checks whether a decay episode is currently being fitted.
+     *
+     * @return `true` while an episode is active.
+     */
+    bool isEpisodeActive() const;
+
+    /**
+     * @brief Checks whether at least one valid estimate has been produced.
+     *
+     * @return `true` if the last-episode getters hold valid data.
+     */
+    bool hasEstimate() const;
+
+    /**
+     * @brief Retrieves the air change rate of the last valid episode.
+     *
+     * @return The air change rate in 1/h.
+     */
+    float getLastAirChangeRate() const;
+
+    /**
+     * @brief Retrieves the fit quality of the last valid episode.
+     *
+     * @return The coefficient of determination (R^2) of the log-linear fit.
+     */
+    float getLastFitQuality() const;
+
+    /**
+     * @brief Retrieves the duration of the last valid episode.
+     *
+     * @return The episode duration in minutes.
+     */
+    float getLastEpisodeMinutes() const;
+};
+
+#endif // VENTILATION_ESTIMATOR_H
\ No newline at end of file
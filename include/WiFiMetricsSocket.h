@@ -0,0 +1,82 @@
+#ifndef WIFI_METRICS_SOCKET_H
+#define WIFI_METRICS_SOCKET_H
+
+#include <ESP8266WiFi.h>
+#include "config.h"
+#include "MetricsServer.h"
+
+/**
+ * @file WiFiMetricsSocket.h
+ * @brief Metrics server socket on the ESP8266 WiFi stack.
+ */
+
+/**
+ * @class WiFiMetricsSocket
+ * @brief Listens on `METRICS_PORT` with `WiFiServer` and serves one `WiFiClient`.
+ *
+ * Accepted connections have Nagle's algorithm disabled, so each piece of the response
+ * leaves as soon as it is written.
+ */
+class WiFiMetricsSocket : public MetricsSocket {
+private:
+    WiFiServer server; ///< Listening socket
+    WiFiClient client; ///< Connection being served
+
+public:
+    /**
+     * @brief Constructs the socket.
+     *
+     * @param port The TCP port to listen on.
+     */
+    WiFiMetricsSocket(uint16_t port = METRICS_PORT);
+
+    /**
+     * @brief Starts listening.
+     */
+    void begin() override;
+
+    /**
+     * @brief Accepts a waiting connection without blocking.
+     *
+     * @return `true` if a connection was accepted, `false` if none is waiting.
+     */
+    bool accept() override;
+
+    /**
+     * @brief Retrieves the number of received bytes that can be read.
+     */
+    int available() override;
+
+    /**
+     * @brief Reads one received byte.
+     *
+     * @return The byte, or -1 if none is available.
+     */
+    int read() override;
+
+    /**
+     * @brief Retrieves the number of bytes the send buffer accepts without blocking.
+     */
+    size_t availableForWrite() override;
+
+    /**
+     * @brief Queues bytes for sending.
+     *
+     * @param data The bytes.
+     * @param length The number of bytes.
+     * @return The number of bytes queued.
+     */
+    size_t write(const uint8_t* data, size_t length) override;
+
+    /**
+     * @brief Checks whether the peer is still connected or unread data remains.
+     */
+    bool connected() override;
+
+    /**
+     * @brief Closes the connection without waiting for the queued data to be acknowledged.
+     */
+    void close() override;
+};
+
+#endif // WIFI_METRICS_SOCKET_H
\ No newline at end of file
@@ -1,31 +1,156 @@
-#ifndef CONFIG_H
-#define CONFIG_H
-
-// Centralized configuration constants
-#define EEPROM_CALIBRATION_FLAG_ADDRESS 0x10 // Example address in EEPROM
-#define CALIBRATION_DONE 1
-#define FRESH_AIR_CO2 400 // CO2 concentration in fresh air (ppm)
-
-// Display settings
-#define SCREEN_WIDTH 128
-#define SCREEN_HEIGHT 64
-#define OLED_RESET -1
-#define SCREEN_ADDRESS 0x3C
-
-// Calibration settings
-#define CO2_MODERATE_THRESHOLD 1000.0 // ppm
-#define CO2_CRITICAL_THRESHOLD 2000.0 // ppm
-
-// Default sensor readings
-#define DEFAULT_CO2 400.0f ///< Default CO2 concentration in ppm
-#define DEFAULT_TEMP_SCD 20.0f ///< Default temperature from SCD30 in °C
-#define DEFAULT_HUMIDITY 50.0f ///< Default humidity in %
-
-// Message strings
-#define MSG_CALIBRATION_READY "Calibration ready."
-#define MSG_CALIBRATION_FAILED "Calibration failed."
-#define MSG_TRY_AGAIN "Please try again."
-#define MSG_ALREADY_CALIBRATED "Sensor is already calibrated."
-#define MSG_CALIBRATION_NEEDED "Calibration is needed."
-
+#ifndef CONFIG_H
+#define CONFIG_H
+
+// Centralized configuration constants
+#define EEPROM_SIZE 1024 // Emulated EEPROM size in bytes
+#define EEPROM_CALIBRATION_FLAG_ADDRESS 0x10 // Example address in EEPROM
+#define EEPROM_EXPOSURE_ADDRESS 0x20 // Start of the persisted exposure history
+#define CALIBRATION_DONE 1
+#define FRESH_AIR_CO2 400 // CO2 concentration in fresh air (ppm)
+
+// Display settings
+#define SCREEN_WIDTH 128
+#define SCREEN_HEIGHT 64
+#define OLED_RESET -1
+#define SCREEN_ADDRESS 0x3C
+
+// Calibration settings
+#define CO2_MODERATE_THRESHOLD 1000.0 // ppm
+#define CO2_CRITICAL_THRESHOLD 2000.0 // ppm
+
+// Default sensor readings
+#define DEFAULT_CO2 400.0f ///< Default CO2 concentration in ppm
+#define DEFAULT_TEMP_SCD 20.0f ///< Default temperature from SCD30 in °C
+#define DEFAULT_HUMIDITY 50.0f ///< Default humidity in %
+
+// Signal filtering (fixed-point Kalman filters)
+#define FILTER_CO2_NOISE_PPM 10.0f ///< Constant part of the CO2 measurement noise (1 sigma, ppm)
+#define FILTER_CO2_NOISE_RELATIVE 0.01f ///< Concentration-proportional part of the CO2 measurement noise
+#define FILTER_CO2_PROCESS_NOISE_PPM 3.0f ///< Expected CO2 change between samples (1 sigma, ppm)
+#define FILTER_CO2_STEP_PPM 100.0f ///< Innovation treated as a real step change rather than noise (ppm)
+#define FILTER_TEMP_NOISE_BMP 0.1f ///< BMP280 temperature noise (1 sigma, °C)
+#define FILTER_TEMP_NOISE_SCD 0.2f ///< SCD30 temperature noise after bias removal (1 sigma, °C)
+#define FILTER_TEMP_PROCESS_NOISE 0.05f ///< Expected temperature change between samples (1 sigma, °C)
+#define FILTER_BIAS_SHIFT 8 ///< SCD30 self-heating bias adapts by 2^-FILTER_BIAS_SHIFT per sample
+#define FILTER_CO2_MAX_PPM 32000.0f ///< Readings above are clamped to stay within Q16.16 (the SCD30 reports up to 40000 ppm)
+#define FILTER_TEMP_MIN -40.0f ///< Temperatures below are clamped (°C)
+#define FILTER_TEMP_MAX 85.0f ///< Temperatures above are clamped (°C)
+
+// Ambient pressure compensation of the SCD30
+#define PRESSURE_COMP_DEADBAND_HPA 2.0f ///< Pressure change that triggers a new compensation write (hPa)
+#define PRESSURE_COMP_MIN_INTERVAL_MS 600000UL ///< Minimum time between compensation writes (ms)
+#define PRESSURE_COMP_MIN_HPA 700.0f ///< Lowest pressure accepted by the SCD30 (hPa)
+#define PRESSURE_COMP_MAX_HPA 1400.0f ///< Highest pressure accepted by the SCD30 (hPa)
+
+// Ventilation (air changes per hour) estimation
+#define VENT_SMOOTHING_FACTOR 0.1f ///< EMA factor of the signal used to detect episode boundaries
+#define VENT_DECAY_START_DROP 50.0f ///< Drop below the running peak that opens a decay episode (ppm)
+#define VENT_RISE_TOLERANCE 25.0f ///< Rise above the episode minimum that closes a decay episode (ppm)
+#define VENT_MIN_EXCESS 30.0f ///< Minimum CO2 above FRESH_AIR_CO2 still used for the fit (ppm)
+#define VENT_MAX_SAMPLE_GAP_MS 120000UL ///< Sample gap that aborts a running episode (ms)
+#define VENT_MIN_SAMPLES 10 ///< Minimum samples for a valid episode
+#define VENT_MIN_DURATION_S 300.0f ///< Minimum episode duration for a valid estimate (s)
+#define VENT_MIN_FIT_QUALITY 0.8f ///< Minimum R^2 of the log-linear fit
+#define VENTILATION_PAGE_DURATION_MS 10000UL ///< How long the result page is held after an episode (ms)
+
+// CO2 exposure accounting
+#define EXPOSURE_HOUR_COUNT 24 ///< Number of hourly rollups kept
+#define EXPOSURE_DAY_COUNT 7 ///< Number of daily rollups kept
+#define EXPOSURE_MAX_SAMPLE_GAP_MS 300000UL ///< Longer gaps between samples are not integrated (ms)
+
+// Compressed measurement history
+#define HISTORY_BLOCK_BYTES 256 ///< Size of one encoded history block (bytes)
+#define HISTORY_ARCHIVE_BLOCKS 16 ///< Number of blocks kept in RAM for export
+#define HISTORY_VALUE_RESOLUTION 100 ///< Stored steps per unit (two decimals, as logged)
+
+// Sensor trace recording for replay on the host
+#define TRACE_BLOCK_BYTES 256 ///< Size of one encoded trace block (bytes)
+#define TRACE_BLOCK_COUNT 16 ///< Number of trace blocks kept in RAM while recording
+
+// MQTT publishing; pass the credentials as build flags, e.g. -DWIFI_SSID=\"name\"
+#ifndef WIFI_SSID
+#define WIFI_SSID "" ///< WiFi network; publishing is disabled while empty
+#endif
+#ifndef WIFI_PASSWORD
+#define WIFI_PASSWORD "" ///< WiFi passphrase
+#endif
+#ifndef MQTT_HOST
+#define MQTT_HOST "mqtt.local" ///< Broker host name or address
+#endif
+#define MQTT_PORT 1883 ///< Broker port
+#define MQTT_TOPIC "co2-meter/readings" ///< Topic the batches are published to
+#define MQTT_CLIENT_ID "co2-meter" ///< MQTT client and device identifier
+#define MQTT_BATCH_INTERVAL_MS 30000UL ///< Time covered by one published batch (ms)
+#define MQTT_PAYLOAD_SIZE 1024 ///< Maximum size of one batch (bytes)
+#define MQTT_QUEUE_SLOTS 8 ///< Batches kept while the broker is unreachable
+#define MQTT_DRAIN_INTERVAL_MS 500UL ///< Minimum time between two publishes (ms)
+#define MQTT_RECONNECT_MIN_MS 2000UL ///< First reconnection delay (ms)
+#define MQTT_RECONNECT_MAX_MS 60000UL ///< Longest reconnection delay (ms)
+#define MQTT_CONNECT_TIMEOUT_MS 2000 ///< Longest blocking TCP connect to the broker (ms)
+#define MQTT_RATE_WINDOW_MS 10000UL ///< Window of the messages/s metric (ms)
+
+// Prometheus metrics endpoint
+#define METRICS_PORT 80 ///< TCP port of the HTTP server
+#define METRICS_BUFFER_SIZE 2048 ///< Size of the pre-rendered response (bytes)
+#define METRICS_FIELD_WIDTH 12 ///< Characters reserved for each value
+#define METRICS_CLIENT_TIMEOUT_MS 2000UL ///< Connections are dropped after this time (ms)
+#define METRICS_MAX_BYTES_PER_POLL 256 ///< Request bytes consumed per loop iteration
+#define HTTP_REQUEST_LINE_SIZE 64 ///< Longest accepted request line including the terminator
+#define HTTP_MAX_REQUEST_BYTES 2048 ///< Longest accepted request including headers (bytes)
+
+// Low-power duty cycling; build with -DLOW_POWER=1 and wire GPIO16 to RST for the timer wake
+#ifndef LOW_POWER
+#define LOW_POWER 0 ///< Deep-sleep between samples instead of running loop()
+#endif
+#define LOW_POWER_SAMPLE_INTERVAL_MS 60000UL ///< Time between two samples, also the SCD30 interval (ms)
+#define LOW_POWER_DATA_TIMEOUT_MS 3000UL ///< Longest wait for SCD30 data after a wake (ms)
+#define LOW_POWER_DATA_POLL_MS 50 ///< Polling period while waiting for SCD30 data (ms)
+#define LOW_POWER_RETRY_MS 5000UL ///< Sleep before retrying a sample that was not ready (ms)
+#define LOW_POWER_MIN_SLEEP_MS 1000UL ///< Shortest deep sleep (ms)
+#define LOW_POWER_WAKE_TOLERANCE_MS 2000UL ///< Wakes this early are treated as on time (ms)
+#define LOW_POWER_BUTTON_DISPLAY_MS 10000UL ///< How long the display stays on after a button wake (ms)
+#define RTC_STATE_OFFSET_BLOCKS 32 ///< First 4-byte RTC user memory block of the retained state (0-31 belong to OTA)
+#define RTC_STATE_MAX_BYTES 384 ///< RTC user memory available from RTC_STATE_OFFSET_BLOCKS (bytes)
+
+// Several rooms behind a TCA9548A I2C multiplexer; build with -DSENSOR_ROOMS=<n> (2 to 8)
+#ifndef SENSOR_ROOMS
+#define SENSOR_ROOMS 1 ///< Number of SCD30/BMP280 sets, one per multiplexer channel; 1 runs without multiplexer
+#endif
+#define SENSOR_GROUP_MAX_ROOMS 8 ///< Channels of the TCA9548A
+#define TCA9548A_ADDRESS 0x70 ///< I2C address of the multiplexer (A0-A2 low)
+#define SCD30_INTERVAL_MS 2000UL ///< SCD30 measurement interval outside low-power mode (ms)
+#define SENSOR_GROUP_RETRY_MS 100UL ///< Delay before re-checking a sensor whose data was not ready (ms)
+#define SENSOR_GROUP_OFFLINE_MS 20000UL ///< A room without a sample for this long is taken offline (ms)
+#define SENSOR_GROUP_RESTART_MS 30000UL ///< Time between attempts to initialize an offline room again (ms)
+#if SENSOR_ROOMS < 1 || SENSOR_ROOMS > SENSOR_GROUP_MAX_ROOMS
+#error "SENSOR_ROOMS must be between 1 and SENSOR_GROUP_MAX_ROOMS"
+#endif
+#if LOW_POWER && SENSOR_ROOMS > 1
+#error "LOW_POWER supports a single room only"
+#endif
+
+// Display pages and the page button (GPIO0 is the FLASH button; keep it released during boot)
+#define BUTTON_PIN 0 ///< GPIO of the page button, active low with the internal pull-up
+#define BUTTON_DEBOUNCE_MS 30UL ///< Time the button level must be stable (ms)
+#define DISPLAY_PAGE_INTERVAL_MS 10000UL ///< Time each page is shown by the rotation (ms)
+#define DISPLAY_PAGE_HOLD_MS 60000UL ///< Rotation pause after a button press (ms)
+#define DISPLAY_BACKGROUND_SLOTS 2 ///< Page backgrounds cached as bitmaps (1 KB each)
+
+// Main loop scheduling
+#define SENSOR_POLL_INTERVAL_MS 1000UL ///< Time between two sensor polls (ms)
+#define LOOP_IDLE_MS 10 ///< Sleep at the end of each loop iteration (ms)
+
+// Serial console
+#define CONSOLE_BUFFER_SIZE 64 ///< Maximum length of a command line including the terminator
+#define CONSOLE_RESPONSE_SIZE 96 ///< Maximum length of a response line including the terminator
+#define CONSOLE_MAX_ARGS 4 ///< Maximum number of words in a command line
+#define CONSOLE_MAX_BYTES_PER_POLL 32 ///< Bytes consumed from Serial per loop iteration
+
+// Message strings
+#define MSG_CALIBRATION_READY "Calibration ready."
+#define MSG_CALIBRATION_FAILED "Calibration failed."
+#define MSG_TRY_AGAIN "Please try again."
+#define MSG_ALREADY_CALIBRATED "Sensor is already calibrated."
+#define MSG_CALIBRATION_NEEDED "Calibration is needed."
+
 #endif // CONFIG_H
\ No newline at end of file
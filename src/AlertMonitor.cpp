@@ -0,0 +1,66 @@
+#include "AlertMonitor.h"
+
+/**
+ * @file AlertMonitor.cpp
+ * @brief Implements the CO2 alert classification.
+ */
+
+/**
+ * @brief Classifies a CO2 reading and stores the resulting level.
+ *
+ * @param co2 The CO2 concentration in ppm.
+ * @return The alert level of the reading.
+ */
+AlertLevel AlertMonitor::evaluate(float co2) {
+    if (co2 > criticalThreshold) {
+        level = ALERT_CRITICAL;
+    } else if (co2 > moderateThreshold) {
+        level = ALERT_MODERATE;
+    } else {
+        level = ALERT_NONE;
+    }
+    return level;
+}
+
+/**
+ * @brief Retrieves the level of the last evaluated reading.
+ *
+ * @return The current alert level.
+ */
+AlertLevel AlertMonitor::getLevel() const {
+    return level;
+}
+
+/**
+ * @brief Sets both alert thresholds.
+ *
+ * @param moderate The moderate threshold in ppm.
+ * @param critical The critical threshold in ppm.
+ * @return `true` if the thresholds were accepted, `false` if they are not ordered or not positive.
+ */
+bool AlertMonitor::setThresholds(float moderate, float critical) {
+    if (!(moderate > 0.0f && moderate < critical)) {
+        return false;
+    }
+    moderateThreshold = moderate;
+    criticalThreshold = critical;
+    return true;
+}
+
+/**
+ * @brief Retrieves the moderate alert threshold.
+ *
+ * @return The threshold in ppm.
+ */
+float AlertMonitor::getModerateThreshold() const {
+    return moderateThreshold;
+}
+
+/**
+ * @brief Retrieves the critical alert threshold.
+ *
+ * @return The threshold in ppm.
+ */
+float AlertMonitor::getCriticalThreshold() const {
+    return criticalThreshold;
+}
\ No newline at end of file
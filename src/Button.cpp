@@ -0,0 +1,36 @@
+#include "Button.h"
+#include "config.h"
+
+/**
+ * @file Button.cpp
+ * @brief Implements the push button debouncing.
+ */
+
+/**
+ * @brief Feeds the current raw state of the button.
+ *
+ * @param pressed Whether the button reads as pressed.
+ * @param now The current time in ms.
+ * @return `true` once per debounced press, `false` otherwise.
+ */
+bool Button::update(bool pressed, unsigned long now) {
+    if (pressed != lastReading) {
+        lastReading = pressed;
+        lastChange = now;
+        return false;
+    }
+    if (pressed == stableState || now - lastChange < BUTTON_DEBOUNCE_MS) {
+        return false;
+    }
+    stableState = pressed;
+    return stableState;
+}
+
+/**
+ * @brief Retrieves the debounced state.
+ *
+ * @return `true` while the button is pressed.
+ */
+bool Button::isPressed() const {
+    return stableState;
+}
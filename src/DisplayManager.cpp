@@ -1,212 +1,294 @@
-#include "DisplayManager.h"
-#include <Adafruit_GFX.h>
-#include <Adafruit_SSD1306.h>
-#include <Wire.h>
-#include "Logger.h"
-
-/**
- * @brief Constructs the DisplayManager object and initializes the display object.
- */
-DisplayManager::DisplayManager()
-    : display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET) {}
-
-/**
- * @brief Initializes the OLED display.
- * 
- * @return `true` if the display was successfully initialized, `false` otherwise.
- */
-bool DisplayManager::initialize() {
-    if (!display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS)) {
-        Logger::error("Display initialization failed");
-        return false;
-    }
-    display.clearDisplay();
-    Logger::info("Display initialized successfully");
-    return true;
-}
-
-/**
- * @brief Displays a calibration message on the screen.
- * 
- * @param message1 The first line of the calibration message.
- * @param message2 The second line of the calibration message.
- */
-void DisplayManager::showCalibrationMessage(const char* message1, const char* message2) {
-    display.clearDisplay();
-    display.setCursor(0, 0);
-    display.setTextSize(FONT_SIZE_SMALL); // Use the constant for small font size
-    display.setTextColor(SSD1306_WHITE);
-    display.println(message1);
-    display.println(message2);
-    display.display();
-}
-
-/**
- * @brief Displays a blinking warning message or normal readings alternately.
- * 
- * @param line1 The first line of the warning message.
- * @param line2 The second line of the warning message.
- * @param line3 The third line of the warning message.
- * @param line4 The fourth line of the warning message.
- * @param co2 The CO2 level to display.
- * @param temperatureSCD The temperature from the SCD30 sensor.
- * @param temperatureBMP The temperature from the BMP280 sensor.
- * @param humidity The humidity level to display.
- * @param pressure The pressure level to display.
- */
-void DisplayManager::showBlinkingWarning(const char* line1, const char* line2, const char* line3, const char* line4, float co2, float temperatureSCD, float temperatureBMP, float humidity, float pressure) {
-    unsigned long currentTime = millis();
-
-    // Check if it's time to toggle the warning display
-    if (currentTime - lastBlinkTime >= blinkInterval) {
-        lastBlinkTime = currentTime;
-        isWarningActive = !isWarningActive; // Toggle the warning state
-    }
-
-    display.clearDisplay();
-
-    if (isWarningActive) {
-        // Display the warning with the largest font
-        display.setTextSize(FONT_SIZE_LARGE); // Use the constant for large font size
-        display.setTextColor(SSD1306_WHITE);
-        display.setCursor(0, 0);
-        display.println("WARNING!");
-
-        // Display the 4 lines of the warning message
-        display.setCursor(0, 16); // Move cursor below "WARNING!"
-        display.println(line1);
-        display.println(line2);
-        display.println(line3);
-        display.println(line4);
-    } else {
-        // Use the reusable method to display the normal screen
-        showNormalScreen(co2, temperatureSCD, temperatureBMP, humidity, pressure);
-    }
-
-    display.display();
-}
-
-/**
- * @brief Displays a centered headline on the screen.
- * 
- * @param text The headline text to display.
- */
-void DisplayManager::showHeadline(const char* text) {
-    display.setTextSize(2);
-    display.setTextColor(SSD1306_WHITE, SSD1306_BLACK);
-    int16_t x1, y1;
-    uint16_t textWidth, textHeight;
-    display.getTextBounds(text, 0, 0, &x1, &y1, &textWidth, &textHeight);
-    int16_t x = (SCREEN_WIDTH - textWidth) / 2;
-    display.setCursor(x, 0);
-    display.println(text);
-    display.display();
-}
-
-/**
- * @brief Displays the normal screen with sensor readings.
- * 
- * @param co2 The CO2 level to display.
- * @param temperatureSCD The temperature from the SCD30 sensor.
- * @param temperatureBMP The temperature from the BMP280 sensor.
- * @param humidity The humidity level to display.
- * @param pressure The pressure level to display.
- */
-void DisplayManager::showNormalScreen(float co2, float temperatureSCD, float temperatureBMP, float humidity, float pressure) {
-    display.clearDisplay(); // Clear the entire display
-
-    showHeadline("CO2 Meter");
-    displayReadings(co2, temperatureSCD, temperatureBMP, humidity, pressure);
-}
-
-/**
- * @brief Displays sensor readings on the screen.
- * 
- * @param co2 The CO2 level to display.
- * @param temperatureSCD The temperature from the SCD30 sensor.
- * @param temperatureBMP The temperature from the BMP280 sensor.
- * @param humidity The humidity level to display.
- * @param pressure The pressure level to display.
- */
-void DisplayManager::displayReadings(float co2, float temperatureSCD, float temperatureBMP, float humidity, float pressure) {
-    Logger::debug("Updating display with sensor readings...");
-    display.setTextSize(FONT_SIZE_SMALL); // Small font size for readings
-
-    // Use a lambda function to print aligned text without clearing the entire area
-    auto printAligned = [&](const char* label, float value, const char* unit, int row) {
-        char valueBuffer[8];
-        snprintf(valueBuffer, sizeof(valueBuffer), "%.2f", value);
-        char fullValue[16];
-        snprintf(fullValue, sizeof(fullValue), "%s %s", valueBuffer, unit);
-
-        // Calculate the width of the full value text
-        int16_t x1, y1;
-        uint16_t fullValueWidth, textHeight;
-        display.getTextBounds(fullValue, 0, 0, &x1, &y1, &fullValueWidth, &textHeight);
-
-        // Print the label on the left
-        display.setCursor(0, row);
-        display.setTextColor(SSD1306_WHITE, SSD1306_BLACK); // Overwrite previous text
-        display.print(label);
-
-        // Print the value on the right
-        display.setCursor(SCREEN_WIDTH - fullValueWidth, row);
-        display.print(fullValue);
-    };
-
-    int baseRow = 17; // Start below the headline
-    int rowSpacing = 10;
-
-    // Update only the readings area without clearing it
-    printAligned("CO2:", co2, "ppm", baseRow);
-    printAligned("T (SCD30):", temperatureSCD, "C", baseRow + rowSpacing);
-    printAligned("T (BMP280):", temperatureBMP, "C", baseRow + 2 * rowSpacing);
-    printAligned("Humidity:", humidity, "%", baseRow + 3 * rowSpacing);
-    printAligned("Pressure:", pressure, "hPa", baseRow + 4 * rowSpacing);
-
-    display.display(); // Update the display with the new content
-    Logger::debug("Display updated.");
-}
-
-/**
- * @brief Runs a display check to verify the OLED functionality.
- */
-void DisplayManager::runDisplayCheck() {
-    Logger::info("Running display check...");
-
-    display.clearDisplay();
-    display.setTextSize(1);
-    display.setTextColor(SSD1306_WHITE);
-    display.setCursor(0, 0);
-    display.println("Display Test");
-    display.setCursor(0, 10);
-    display.println("Line 2: Hello!");
-    display.setCursor(0, 20);
-    display.println("Line 3: Testing...");
-    display.display();
-
-    delay(5000); // Keep the test visible for 5 seconds
-    Logger::info("Display check complete.");
-}
-
-/**
- * @brief Displays a splash screen with a centered message.
- * 
- * @param text The message to display on the splash screen.
- */
-void DisplayManager::splashScreen(const char* text) {
-    display.clearDisplay();
-    display.setTextSize(FONT_SIZE_SMALL); // Use the constant for large font size
-    display.setTextColor(SSD1306_WHITE, SSD1306_BLACK);
-
-    // Center the text on the screen
-    int16_t x1, y1;
-    uint16_t textWidth, textHeight;
-    display.getTextBounds(text, 0, 0, &x1, &y1, &textWidth, &textHeight);
-    int16_t x = (SCREEN_WIDTH - textWidth) / 2;
-    int16_t y = (SCREEN_HEIGHT - textHeight) / 2;
-
-    display.setCursor(x, y);
-    display.println(text);
-    display.display();
-}
\ No newline at end of file
+#include "DisplayManager.h"
+#include <Adafruit_GFX.h>
+#include <Adafruit_SSD1306.h>
+#include <Wire.h>
+#include "Logger.h"
+#include "config.h"
+#include <string.h>
+
+/**
+ * @brief Constructs the DisplayManager object and initializes the display object.
+ */
+DisplayManager::DisplayManager()
+    : display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET) {}
+
+/**
+ * @brief Initializes the OLED display.
+ * 
+ * @return `true` if the display was successfully initialized, `false` otherwise.
+ */
+bool DisplayManager::initialize() {
+    if (!display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS)) {
+        Logger::error("Display initialization failed");
+        return false;
+    }
+    display.clearDisplay();
+    Logger::info("Display initialized successfully");
+    return true;
+}
+
+/**
+ * @brief Displays a calibration message on the screen.
+ * 
+ * @param message1 The first line of the calibration message.
+ * @param message2 The second line of the calibration message.
+ */
+void DisplayManager::showCalibrationMessage(const char* message1, const char* message2) {
+    display.clearDisplay();
+    display.setCursor(0, 0);
+    display.setTextSize(FONT_SIZE_SMALL); // Use the constant for small font size
+    display.setTextColor(SSD1306_WHITE);
+    display.println(message1);
+    display.println(message2);
+    display.display();
+}
+
+/**
+ * @brief Displays a static warning message on the screen.
+ * 
+ * @param line1 The first line of the warning message.
+ * @param line2 The second line of the warning message.
+ * @param line3 The third line of the warning message.
+ * @param line4 The fourth line of the warning message.
+ */
+void DisplayManager::showWarning(const char* line1, const char* line2, const char* line3, const char* line4) {
+    display.clearDisplay();
+    drawWarning(line1, line2, line3, line4);
+    display.display();
+}
+
+/**
+ * @brief Draws the warning message into the display buffer.
+ * 
+ * @param line1 The first line of the warning message.
+ * @param line2 The second line of the warning message.
+ * @param line3 The third line of the warning message.
+ * @param line4 The fourth line of the warning message.
+ */
+void DisplayManager::drawWarning(const char* line1, const char* line2, const char* line3, const char* line4) {
+    // Display the warning with the largest font
+    display.setTextSize(FONT_SIZE_LARGE); // Use the constant for large font size
+    display.setTextColor(SSD1306_WHITE);
+    display.setCursor(0, 0);
+    display.println("WARNING!");
+
+    // Display the 4 lines of the warning message
+    display.setCursor(0, 16); // Move cursor below "WARNING!"
+    display.println(line1);
+    display.println(line2);
+    display.println(line3);
+    display.println(line4);
+}
+
+/**
+ * @brief Displays the normal screen with sensor readings.
+ * 
+ * @param co2 The CO2 level to display.
+ * @param temperatureSCD The temperature from the SCD30 sensor.
+ * @param temperatureBMP The temperature from the BMP280 sensor.
+ * @param humidity The humidity level to display.
+ * @param pressure The pressure level to display.
+ */
+void DisplayManager::showNormalScreen(float co2, float temperatureSCD, float temperatureBMP, float humidity, float pressure) {
+    display.clearDisplay(); // Clear the entire display
+
+    drawHeadline("CO2 Meter");
+    displayReadings(co2, temperatureSCD, temperatureBMP, humidity, pressure);
+    display.display();
+}
+
+/**
+ * @brief Draws the sensor readings below the headline into the display buffer.
+ * 
+ * @param co2 The CO2 level to display.
+ * @param temperatureSCD The temperature from the SCD30 sensor.
+ * @param temperatureBMP The temperature from the BMP280 sensor.
+ * @param humidity The humidity level to display.
+ * @param pressure The pressure level to display.
+ */
+void DisplayManager::displayReadings(float co2, float temperatureSCD, float temperatureBMP, float humidity, float pressure) {
+    Logger::debug("Updating display with sensor readings...");
+
+    // Labels on the left, values with their unit aligned to the right edge
+    auto printAligned = [&](const char* label, float value, const char* unit, int row) {
+        char fullValue[16];
+        snprintf(fullValue, sizeof(fullValue), "%.2f %s", value, unit);
+        drawText(0, row, FONT_SIZE_SMALL, label);
+        drawTextRight(row, FONT_SIZE_SMALL, fullValue);
+    };
+
+    int baseRow = 17; // Start below the headline
+    int rowSpacing = 10;
+
+    printAligned("CO2:", co2, "ppm", baseRow);
+    printAligned("T (SCD30):", temperatureSCD, "C", baseRow + rowSpacing);
+    printAligned("T (BMP280):", temperatureBMP, "C", baseRow + 2 * rowSpacing);
+    printAligned("Humidity:", humidity, "%", baseRow + 3 * rowSpacing);
+    printAligned("Pressure:", pressure, "hPa", baseRow + 4 * rowSpacing);
+    Logger::debug("Display updated.");
+}
+
+/**
+ * @brief Sets the interval at which warnings blink.
+ * 
+ * @param interval The blink interval in milliseconds.
+ */
+void DisplayManager::setBlinkInterval(unsigned long interval) {
+    blinkInterval = interval;
+}
+
+/**
+ * @brief Gets the interval at which warnings blink.
+ * 
+ * @return The blink interval in milliseconds.
+ */
+unsigned long DisplayManager::getBlinkInterval() const {
+    return blinkInterval;
+}
+
+/**
+ * @brief Runs a display check to verify the OLED functionality.
+ */
+void DisplayManager::runDisplayCheck() {
+    Logger::info("Running display check...");
+
+    display.clearDisplay();
+    display.setTextSize(1);
+    display.setTextColor(SSD1306_WHITE);
+    display.setCursor(0, 0);
+    display.println("Display Test");
+    display.setCursor(0, 10);
+    display.println("Line 2: Hello!");
+    display.setCursor(0, 20);
+    display.println("Line 3: Testing...");
+    display.display();
+
+    delay(5000); // Keep the test visible for 5 seconds
+    Logger::info("Display check complete.");
+}
+
+/**
+ * @brief Displays a splash screen with a centered message.
+ * 
+ * @param text The message to display on the splash screen.
+ */
+void DisplayManager::splashScreen(const char* text) {
+    display.clearDisplay();
+    display.setTextSize(FONT_SIZE_SMALL); // Use the constant for large font size
+    display.setTextColor(SSD1306_WHITE, SSD1306_BLACK);
+
+    // Center the text on the screen
+    int16_t x1, y1;
+    uint16_t textWidth, textHeight;
+    display.getTextBounds(text, 0, 0, &x1, &y1, &textWidth, &textHeight);
+    int16_t x = (SCREEN_WIDTH - textWidth) / 2;
+    int16_t y = (SCREEN_HEIGHT - textHeight) / 2;
+
+    display.setCursor(x, y);
+    display.println(text);
+    display.display();
+}
+
+/**
+ * @brief Switches the panel off; the display RAM keeps its content.
+ * 
+ * The SSD1306 draws a few uA while off instead of several mA.
+ */
+void DisplayManager::sleep() {
+    display.ssd1306_command(SSD1306_DISPLAYOFF);
+}
+
+/**
+ * @brief Switches the panel back on.
+ */
+void DisplayManager::wake() {
+    display.ssd1306_command(SSD1306_DISPLAYON);
+}
+
+/**
+ * @brief Clears the display buffer.
+ */
+void DisplayManager::clear() {
+    display.clearDisplay();
+}
+
+/**
+ * @brief Draws a headline centered at the top of the screen.
+ * 
+ * @param text The headline text to display.
+ */
+void DisplayManager::drawHeadline(const char* text) {
+    drawTextCentered(0, FONT_SIZE_LARGE, text);
+}
+
+/**
+ * @brief Draws text at a position.
+ * 
+ * @param x The left edge in pixels.
+ * @param y The top edge in pixels.
+ * @param size The font size (6x8 pixels per character at size 1).
+ * @param text The text to draw.
+ */
+void DisplayManager::drawText(int16_t x, int16_t y, uint8_t size, const char* text) {
+    display.setTextSize(size);
+    display.setTextColor(SSD1306_WHITE, SSD1306_BLACK);
+    display.setCursor(x, y);
+    display.print(text);
+}
+
+/**
+ * @brief Draws text aligned to the right edge of the screen.
+ * 
+ * @param y The top edge in pixels.
+ * @param size The font size.
+ * @param text The text to draw.
+ */
+void DisplayManager::drawTextRight(int16_t y, uint8_t size, const char* text) {
+    int16_t x1, y1;
+    uint16_t textWidth, textHeight;
+    display.setTextSize(size);
+    display.getTextBounds(text, 0, 0, &x1, &y1, &textWidth, &textHeight);
+    drawText(SCREEN_WIDTH - textWidth, y, size, text);
+}
+
+/**
+ * @brief Draws text centered horizontally.
+ * 
+ * @param y The top edge in pixels.
+ * @param size The font size.
+ * @param text The text to draw.
+ */
+void DisplayManager::drawTextCentered(int16_t y, uint8_t size, const char* text) {
+    int16_t x1, y1;
+    uint16_t textWidth, textHeight;
+    display.setTextSize(size);
+    display.getTextBounds(text, 0, 0, &x1, &y1, &textWidth, &textHeight);
+    drawText((SCREEN_WIDTH - textWidth) / 2, y, size, text);
+}
+
+/**
+ * @brief Copies the display buffer, e.g. to cache the background of a page.
+ * 
+ * @param buffer Receives `DISPLAY_BUFFER_BYTES` bytes.
+ */
+void DisplayManager::saveBuffer(uint8_t* buffer) {
+    memcpy(buffer, display.getBuffer(), DISPLAY_BUFFER_BYTES);
+}
+
+/**
+ * @brief Replaces the display buffer with a copy made by `saveBuffer()`.
+ * 
+ * Copying 1 KB takes a few microseconds, far less than drawing the text again.
+ * 
+ * @param buffer The `DISPLAY_BUFFER_BYTES` bytes to restore.
+ */
+void DisplayManager::restoreBuffer(const uint8_t* buffer) {
+    memcpy(display.getBuffer(), buffer, DISPLAY_BUFFER_BYTES);
+}
+
+/**
+ * @brief Transfers the display buffer to the panel.
+ */
+void DisplayManager::flush() {
+    display.display();
+}
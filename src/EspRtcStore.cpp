@@ -0,0 +1,36 @@
+#include "EspRtcStore.h"
+
+/**
+ * @file EspRtcStore.cpp
+ * @brief Implements the RTC user memory store.
+ */
+
+/**
+ * @brief Constructs the store.
+ *
+ * @param offsetBlocks The first 4-byte block of the record.
+ */
+EspRtcStore::EspRtcStore(uint32_t offsetBlocks) : offsetBlocks(offsetBlocks) {}
+
+/**
+ * @brief Reads the retained record.
+ *
+ * @param data Receives the record; must be 4-byte aligned.
+ * @param size The record size in bytes, a multiple of 4.
+ * @return `true` if the read succeeded, `false` otherwise.
+ */
+bool EspRtcStore::read(void* data, size_t size) {
+    return ESP.rtcUserMemoryRead(offsetBlocks, static_cast<uint32_t*>(data), size);
+}
+
+/**
+ * @brief Writes the retained record.
+ *
+ * @param data The record; must be 4-byte aligned.
+ * @param size The record size in bytes, a multiple of 4.
+ * @return `true` if the write succeeded, `false` otherwise.
+ */
+bool EspRtcStore::write(const void* data, size_t size) {
+    // The SDK takes a non-const pointer but only reads from it
+    return ESP.rtcUserMemoryWrite(offsetBlocks, static_cast<uint32_t*>(const_cast<void*>(data)), size);
+}
@@ -0,0 +1,322 @@
+#include "ExposureAccumulator.h"
+#include "Logger.h"
+#include <EEPROM.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @file ExposureAccumulator.cpp
+ * @brief Implements the time-weighted CO2 exposure integration and its rollups.
+ */
+
+#define EXPOSURE_MAGIC 0x45585031UL // "EXP1"
+#define MS_PER_HOUR 3600000UL
+#define HOURS_PER_DAY 24
+
+/**
+ * @brief Integrates the area of a linear CO2 segment above a threshold.
+ *
+ * @param c0 CO2 at the start of the segment in ppm.
+ * @param c1 CO2 at the end of the segment in ppm.
+ * @param seconds Duration of the segment in s.
+ * @param threshold The band threshold in ppm.
+ * @param secondsAbove Receives the time spent above the threshold in s.
+ * @return The area above the threshold in ppm*s.
+ */
+static float integrateAbove(float c0, float c1, float seconds, float threshold, float& secondsAbove) {
+    float e0 = c0 - threshold;
+    float e1 = c1 - threshold;
+
+    if (e0 <= 0.0f && e1 <= 0.0f) {
+        secondsAbove = 0.0f;
+        return 0.0f;
+    }
+    if (e0 >= 0.0f && e1 >= 0.0f) {
+        secondsAbove = seconds;
+        return 0.5f * (e0 + e1) * seconds;
+    }
+
+    // The segment crosses the threshold: only the triangle above it counts
+    float peak = e0 > 0.0f ? e0 : e1;
+    secondsAbove = seconds * peak / (e0 > 0.0f ? e0 - e1 : e1 - e0);
+    return 0.5f * peak * secondsAbove;
+}
+
+/**
+ * @brief Constructs the accumulator with the configured alert thresholds.
+ */
+ExposureAccumulator::ExposureAccumulator() {
+    thresholds[EXPOSURE_MODERATE] = CO2_MODERATE_THRESHOLD;
+    thresholds[EXPOSURE_CRITICAL] = CO2_CRITICAL_THRESHOLD;
+    clearHistory();
+}
+
+/**
+ * @brief Restores the rollup tables from EEPROM.
+ *
+ * `EEPROM.begin()` must have been called before. An invalid record starts empty tables.
+ */
+void ExposureAccumulator::begin() {
+    static_assert(EEPROM_EXPOSURE_ADDRESS + sizeof(History) <= EEPROM_SIZE,
+                  "Exposure history does not fit into EEPROM_SIZE");
+
+    EEPROM.get(EEPROM_EXPOSURE_ADDRESS, history);
+    if (history.magic != EXPOSURE_MAGIC || history.checksum != computeChecksum() ||
+        history.currentHour >= EXPOSURE_HOUR_COUNT || history.currentDay >= EXPOSURE_DAY_COUNT) {
+        clearHistory();
+        Logger::info("Exposure history initialized.");
+    } else {
+        Logger::info("Exposure history restored from EEPROM.");
+    }
+    hasLastSample = false;
+}
+
+/**
+ * @brief Writes the rollup tables to EEPROM.
+ *
+ * @return `true` if the EEPROM commit succeeded, `false` otherwise.
+ */
+bool ExposureAccumulator::save() {
+    history.checksum = computeChecksum();
+    EEPROM.put(EEPROM_EXPOSURE_ADDRESS, history);
+    bool commitSuccess = EEPROM.commit();
+
+    if (commitSuccess) {
+        Logger::debug("Exposure history saved.");
+    } else {
+        Logger::error("Saving exposure history failed");
+    }
+    return commitSuccess;
+}
+
+/**
+ * @brief Sets the band thresholds, normally to the alert thresholds.
+ *
+ * @param moderate The moderate threshold in ppm.
+ * @param critical The critical threshold in ppm.
+ * @return `true` if the thresholds were accepted, `false` if they are not ordered or not positive.
+ */
+bool ExposureAccumulator::setThresholds(float moderate, float critical) {
+    if (!(moderate > 0.0f && moderate < critical)) {
+        return false;
+    }
+    thresholds[EXPOSURE_MODERATE] = moderate;
+    thresholds[EXPOSURE_CRITICAL] = critical;
+    return true;
+}
+
+/**
+ * @brief Retrieves the threshold of a band.
+ *
+ * @param band The band.
+ * @return The threshold in ppm.
+ */
+float ExposureAccumulator::getThreshold(ExposureBand band) const {
+    return thresholds[band];
+}
+
+/**
+ * @brief Integrates the exposure since the previous sample.
+ *
+ * The segment between the previous and the current sample is added to the running hour
+ * and the running day. Gaps longer than `EXPOSURE_MAX_SAMPLE_GAP_MS` advance the clock
+ * but are not integrated, since nothing is known about the CO2 level in between.
+ *
+ * @param co2 The CO2 concentration in ppm.
+ * @param timestampMs The sample timestamp in ms (e.g. from `millis()`).
+ */
+void ExposureAccumulator::addSample(float co2, unsigned long timestampMs) {
+    if (!hasLastSample) {
+        hasLastSample = true;
+        lastCO2 = co2;
+        lastTimestamp = timestampMs;
+        return;
+    }
+
+    unsigned long elapsedMs = timestampMs - lastTimestamp;
+    if (elapsedMs <= EXPOSURE_MAX_SAMPLE_GAP_MS) {
+        float seconds = elapsedMs / 1000.0f;
+        ExposureTotals& hour = history.hours[history.currentHour];
+        ExposureTotals& day = history.days[history.currentDay];
+
+        for (int band = 0; band < EXPOSURE_BAND_COUNT; band++) {
+            float secondsAbove;
+            float ppmHours = integrateAbove(lastCO2, co2, seconds, thresholds[band], secondsAbove) / 3600.0f;
+            hour.ppmHours[band] += ppmHours;
+            hour.secondsAbove[band] += secondsAbove;
+            day.ppmHours[band] += ppmHours;
+            day.secondsAbove[band] += secondsAbove;
+        }
+    }
+
+    lastCO2 = co2;
+    lastTimestamp = timestampMs;
+    advanceClock(elapsedMs);
+}
+
+/**
+ * @brief Captures the running hour and day.
+ *
+ * @param state Receives the snapshot.
+ */
+void ExposureAccumulator::getRunningState(ExposureRunningState& state) const {
+    state.currentHour = history.currentHour;
+    state.currentDay = history.currentDay;
+    state.hoursInDay = history.hoursInDay;
+    state.hasLastSample = hasLastSample ? 1 : 0;
+    state.hourElapsedMs = history.hourElapsedMs;
+    state.hour = history.hours[history.currentHour];
+    state.day = history.days[history.currentDay];
+    state.lastCO2 = lastCO2;
+    state.lastTimestamp = lastTimestamp;
+}
+
+/**
+ * @brief Continues the running hour and day from a snapshot.
+ *
+ * Every rollover is saved to EEPROM, so a snapshot taken since then points at the same
+ * slots as the restored tables. A snapshot pointing elsewhere is stale and ignored.
+ *
+ * @param state The snapshot.
+ * @return `true` if the snapshot matched the restored tables and was applied.
+ */
+bool ExposureAccumulator::setRunningState(const ExposureRunningState& state) {
+    if (state.currentHour != history.currentHour || state.currentDay != history.currentDay ||
+        state.hoursInDay != history.hoursInDay) {
+        return false;
+    }
+
+    history.hourElapsedMs = state.hourElapsedMs;
+    history.hours[history.currentHour] = state.hour;
+    history.days[history.currentDay] = state.day;
+    hasLastSample = state.hasLastSample != 0;
+    lastCO2 = state.lastCO2;
+    lastTimestamp = state.lastTimestamp;
+    return true;
+}
+
+/**
+ * @brief Advances the operating clock and performs hour and day rollovers.
+ *
+ * Each completed hour and day is logged, and the tables are persisted once per rollover.
+ *
+ * @param elapsedMs Operating time since the previous sample in ms.
+ */
+void ExposureAccumulator::advanceClock(unsigned long elapsedMs) {
+    bool rolledOver = false;
+    history.hourElapsedMs += elapsedMs;
+
+    while (history.hourElapsedMs >= MS_PER_HOUR) {
+        history.hourElapsedMs -= MS_PER_HOUR;
+        logTotals("hour", history.hours[history.currentHour]);
+        history.currentHour = (history.currentHour + 1) % EXPOSURE_HOUR_COUNT;
+        memset(&history.hours[history.currentHour], 0, sizeof(ExposureTotals));
+
+        if (++history.hoursInDay >= HOURS_PER_DAY) {
+            history.hoursInDay = 0;
+            logTotals("day", history.days[history.currentDay]);
+            history.currentDay = (history.currentDay + 1) % EXPOSURE_DAY_COUNT;
+            memset(&history.days[history.currentDay], 0, sizeof(ExposureTotals));
+        }
+        rolledOver = true;
+    }
+
+    if (rolledOver) {
+        save();
+    }
+}
+
+/**
+ * @brief Computes the checksum of the history record.
+ *
+ * Uses FNV-1a over the raw bytes of the record.
+ *
+ * @return The checksum over all fields except `checksum` itself.
+ */
+uint32_t ExposureAccumulator::computeChecksum() const {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&history);
+    uint32_t hash = 2166136261UL;
+    for (size_t i = 0; i < offsetof(History, checksum); i++) {
+        hash ^= bytes[i];
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Clears all rollup tables.
+ */
+void ExposureAccumulator::clearHistory() {
+    memset(&history, 0, sizeof(history));
+    history.magic = EXPOSURE_MAGIC;
+}
+
+/**
+ * @brief Logs one rollup period.
+ *
+ * @param label The name of the period (e.g. "hour").
+ * @param totals The totals to log.
+ */
+void ExposureAccumulator::logTotals(const char* label, const ExposureTotals& totals) const {
+    if (!Logger::isEnabled(LOG_INFO)) {
+        return;
+    }
+    char buffer[112];
+    snprintf(buffer, sizeof(buffer),
+             "Exposure %s: >%.0f ppm %.2f ppm*h / %.1f min, >%.0f ppm %.2f ppm*h / %.1f min",
+             label,
+             thresholds[EXPOSURE_MODERATE], totals.ppmHours[EXPOSURE_MODERATE],
+             totals.secondsAbove[EXPOSURE_MODERATE] / 60.0f,
+             thresholds[EXPOSURE_CRITICAL], totals.ppmHours[EXPOSURE_CRITICAL],
+             totals.secondsAbove[EXPOSURE_CRITICAL] / 60.0f);
+    Logger::info(buffer);
+}
+
+/**
+ * @brief Retrieves an hourly rollup.
+ *
+ * @param hoursAgo 0 for the running hour, 1 for the previous hour, and so on.
+ * @return The totals of that hour.
+ */
+const ExposureTotals& ExposureAccumulator::getHour(uint8_t hoursAgo) const {
+    uint8_t index = (history.currentHour + EXPOSURE_HOUR_COUNT - hoursAgo % EXPOSURE_HOUR_COUNT) % EXPOSURE_HOUR_COUNT;
+    return history.hours[index];
+}
+
+/**
+ * @brief Retrieves a daily rollup.
+ *
+ * @param daysAgo 0 for the running day, 1 for the previous day, and so on.
+ * @return The totals of that day.
+ */
+const ExposureTotals& ExposureAccumulator::getDay(uint8_t daysAgo) const {
+    uint8_t index = (history.currentDay + EXPOSURE_DAY_COUNT - daysAgo % EXPOSURE_DAY_COUNT) % EXPOSURE_DAY_COUNT;
+    return history.days[index];
+}
+
+/**
+ * @brief Logs a single rollup.
+ *
+ * @param index 0 to `EXPOSURE_HOUR_COUNT` - 1 selects an hour (newest first), the
+ *              following `EXPOSURE_DAY_COUNT` indices select a day (newest first).
+ */
+void ExposureAccumulator::logEntry(uint8_t index) const {
+    char label[16];
+    if (index < EXPOSURE_HOUR_COUNT) {
+        snprintf(label, sizeof(label), "hour -%u", index);
+        logTotals(label, getHour(index));
+    } else if (index < EXPOSURE_HOUR_COUNT + EXPOSURE_DAY_COUNT) {
+        snprintf(label, sizeof(label), "day -%u", index - EXPOSURE_HOUR_COUNT);
+        logTotals(label, getDay(index - EXPOSURE_HOUR_COUNT));
+    }
+}
+
+/**
+ * @brief Logs all hourly and daily rollups, newest first.
+ */
+void ExposureAccumulator::logHistory() const {
+    for (uint8_t i = 0; i < EXPOSURE_HOUR_COUNT + EXPOSURE_DAY_COUNT; i++) {
+        logEntry(i);
+    }
+}
\ No newline at end of file
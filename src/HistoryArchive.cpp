@@ -0,0 +1,69 @@
+#include "HistoryArchive.h"
+
+/**
+ * @file HistoryArchive.cpp
+ * @brief Implements the ring of compressed history blocks.
+ */
+
+/**
+ * @brief Appends a sample, starting a new block if the current one is full.
+ *
+ * @param sample The sample to store.
+ */
+void HistoryArchive::append(const HistorySample& sample) {
+    if (!blocks[newest].append(sample)) {
+        newest = (newest + 1) % HISTORY_ARCHIVE_BLOCKS;
+        if (count < HISTORY_ARCHIVE_BLOCKS) {
+            count++;
+        }
+        blocks[newest].reset();
+        blocks[newest].append(sample);
+    }
+    samples++;
+}
+
+/**
+ * @brief Retrieves the number of blocks in use.
+ */
+uint8_t HistoryArchive::getBlockCount() const {
+    return count;
+}
+
+/**
+ * @brief Retrieves a block.
+ *
+ * @param index 0 for the oldest block up to `getBlockCount()` - 1 for the newest.
+ * @return The block.
+ */
+const HistoryEncoder& HistoryArchive::getBlock(uint8_t index) const {
+    return blocks[(newest + HISTORY_ARCHIVE_BLOCKS + 1 - count + index) % HISTORY_ARCHIVE_BLOCKS];
+}
+
+/**
+ * @brief Retrieves the number of samples appended since start.
+ */
+uint32_t HistoryArchive::getTotalSamples() const {
+    return samples;
+}
+
+/**
+ * @brief Retrieves the number of samples currently held.
+ */
+uint32_t HistoryArchive::getStoredSamples() const {
+    uint32_t stored = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        stored += getBlock(i).getSampleCount();
+    }
+    return stored;
+}
+
+/**
+ * @brief Retrieves the number of encoded bytes currently held.
+ */
+uint32_t HistoryArchive::getStoredBytes() const {
+    uint32_t bytes = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        bytes += getBlock(i).getSize();
+    }
+    return bytes;
+}
\ No newline at end of file
@@ -0,0 +1,441 @@
+#include "HistoryCodec.h"
+#include <string.h>
+
+/**
+ * @file HistoryCodec.cpp
+ * @brief Implements the history block codec.
+ */
+
+#define WIDTH_CLASS_ESCAPE 4 ///< Class storing the full 32-bit value instead of a difference
+
+// Payload widths of the prefix classes '0', '10', '110', '1110'; '1111' escapes to 32 bits.
+// Timestamp classes as in Gorilla; value classes sized for the noise of the sensors in
+// hundredths (temperature ~5, humidity and pressure ~30, CO2 ~1000).
+static const uint8_t TIMESTAMP_WIDTHS[WIDTH_CLASS_ESCAPE] = { 0, 7, 9, 12 };
+static const uint8_t VALUE_WIDTHS[WIDTH_CLASS_ESCAPE] = { 0, 4, 8, 12 };
+
+/**
+ * @brief Maps a signed difference to an unsigned number with small magnitudes first.
+ */
+static inline uint64_t zigzagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+/**
+ * @brief Inverts `zigzagEncode()`.
+ */
+static inline int64_t zigzagDecode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/**
+ * @brief Selects the smallest width class that holds a zigzag-encoded difference.
+ *
+ * @return The class (0-3), or `WIDTH_CLASS_ESCAPE` if the difference needs a full value.
+ */
+static inline uint8_t widthClass(uint64_t zigzag, const uint8_t widths[WIDTH_CLASS_ESCAPE]) {
+    for (uint8_t i = 0; i < WIDTH_CLASS_ESCAPE; i++) {
+        if (zigzag < (1ULL << widths[i])) {
+            return i;
+        }
+    }
+    return WIDTH_CLASS_ESCAPE;
+}
+
+/**
+ * @brief Number of bits used by a class including its prefix.
+ */
+static inline uint8_t classBits(uint8_t widthClass, const uint8_t widths[WIDTH_CLASS_ESCAPE]) {
+    return widthClass == WIDTH_CLASS_ESCAPE ? WIDTH_CLASS_ESCAPE + 32 : widthClass + 1 + widths[widthClass];
+}
+
+/**
+ * @brief Converts a reading to the integer representation stored in the block.
+ *
+ * Out-of-range values are clamped so that differences always fit into 32 bits.
+ *
+ * @param value The reading.
+ * @return The reading in steps of 1/`HISTORY_VALUE_RESOLUTION`; NaN maps to 0.
+ */
+int32_t quantizeReading(float value) {
+    if (value != value) {
+        return 0; // NaN
+    }
+    float scaled = value * HISTORY_VALUE_RESOLUTION;
+    if (scaled > 1e9f) {
+        return 1000000000;
+    }
+    if (scaled < -1e9f) {
+        return -1000000000;
+    }
+    return static_cast<int32_t>(scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f);
+}
+
+/**
+ * @brief Constructs an empty block.
+ */
+HistoryEncoder::HistoryEncoder() {
+    reset();
+}
+
+/**
+ * @brief Discards the block contents.
+ */
+void HistoryEncoder::reset() {
+    memset(buffer, 0, sizeof(buffer));
+    buffer[0] = HISTORY_FORMAT_VERSION;
+    buffer[1] = HISTORY_CHANNEL_COUNT;
+    bitPosition = HISTORY_HEADER_BYTES * 8;
+    sampleCount = 0;
+    lastTimestamp = 0;
+    lastDelta = 0;
+    memset(lastValues, 0, sizeof(lastValues));
+}
+
+/**
+ * @brief Appends the lowest bits of a value, most significant bit first.
+ *
+ * The buffer is zeroed on reset, so bits are ORed in up to one byte at a time.
+ *
+ * @param value The bits to write.
+ * @param count The number of bits (at most 32).
+ */
+void HistoryEncoder::writeBits(uint32_t value, uint8_t count) {
+    while (count > 0) {
+        uint8_t free = 8 - (bitPosition & 7);
+        uint8_t take = count < free ? count : free;
+        uint8_t bits = static_cast<uint8_t>((value >> (count - take)) & ((1U << take) - 1));
+        buffer[bitPosition >> 3] |= static_cast<uint8_t>(bits << (free - take));
+        bitPosition += take;
+        count -= take;
+    }
+}
+
+/**
+ * @brief Appends a sample if it fits into the block.
+ *
+ * The size of the encoded sample is computed before anything is written, so a sample
+ * that does not fit leaves the block unchanged.
+ *
+ * @param sample The sample to encode.
+ * @return `true` if the sample was added, `false` if the block is full.
+ */
+bool HistoryEncoder::append(const HistorySample& sample) {
+    int32_t values[HISTORY_CHANNEL_COUNT];
+    for (int i = 0; i < HISTORY_CHANNEL_COUNT; i++) {
+        values[i] = quantizeReading(sample.values[i]);
+    }
+
+    if (sampleCount == 0) {
+        if (bitPosition + 32 * (1 + HISTORY_CHANNEL_COUNT) > sizeof(buffer) * 8) {
+            return false;
+        }
+        writeBits(sample.timestampMs, 32);
+        for (int i = 0; i < HISTORY_CHANNEL_COUNT; i++) {
+            writeBits(static_cast<uint32_t>(values[i]), 32);
+        }
+        lastDelta = 0;
+    } else {
+        uint32_t delta = sample.timestampMs - lastTimestamp;
+        uint64_t timestampZigzag = zigzagEncode(static_cast<int64_t>(delta) - lastDelta);
+        uint8_t timestampClass = widthClass(timestampZigzag, TIMESTAMP_WIDTHS);
+        size_t bits = classBits(timestampClass, TIMESTAMP_WIDTHS);
+
+        uint64_t valueZigzags[HISTORY_CHANNEL_COUNT];
+        uint8_t valueClasses[HISTORY_CHANNEL_COUNT];
+        for (int i = 0; i < HISTORY_CHANNEL_COUNT; i++) {
+            valueZigzags[i] = zigzagEncode(static_cast<int64_t>(values[i]) - lastValues[i]);
+            valueClasses[i] = widthClass(valueZigzags[i], VALUE_WIDTHS);
+            bits += classBits(valueClasses[i], VALUE_WIDTHS);
+        }
+        if (bitPosition + bits > sizeof(buffer) * 8) {
+            return false;
+        }
+
+        if (timestampClass == WIDTH_CLASS_ESCAPE) {
+            writeBits(0x0F, WIDTH_CLASS_ESCAPE);
+            writeBits(delta, 32);
+        } else {
+            writeBits(((1U << timestampClass) - 1) << 1, timestampClass + 1);
+            writeBits(static_cast<uint32_t>(timestampZigzag), TIMESTAMP_WIDTHS[timestampClass]);
+        }
+        for (int i = 0; i < HISTORY_CHANNEL_COUNT; i++) {
+            if (valueClasses[i] == WIDTH_CLASS_ESCAPE) {
+                writeBits(0x0F, WIDTH_CLASS_ESCAPE);
+                writeBits(static_cast<uint32_t>(values[i]), 32);
+            } else {
+                writeBits(((1U << valueClasses[i]) - 1) << 1, valueClasses[i] + 1);
+                writeBits(static_cast<uint32_t>(valueZigzags[i]), VALUE_WIDTHS[valueClasses[i]]);
+            }
+        }
+        lastDelta = delta;
+    }
+
+    lastTimestamp = sample.timestampMs;
+    memcpy(lastValues, values, sizeof(lastValues));
+    sampleCount++;
+    buffer[2] = static_cast<uint8_t>(sampleCount & 0xFF);
+    buffer[3] = static_cast<uint8_t>(sampleCount >> 8);
+    return true;
+}
+
+/**
+ * @brief Retrieves the encoded block.
+ */
+const uint8_t* HistoryEncoder::getData() const {
+    return buffer;
+}
+
+/**
+ * @brief Retrieves the size of the encoded block in bytes.
+ */
+size_t HistoryEncoder::getSize() const {
+    return (bitPosition + 7) / 8;
+}
+
+/**
+ * @brief Retrieves the number of samples in the block.
+ */
+uint16_t HistoryEncoder::getSampleCount() const {
+    return sampleCount;
+}
+
+/**
+ * @brief Reads bits, most significant bit first.
+ *
+ * @param count The number of bits (at most 32).
+ * @param value Receives the bits.
+ * @return `true` on success, `false` if the block ends early.
+ */
+bool HistoryDecoder::readBits(uint8_t count, uint32_t& value) {
+    if (bitPosition + count > size * 8) {
+        return false;
+    }
+    value = 0;
+    while (count > 0) {
+        uint8_t available = 8 - (bitPosition & 7);
+        uint8_t take = count < available ? count : available;
+        uint8_t bits = static_cast<uint8_t>(data[bitPosition >> 3] >> (available - take)) & ((1U << take) - 1);
+        value = (value << take) | bits;
+        bitPosition += take;
+        count -= take;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads a width class prefix ('0', '10', '110', '1110' or '1111').
+ *
+ * @param widthClass Receives the class (0-4).
+ * @return `true` on success, `false` if the block ends early.
+ */
+bool HistoryDecoder::readClass(uint8_t& widthClass) {
+    widthClass = 0;
+    uint32_t bit;
+    while (widthClass < WIDTH_CLASS_ESCAPE) {
+        if (!readBits(1, bit)) {
+            return false;
+        }
+        if (bit == 0) {
+            break;
+        }
+        widthClass++;
+    }
+    return true;
+}
+
+/**
+ * @brief Starts decoding a block.
+ *
+ * @param data The block.
+ * @param size The size of the block in bytes.
+ * @return `true` if the header is valid, `false` otherwise.
+ */
+bool HistoryDecoder::begin(const uint8_t* data, size_t size) {
+    this->data = data;
+    this->size = size;
+    bitPosition = HISTORY_HEADER_BYTES * 8;
+    decoded = 0;
+    sampleCount = 0;
+    if (size < HISTORY_HEADER_BYTES || data[0] != HISTORY_FORMAT_VERSION || data[1] != HISTORY_CHANNEL_COUNT) {
+        return false;
+    }
+    sampleCount = static_cast<uint16_t>(data[2] | (data[3] << 8));
+    return true;
+}
+
+/**
+ * @brief Decodes the next sample.
+ *
+ * @param sample Receives the sample.
+ * @return `true` on success, `false` at the end of the block or if it is corrupt.
+ */
+bool HistoryDecoder::next(HistorySample& sample) {
+    if (decoded >= sampleCount) {
+        return false;
+    }
+
+    uint32_t bits;
+    if (decoded == 0) {
+        if (!readBits(32, bits)) {
+            return false;
+        }
+        lastTimestamp = bits;
+        lastDelta = 0;
+        for (int i = 0; i < HISTORY_CHANNEL_COUNT; i++) {
+            if (!readBits(32, bits)) {
+                return false;
+            }
+            lastValues[i] = static_cast<int32_t>(bits);
+        }
+    } else {
+        uint8_t widthClass;
+        if (!readClass(widthClass)) {
+            return false;
+        }
+        uint32_t delta = lastDelta;
+        if (widthClass == WIDTH_CLASS_ESCAPE) {
+            if (!readBits(32, delta)) {
+                return false;
+            }
+        } else if (widthClass > 0) {
+            if (!readBits(TIMESTAMP_WIDTHS[widthClass], bits)) {
+                return false;
+            }
+            delta = static_cast<uint32_t>(lastDelta + zigzagDecode(bits));
+        }
+        lastTimestamp += delta;
+        lastDelta = delta;
+
+        for (int i = 0; i < HISTORY_CHANNEL_COUNT; i++) {
+            if (!readClass(widthClass)) {
+                return false;
+            }
+            if (widthClass == WIDTH_CLASS_ESCAPE) {
+                if (!readBits(32, bits)) {
+                    return false;
+                }
+                lastValues[i] = static_cast<int32_t>(bits);
+            } else if (widthClass > 0) {
+                if (!readBits(VALUE_WIDTHS[widthClass], bits)) {
+                    return false;
+                }
+                lastValues[i] = static_cast<int32_t>(lastValues[i] + zigzagDecode(bits));
+            }
+        }
+    }
+
+    sample.timestampMs = lastTimestamp;
+    for (int i = 0; i < HISTORY_CHANNEL_COUNT; i++) {
+        sample.values[i] = static_cast<float>(lastValues[i]) / HISTORY_VALUE_RESOLUTION;
+    }
+    decoded++;
+    return true;
+}
+
+/**
+ * @brief Retrieves the number of samples announced by the block header.
+ */
+uint16_t HistoryDecoder::getSampleCount() const {
+    return sampleCount;
+}
+
+static const char BASE64_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/**
+ * @brief Encodes binary data as base64 text.
+ *
+ * @param data The data.
+ * @param size The size of the data in bytes.
+ * @param out Receives the NUL-terminated text.
+ * @param outSize The size of `out`; at least `4 * ((size + 2) / 3) + 1` bytes.
+ * @return The length of the text, or 0 if `out` is too small.
+ */
+size_t encodeBase64(const uint8_t* data, size_t size, char* out, size_t outSize) {
+    size_t length = 4 * ((size + 2) / 3);
+    if (outSize < length + 1) {
+        return 0;
+    }
+
+    char* cursor = out;
+    for (size_t i = 0; i < size; i += 3) {
+        uint32_t group = static_cast<uint32_t>(data[i]) << 16;
+        if (i + 1 < size) {
+            group |= static_cast<uint32_t>(data[i + 1]) << 8;
+        }
+        if (i + 2 < size) {
+            group |= data[i + 2];
+        }
+        *cursor++ = BASE64_ALPHABET[(group >> 18) & 0x3F];
+        *cursor++ = BASE64_ALPHABET[(group >> 12) & 0x3F];
+        *cursor++ = i + 1 < size ? BASE64_ALPHABET[(group >> 6) & 0x3F] : '=';
+        *cursor++ = i + 2 < size ? BASE64_ALPHABET[group & 0x3F] : '=';
+    }
+    *cursor = '\0';
+    return length;
+}
+
+/**
+ * @brief Maps a base64 character to its 6-bit value.
+ *
+ * @return The value, or -1 for characters outside the alphabet.
+ */
+static int base64Value(char c) {
+    if (c >= 'A' && c <= 'Z') {
+        return c - 'A';
+    }
+    if (c >= 'a' && c <= 'z') {
+        return c - 'a' + 26;
+    }
+    if (c >= '0' && c <= '9') {
+        return c - '0' + 52;
+    }
+    if (c == '+') {
+        return 62;
+    }
+    if (c == '/') {
+        return 63;
+    }
+    return -1;
+}
+
+/**
+ * @brief Decodes base64 text.
+ *
+ * @param text The text.
+ * @param length The length of the text.
+ * @param out Receives the data.
+ * @param outSize The size of `out` in bytes.
+ * @return The size of the data in bytes, or 0 if the text is invalid or `out` is too small.
+ */
+size_t decodeBase64(const char* text, size_t length, uint8_t* out, size_t outSize) {
+    if (length % 4 != 0) {
+        return 0;
+    }
+
+    size_t size = 0;
+    for (size_t i = 0; i < length; i += 4) {
+        int padding = 0;
+        uint32_t group = 0;
+        for (size_t j = 0; j < 4; j++) {
+            char c = text[i + j];
+            int value = base64Value(c);
+            if (c == '=' && i + 4 == length && j >= 2) {
+                value = 0;
+                padding++;
+            } else if (value < 0 || padding > 0) {
+                return 0;
+            }
+            group = (group << 6) | static_cast<uint32_t>(value);
+        }
+
+        size_t bytes = 3 - padding;
+        if (size + bytes > outSize) {
+            return 0;
+        }
+        for (size_t j = 0; j < bytes; j++) {
+            out[size++] = static_cast<uint8_t>(group >> (16 - 8 * j));
+        }
+    }
+    return size;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "HttpRequestScanner.h"
+#include <string.h>
+
+/**
+ * @file HttpRequestScanner.cpp
+ * @brief Implements the incremental HTTP request scanner.
+ */
+
+/**
+ * @brief Prepares for a new request.
+ */
+void HttpRequestScanner::reset() {
+    lineLength = 0;
+    total = 0;
+    lineComplete = false;
+    lineOverflow = false;
+    atLineStart = false;
+}
+
+/**
+ * @brief Consumes one byte of the request.
+ *
+ * The request ends with an empty line; CR characters are ignored so bare LF line
+ * endings are accepted as well.
+ *
+ * @param c The byte.
+ * @return `HTTP_PENDING` until the headers end, then the classification.
+ */
+HttpRequestTarget HttpRequestScanner::feed(char c) {
+    if (++total > HTTP_MAX_REQUEST_BYTES) {
+        return HTTP_BAD_REQUEST;
+    }
+    if (c == '\r') {
+        return HTTP_PENDING;
+    }
+
+    if (!lineComplete) {
+        if (c == '\n') {
+            lineComplete = true;
+            atLineStart = true;
+            requestLine[lineLength] = '\0';
+        } else if (lineLength < sizeof(requestLine) - 1) {
+            requestLine[lineLength++] = c;
+        } else {
+            lineOverflow = true;
+        }
+        return HTTP_PENDING;
+    }
+
+    if (c == '\n') {
+        if (atLineStart) {
+            return classify();
+        }
+        atLineStart = true;
+    } else {
+        atLineStart = false;
+    }
+    return HTTP_PENDING;
+}
+
+/**
+ * @brief Classifies the complete request line.
+ *
+ * Accepts `GET /metrics` with an optional query string; other GET requests are answered
+ * with 404 and anything else with 400.
+ */
+HttpRequestTarget HttpRequestScanner::classify() {
+    if (lineOverflow || strncmp(requestLine, "GET ", 4) != 0) {
+        return HTTP_BAD_REQUEST;
+    }
+
+    const char* target = requestLine + 4;
+    size_t targetLength = strcspn(target, " ");
+    if (target[targetLength] != ' ' || strncmp(target + targetLength + 1, "HTTP/1.", 7) != 0) {
+        return HTTP_BAD_REQUEST;
+    }
+
+    size_t pathLength = strcspn(target, "? ");
+    if (pathLength == 8 && strncmp(target, "/metrics", 8) == 0) {
+        return HTTP_METRICS;
+    }
+    return HTTP_NOT_FOUND;
+}
\ No newline at end of file
@@ -0,0 +1,247 @@
+#include "MeasurementPipeline.h"
+#include <Arduino.h>
+#include <stdio.h>
+#include "BuildProfile.h"
+#include "Logger.h"
+#include "MeterPages.h"
+
+/**
+ * @file MeasurementPipeline.cpp
+ * @brief Implements the per-sample processing path.
+ */
+
+static const char* const STAGE_NAMES[STAGE_COUNT] = { "poll", "read", "process", "alert", "display" };
+
+/**
+ * @brief Constructs the pipeline.
+ *
+ * @param sensorManager The source of the readings.
+ * @param sensorFilter The CO2 and temperature filter.
+ * @param pressureCompensator The ambient pressure compensator.
+ * @param exposureAccumulator The exposure accumulator.
+ * @param ventilationEstimator The ventilation estimator.
+ * @param alertMonitor The alert monitor.
+ * @param pageManager The page manager, e.g. showing the `MeterPages`.
+ * @param displayModel The values shown by the pages.
+ * @param traceRecorder The recorder of the raw stream.
+ */
+MeasurementPipeline::MeasurementPipeline(SensorManager& sensorManager, SensorFilter& sensorFilter,
+                                         PressureCompensator& pressureCompensator,
+                                         ExposureAccumulator& exposureAccumulator,
+                                         VentilationEstimator& ventilationEstimator, AlertMonitor& alertMonitor,
+                                         PageManager& pageManager, DisplayModel& displayModel,
+                                         TraceRecorder& traceRecorder)
+    : sensorManager(sensorManager), sensorFilter(sensorFilter), pressureCompensator(pressureCompensator),
+      exposureAccumulator(exposureAccumulator), ventilationEstimator(ventilationEstimator),
+      alertMonitor(alertMonitor), pageManager(pageManager), displayModel(displayModel),
+      traceRecorder(traceRecorder) {}
+
+/**
+ * @brief Adds one run to the statistics of a stage.
+ *
+ * @param stage The stage.
+ * @param startUs `micros()` at the start of the run.
+ * @return `micros()` at the end of the run, i.e. the start of the next stage.
+ */
+uint32_t MeasurementPipeline::endStage(PipelineStage stage, uint32_t startUs) {
+    uint32_t endUs = micros();
+    PipelineStageTiming& stageTiming = timing[stage];
+    stageTiming.lastUs = endUs - startUs;
+    if (stageTiming.lastUs > stageTiming.maxUs) {
+        stageTiming.maxUs = stageTiming.lastUs;
+    }
+    stageTiming.count++;
+    stageTiming.totalUs += stageTiming.lastUs;
+    return endUs;
+}
+
+/**
+ * @brief Polls the sensors and processes a sample if one is ready.
+ *
+ * @param now The current time in ms.
+ * @return `true` if a sample was processed, `false` if no data was available.
+ */
+bool MeasurementPipeline::poll(unsigned long now) {
+    uint32_t stageStart = micros();
+    bool available = sensorManager.isDataAvailable();
+    stageStart = endStage(STAGE_POLL, stageStart);
+
+    TraceEvent event = {};
+    event.timestampMs = now;
+    event.pollMicros = timing[STAGE_POLL].lastUs;
+    if (!available) {
+        Logger::debug("Sensor data not available.");
+        event.type = TRACE_POLL_EMPTY;
+        if constexpr (ACTIVE_PROFILE.traceRecorder) {
+            traceRecorder.record(event);
+        }
+        return false;
+    }
+    Logger::debug("Sensor data is available.");
+
+    // Retrieve sensor readings
+    float co2 = sensorManager.getCO2();
+    float temperatureSCD = sensorManager.getTemperatureSCD();
+    float humidity = sensorManager.getHumidity();
+    float temperatureBMP = sensorManager.getTemperatureBMP();
+    float pressure = sensorManager.getPressure();
+    stageStart = endStage(STAGE_READ, stageStart);
+
+    readings.raw = { static_cast<uint32_t>(now), { co2, temperatureSCD, temperatureBMP, humidity, pressure } };
+    if constexpr (ACTIVE_PROFILE.traceRecorder) {
+        event.type = TRACE_SAMPLE;
+        for (int i = 0; i < HISTORY_CHANNEL_COUNT; i++) {
+            event.values[i] = readings.raw.values[i];
+        }
+        traceRecorder.record(event);
+    }
+
+    char buffer[64];
+    Logger::debug("Sensor readings retrieved.");
+    if (Logger::isEnabled(LOG_INFO)) {
+        snprintf(buffer, sizeof(buffer), "CO2: %.2f ppm", co2);
+        Logger::info(buffer);
+        snprintf(buffer, sizeof(buffer), "Temperature (SCD30): %.2f °C", temperatureSCD);
+        Logger::info(buffer);
+        snprintf(buffer, sizeof(buffer), "Temperature (BMP280): %.2f °C", temperatureBMP);
+        Logger::info(buffer);
+        snprintf(buffer, sizeof(buffer), "Humidity: %.2f %%", humidity);
+        Logger::info(buffer);
+        snprintf(buffer, sizeof(buffer), "Pressure: %.2f hPa", pressure);
+        Logger::info(buffer);
+    }
+
+    // Consumers use the filtered CO2 and the self-heating compensated SCD30 temperature
+    sensorFilter.update(co2, temperatureSCD, temperatureBMP);
+    readings.co2 = sensorFilter.getCO2();
+    readings.temperatureSCD = sensorFilter.compensateTemperatureSCD(temperatureSCD);
+    if (Logger::isEnabled(LOG_DEBUG)) {
+        snprintf(buffer, sizeof(buffer), "CO2 (filtered): %.2f ppm", readings.co2);
+        Logger::debug(buffer);
+        snprintf(buffer, sizeof(buffer), "Temperature (fused): %.2f °C", sensorFilter.getTemperature());
+        Logger::debug(buffer);
+    }
+
+    if (pressureCompensator.update(pressure, now)) {
+        pressureCompensator.logStatistics();
+    }
+    exposureAccumulator.addSample(readings.co2, now);
+
+    // Feed the decay detector with the raw signal, which it fits itself
+    bool ventilationCompleted = ventilationEstimator.addSample(co2, now);
+    stageStart = endStage(STAGE_PROCESS, stageStart);
+
+    AlertLevel previousLevel = readings.alertLevel;
+    readings.alertLevel = alertMonitor.evaluate(readings.co2);
+    stageStart = endStage(STAGE_ALERT, stageStart);
+
+    updateDisplay(now, previousLevel, ventilationCompleted);
+    endStage(STAGE_DISPLAY, stageStart);
+    return true;
+}
+
+/**
+ * @brief Copies the sample into the display model and selects the page.
+ *
+ * Only the input groups whose values changed are invalidated, so the page manager skips
+ * the render when the visible page shows nothing new. An alert onset or escalation brings
+ * up the alert page until the alert clears; a completed ventilation episode shows its
+ * result for `VENTILATION_PAGE_DURATION_MS` unless an alert is active.
+ *
+ * @param now The sample time in ms.
+ * @param previousLevel The alert level of the previous sample.
+ * @param ventilationCompleted Whether the sample completed a ventilation episode.
+ */
+void MeasurementPipeline::updateDisplay(unsigned long now, AlertLevel previousLevel, bool ventilationCompleted) {
+    const float* raw = readings.raw.values;
+    DisplayModel& model = displayModel;
+    if (model.co2 != readings.co2 || model.temperatureSCD != readings.temperatureSCD ||
+        model.temperatureBMP != raw[HISTORY_TEMP_BMP] || model.humidity != raw[HISTORY_HUMIDITY] ||
+        model.pressure != raw[HISTORY_PRESSURE]) {
+        model.co2 = readings.co2;
+        model.temperatureSCD = readings.temperatureSCD;
+        model.temperatureBMP = raw[HISTORY_TEMP_BMP];
+        model.humidity = raw[HISTORY_HUMIDITY];
+        model.pressure = raw[HISTORY_PRESSURE];
+        pageManager.invalidate(INPUT_READINGS);
+    }
+    if (model.alertLevel != readings.alertLevel) {
+        model.alertLevel = readings.alertLevel;
+        pageManager.invalidate(INPUT_ALERT);
+    }
+
+    const ExposureTotals& today = exposureAccumulator.getDay();
+    float moderateMinutes = today.secondsAbove[EXPOSURE_MODERATE] / 60.0f;
+    float criticalMinutes = today.secondsAbove[EXPOSURE_CRITICAL] / 60.0f;
+    float moderateThreshold = exposureAccumulator.getThreshold(EXPOSURE_MODERATE);
+    float criticalThreshold = exposureAccumulator.getThreshold(EXPOSURE_CRITICAL);
+    if (model.moderatePpmHours != today.ppmHours[EXPOSURE_MODERATE] || model.moderateMinutes != moderateMinutes ||
+        model.criticalPpmHours != today.ppmHours[EXPOSURE_CRITICAL] || model.criticalMinutes != criticalMinutes ||
+        model.moderateThreshold != moderateThreshold || model.criticalThreshold != criticalThreshold) {
+        model.moderateThreshold = moderateThreshold;
+        model.criticalThreshold = criticalThreshold;
+        model.moderatePpmHours = today.ppmHours[EXPOSURE_MODERATE];
+        model.moderateMinutes = moderateMinutes;
+        model.criticalPpmHours = today.ppmHours[EXPOSURE_CRITICAL];
+        model.criticalMinutes = criticalMinutes;
+        pageManager.invalidate(INPUT_EXPOSURE);
+    }
+
+    if (ventilationCompleted) {
+        model.ventilationAvailable = true;
+        model.airChangesPerHour = ventilationEstimator.getLastAirChangeRate();
+        model.fitQuality = ventilationEstimator.getLastFitQuality();
+        model.episodeMinutes = ventilationEstimator.getLastEpisodeMinutes();
+        pageManager.invalidate(INPUT_VENTILATION);
+    }
+
+    if (readings.alertLevel == ALERT_CRITICAL) {
+        Logger::warning("CRITICAL: High CO2 levels!");
+    } else if (readings.alertLevel == ALERT_MODERATE) {
+        Logger::warning("MODERATE: Elevated CO2 levels!");
+    }
+
+    if (readings.alertLevel > previousLevel) {
+        pageManager.show(PAGE_ALERT, now, 0);
+    } else if (readings.alertLevel == ALERT_NONE && previousLevel != ALERT_NONE) {
+        pageManager.release(PAGE_OVERVIEW, now);
+    } else if (ventilationCompleted && readings.alertLevel == ALERT_NONE) {
+        pageManager.show(PAGE_VENTILATION, now, VENTILATION_PAGE_DURATION_MS);
+    }
+    pageManager.update(now);
+}
+
+/**
+ * @brief Retrieves the results of the last processed sample.
+ */
+const PipelineReadings& MeasurementPipeline::getReadings() const {
+    return readings;
+}
+
+/**
+ * @brief Retrieves the timing statistics of a stage.
+ *
+ * @param stage The stage.
+ */
+const PipelineStageTiming& MeasurementPipeline::getTiming(PipelineStage stage) const {
+    return timing[stage];
+}
+
+/**
+ * @brief Clears the timing statistics.
+ */
+void MeasurementPipeline::resetTiming() {
+    for (PipelineStageTiming& stageTiming : timing) {
+        stageTiming = {};
+    }
+}
+
+/**
+ * @brief Retrieves the name of a stage.
+ *
+ * @param stage The stage.
+ * @return A short lower-case name.
+ */
+const char* MeasurementPipeline::getStageName(PipelineStage stage) {
+    return STAGE_NAMES[stage];
+}
@@ -0,0 +1,360 @@
+#include "MeterPages.h"
+#include <stdio.h>
+#include "config.h"
+
+/**
+ * @file MeterPages.cpp
+ * @brief Implements the pages of the CO2 meter.
+ */
+
+static const int ROW_SPACING = 10; ///< Distance between two small text rows in pixels
+static const int FIRST_ROW = 17; ///< First small text row below a headline
+
+/**
+ * @brief Retrieves the short name of an alert level.
+ */
+static const char* alertName(AlertLevel level) {
+    switch (level) {
+    case ALERT_CRITICAL:
+        return "CRITICAL";
+    case ALERT_MODERATE:
+        return "HIGH";
+    default:
+        return "OK";
+    }
+}
+
+/**
+ * @brief Constructs the overview page.
+ *
+ * @param model The values shown.
+ */
+OverviewPage::OverviewPage(const DisplayModel& model) : model(model) {}
+
+/**
+ * @brief The page shows the readings and the alert state.
+ */
+uint8_t OverviewPage::getInputs() const {
+    return INPUT_READINGS | INPUT_ALERT;
+}
+
+/**
+ * @brief Draws the label and unit of the CO2 value.
+ *
+ * @param display The display to draw on.
+ */
+void OverviewPage::drawBackground(DisplayManager& display) {
+    display.drawText(0, 0, FONT_SIZE_SMALL, "CO2");
+    display.drawTextRight(0, FONT_SIZE_SMALL, "ppm");
+}
+
+/**
+ * @brief Draws the CO2 value, the alert state, temperature and humidity.
+ *
+ * @param display The display to draw on.
+ */
+void OverviewPage::drawContent(DisplayManager& display, unsigned long) {
+    char buffer[24];
+    snprintf(buffer, sizeof(buffer), "%.0f", model.co2);
+    display.drawTextCentered(12, FONT_SIZE_HUGE, buffer);
+
+    display.drawText(0, SCREEN_HEIGHT - 8, FONT_SIZE_SMALL, alertName(model.alertLevel));
+    snprintf(buffer, sizeof(buffer), "%.1f C %.0f %%", model.temperatureSCD, model.humidity);
+    display.drawTextRight(SCREEN_HEIGHT - 8, FONT_SIZE_SMALL, buffer);
+}
+
+/**
+ * @brief Constructs the detail page.
+ *
+ * @param model The values shown.
+ */
+DetailPage::DetailPage(const DisplayModel& model) : model(model) {}
+
+/**
+ * @brief The page shows the readings.
+ */
+uint8_t DetailPage::getInputs() const {
+    return INPUT_READINGS;
+}
+
+/**
+ * @brief Draws the headline and the labels of the readings.
+ *
+ * @param display The display to draw on.
+ */
+void DetailPage::drawBackground(DisplayManager& display) {
+    display.drawHeadline("CO2 Meter");
+    display.drawText(0, FIRST_ROW, FONT_SIZE_SMALL, "CO2:");
+    display.drawText(0, FIRST_ROW + ROW_SPACING, FONT_SIZE_SMALL, "T (SCD30):");
+    display.drawText(0, FIRST_ROW + 2 * ROW_SPACING, FONT_SIZE_SMALL, "T (BMP280):");
+    display.drawText(0, FIRST_ROW + 3 * ROW_SPACING, FONT_SIZE_SMALL, "Humidity:");
+    display.drawText(0, FIRST_ROW + 4 * ROW_SPACING, FONT_SIZE_SMALL, "Pressure:");
+}
+
+/**
+ * @brief Draws the readings aligned to the right edge.
+ *
+ * @param display The display to draw on.
+ */
+void DetailPage::drawContent(DisplayManager& display, unsigned long) {
+    auto printValue = [&](float value, const char* unit, int row) {
+        char buffer[16];
+        snprintf(buffer, sizeof(buffer), "%.2f %s", value, unit);
+        display.drawTextRight(row, FONT_SIZE_SMALL, buffer);
+    };
+
+    printValue(model.co2, "ppm", FIRST_ROW);
+    printValue(model.temperatureSCD, "C", FIRST_ROW + ROW_SPACING);
+    printValue(model.temperatureBMP, "C", FIRST_ROW + 2 * ROW_SPACING);
+    printValue(model.humidity, "%", FIRST_ROW + 3 * ROW_SPACING);
+    printValue(model.pressure, "hPa", FIRST_ROW + 4 * ROW_SPACING);
+}
+
+/**
+ * @brief Constructs the exposure page.
+ *
+ * @param model The values shown.
+ */
+ExposurePage::ExposurePage(const DisplayModel& model) : model(model) {}
+
+/**
+ * @brief The page shows the exposure totals.
+ */
+uint8_t ExposurePage::getInputs() const {
+    return INPUT_EXPOSURE;
+}
+
+/**
+ * @brief Draws the headline.
+ *
+ * @param display The display to draw on.
+ */
+void ExposurePage::drawBackground(DisplayManager& display) {
+    display.drawHeadline("Today");
+}
+
+/**
+ * @brief Draws the thresholds and the time and exposure above each of them.
+ *
+ * The thresholds are content since the console can change them.
+ *
+ * @param display The display to draw on.
+ */
+void ExposurePage::drawContent(DisplayManager& display, unsigned long) {
+    char buffer[24];
+    snprintf(buffer, sizeof(buffer), ">%.0f ppm:", model.moderateThreshold);
+    display.drawText(0, 17, FONT_SIZE_SMALL, buffer);
+    snprintf(buffer, sizeof(buffer), ">%.0f ppm:", model.criticalThreshold);
+    display.drawText(0, 41, FONT_SIZE_SMALL, buffer);
+    snprintf(buffer, sizeof(buffer), " %.0f min %.1f ppmh", model.moderateMinutes, model.moderatePpmHours);
+    display.drawText(0, 27, FONT_SIZE_SMALL, buffer);
+    snprintf(buffer, sizeof(buffer), " %.0f min %.1f ppmh", model.criticalMinutes, model.criticalPpmHours);
+    display.drawText(0, 51, FONT_SIZE_SMALL, buffer);
+}
+
+/**
+ * @brief Constructs the ventilation page.
+ *
+ * @param model The values shown.
+ */
+VentilationPage::VentilationPage(const DisplayModel& model) : model(model) {}
+
+/**
+ * @brief The page shows the ventilation result.
+ */
+uint8_t VentilationPage::getInputs() const {
+    return INPUT_VENTILATION;
+}
+
+/**
+ * @brief Draws the headline.
+ *
+ * @param display The display to draw on.
+ */
+void VentilationPage::drawBackground(DisplayManager& display) {
+    display.drawHeadline("Air change");
+}
+
+/**
+ * @brief Draws the air change rate, duration and fit quality of the last episode.
+ *
+ * @param display The display to draw on.
+ */
+void VentilationPage::drawContent(DisplayManager& display, unsigned long) {
+    if (!model.ventilationAvailable) {
+        display.drawTextCentered(32, FONT_SIZE_SMALL, "no decay yet");
+        return;
+    }
+
+    char buffer[24];
+    snprintf(buffer, sizeof(buffer), "%.1f /h", model.airChangesPerHour);
+    display.drawText(0, 24, FONT_SIZE_LARGE, buffer);
+    snprintf(buffer, sizeof(buffer), "%.0f min  R2 %.2f", model.episodeMinutes, model.fitQuality);
+    display.drawText(0, 50, FONT_SIZE_SMALL, buffer);
+}
+
+/**
+ * @brief Constructs the device health page.
+ *
+ * @param model The values shown.
+ */
+HealthPage::HealthPage(const DisplayModel& model) : model(model) {}
+
+/**
+ * @brief The page shows the device health.
+ */
+uint8_t HealthPage::getInputs() const {
+    return INPUT_HEALTH;
+}
+
+/**
+ * @brief Draws the headline and the labels.
+ *
+ * @param display The display to draw on.
+ */
+void HealthPage::drawBackground(DisplayManager& display) {
+    display.drawHeadline("Device");
+    display.drawText(0, 17, FONT_SIZE_SMALL, "Uptime:");
+    display.drawText(0, 26, FONT_SIZE_SMALL, "Free heap:");
+    display.drawText(0, 35, FONT_SIZE_SMALL, "Samples:");
+    display.drawText(0, 44, FONT_SIZE_SMALL, "Loop max:");
+    display.drawText(0, 53, FONT_SIZE_SMALL, "Render max:");
+}
+
+/**
+ * @brief Draws the health values aligned to the right edge.
+ *
+ * @param display The display to draw on.
+ */
+void HealthPage::drawContent(DisplayManager& display, unsigned long) {
+    char buffer[24];
+    unsigned long uptime = model.uptimeSeconds;
+    snprintf(buffer, sizeof(buffer), "%lu:%02lu:%02lu", uptime / 3600, uptime / 60 % 60, uptime % 60);
+    display.drawTextRight(17, FONT_SIZE_SMALL, buffer);
+    snprintf(buffer, sizeof(buffer), "%lu B", static_cast<unsigned long>(model.freeHeap));
+    display.drawTextRight(26, FONT_SIZE_SMALL, buffer);
+    snprintf(buffer, sizeof(buffer), "%lu", static_cast<unsigned long>(model.samples));
+    display.drawTextRight(35, FONT_SIZE_SMALL, buffer);
+    snprintf(buffer, sizeof(buffer), "%.1f ms", model.loopBusyMaxUs / 1000.0f);
+    display.drawTextRight(44, FONT_SIZE_SMALL, buffer);
+    snprintf(buffer, sizeof(buffer), "%.1f ms", model.renderMaxUs / 1000.0f);
+    display.drawTextRight(53, FONT_SIZE_SMALL, buffer);
+}
+
+/**
+ * @brief Constructs the alert page.
+ *
+ * @param model The values shown.
+ * @param displayManager The display, for the blink interval.
+ */
+AlertPage::AlertPage(const DisplayModel& model, const DisplayManager& displayManager)
+    : model(model), displayManager(displayManager) {}
+
+/**
+ * @brief The page shows the alert level and the CO2 value.
+ */
+uint8_t AlertPage::getInputs() const {
+    return INPUT_READINGS | INPUT_ALERT;
+}
+
+/**
+ * @brief The page changes at the blink interval.
+ */
+unsigned long AlertPage::getRefreshInterval() const {
+    return displayManager.getBlinkInterval();
+}
+
+/**
+ * @brief The alert page has no static parts; both phases fill the screen.
+ */
+void AlertPage::drawBackground(DisplayManager&) {}
+
+/**
+ * @brief Draws the warning in even blink intervals and the CO2 value in odd ones.
+ *
+ * @param display The display to draw on.
+ * @param now The current time in ms.
+ */
+void AlertPage::drawContent(DisplayManager& display, unsigned long now) {
+    unsigned long interval = displayManager.getBlinkInterval();
+    bool warningPhase = interval == 0 || (now / interval) % 2 == 0;
+
+    if (warningPhase) {
+        if (model.alertLevel == ALERT_CRITICAL) {
+            display.drawWarning("CRITICAL:", "High CO2", "levels!", "");
+        } else {
+            display.drawWarning("MODERATE:", "Elevated CO2", "levels!", "");
+        }
+        return;
+    }
+
+    char buffer[16];
+    display.drawHeadline(alertName(model.alertLevel));
+    snprintf(buffer, sizeof(buffer), "%.0f", model.co2);
+    display.drawTextCentered(24, FONT_SIZE_HUGE, buffer);
+}
+
+/**
+ * @brief Constructs the rooms page.
+ *
+ * @param sensorGroup The rooms shown.
+ */
+RoomsPage::RoomsPage(const SensorGroup& sensorGroup) : sensorGroup(sensorGroup) {}
+
+/**
+ * @brief The page shows the readings and alert states of the rooms.
+ */
+uint8_t RoomsPage::getInputs() const {
+    return INPUT_READINGS | INPUT_ALERT;
+}
+
+/**
+ * @brief Draws the room labels.
+ *
+ * @param display The display to draw on.
+ */
+void RoomsPage::drawBackground(DisplayManager& display) {
+    char buffer[12];
+    for (uint8_t i = 0; i < sensorGroup.getRoomCount(); i++) {
+        snprintf(buffer, sizeof(buffer), "R%u", static_cast<unsigned>(i + 1));
+        display.drawText(0, i * 8, FONT_SIZE_SMALL, buffer);
+    }
+}
+
+/**
+ * @brief Draws the CO2 and alert state of each room aligned to the right edge.
+ *
+ * @param display The display to draw on.
+ */
+void RoomsPage::drawContent(DisplayManager& display, unsigned long) {
+    char buffer[24];
+    for (uint8_t i = 0; i < sensorGroup.getRoomCount(); i++) {
+        const SensorRoom& room = sensorGroup.getRoom(i);
+        if (!room.online) {
+            snprintf(buffer, sizeof(buffer), "offline");
+        } else if (room.samples == 0) {
+            snprintf(buffer, sizeof(buffer), "waiting");
+        } else {
+            snprintf(buffer, sizeof(buffer), "%.0f ppm %s", room.co2, alertName(room.alertMonitor.getLevel()));
+        }
+        display.drawTextRight(i * 8, FONT_SIZE_SMALL, buffer);
+    }
+}
+
+/**
+ * @brief Constructs the pages.
+ *
+ * @param model The values shown.
+ * @param displayManager The display, for the blink interval of the alert page.
+ */
+MeterPages::MeterPages(const DisplayModel& model, const DisplayManager& displayManager)
+    : overview(model), detail(model), exposure(model), ventilation(model), health(model),
+      alert(model, displayManager),
+      pages{ &overview, &detail, &exposure, &ventilation, &health, &alert } {}
+
+/**
+ * @brief Retrieves the pages in `MeterPage` order.
+ */
+DisplayPage* const* MeterPages::getPages() {
+    return pages;
+}
@@ -0,0 +1,151 @@
+#include "MetricsPage.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @file MetricsPage.cpp
+ * @brief Implements the pre-rendered Prometheus response.
+ */
+
+/**
+ * @struct MetricLine
+ * @brief Describes one sample line of the page.
+ */
+struct MetricLine {
+    MetricField field; ///< Field shown on the line
+    const char* name; ///< Metric name including labels
+    const char* help; ///< HELP text, or `nullptr` for further lines of the same metric
+    const char* type; ///< Prometheus metric type
+    uint8_t decimals; ///< Decimals printed
+};
+
+static const MetricLine METRIC_LINES[METRIC_FIELD_COUNT] = {
+    { METRIC_CO2, "co2meter_co2_ppm", "CO2 concentration measured by the SCD30.", "gauge", 2 },
+    { METRIC_CO2_FILTERED, "co2meter_co2_filtered_ppm", "CO2 concentration after the Kalman filter.", "gauge", 2 },
+    { METRIC_TEMPERATURE_SCD, "co2meter_temperature_celsius{sensor=\"scd30\"}", "Temperature per sensor.", "gauge", 2 },
+    { METRIC_TEMPERATURE_BMP, "co2meter_temperature_celsius{sensor=\"bmp280\"}", nullptr, nullptr, 2 },
+    { METRIC_HUMIDITY, "co2meter_humidity_percent", "Relative humidity.", "gauge", 2 },
+    { METRIC_PRESSURE, "co2meter_pressure_hpa", "Barometric pressure.", "gauge", 2 },
+    { METRIC_ALERT_LEVEL, "co2meter_alert_level", "CO2 alert level (0 = none, 1 = moderate, 2 = critical).", "gauge", 0 },
+    { METRIC_SAMPLES, "co2meter_samples_total", "Sensor samples processed since boot.", "counter", 0 },
+    { METRIC_LOOP_LAST, "co2meter_loop_busy_seconds{stat=\"last\"}", "Busy time of the main loop excluding its delay.", "gauge", 6 },
+    { METRIC_LOOP_MAX, "co2meter_loop_busy_seconds{stat=\"max\"}", nullptr, nullptr, 6 },
+    { METRIC_FREE_HEAP, "co2meter_free_heap_bytes", "Free heap memory.", "gauge", 0 },
+    { METRIC_UPTIME, "co2meter_uptime_seconds", "Time since boot.", "counter", 0 },
+    { METRIC_SCRAPES, "co2meter_scrapes_total", "Metrics requests served since boot.", "counter", 0 },
+};
+
+/**
+ * @brief Appends text to the response while rendering.
+ */
+void MetricsPage::append(const char* text) {
+    size_t textLength = strlen(text);
+    if (length + textLength >= sizeof(buffer)) {
+        textLength = sizeof(buffer) - 1 - length;
+    }
+    memcpy(buffer + length, text, textLength);
+    length += textLength;
+    buffer[length] = '\0';
+}
+
+/**
+ * @brief Renders the response with all values set to NaN.
+ *
+ * The Content-Length header is a fixed-width slot as well; it is filled in once the
+ * body has been rendered.
+ */
+MetricsPage::MetricsPage() {
+    char line[160];
+    snprintf(line, sizeof(line),
+             "HTTP/1.1 200 OK\r\n"
+             "Content-Type: text/plain; version=0.0.4\r\n"
+             "Connection: close\r\n"
+             "Content-Length: %5u\r\n\r\n", 0U);
+    append(line);
+    size_t contentLengthOffset = length - 9;
+    size_t bodyOffset = length;
+
+    for (const MetricLine& metric : METRIC_LINES) {
+        if (metric.help != nullptr) {
+            // The family name is the metric name without labels
+            size_t nameLength = strcspn(metric.name, "{");
+            snprintf(line, sizeof(line), "# HELP %.*s %s\n# TYPE %.*s %s\n",
+                     static_cast<int>(nameLength), metric.name, metric.help,
+                     static_cast<int>(nameLength), metric.name, metric.type);
+            append(line);
+        }
+        append(metric.name);
+        append(" ");
+        offsets[metric.field] = static_cast<uint16_t>(length);
+        decimals[metric.field] = metric.decimals;
+        snprintf(line, sizeof(line), "%*s\n", METRICS_FIELD_WIDTH, "NaN");
+        append(line);
+    }
+
+    snprintf(line, sizeof(line), "%5u", static_cast<unsigned>(length - bodyOffset));
+    memcpy(buffer + contentLengthOffset, line, 5);
+}
+
+/**
+ * @brief Writes a value into its slot.
+ */
+void MetricsPage::patch(MetricField field, double value) {
+    char text[METRICS_FIELD_WIDTH + 1];
+    int written = -1;
+    if (value == value) {
+        written = snprintf(text, sizeof(text), "%*.*f", METRICS_FIELD_WIDTH, decimals[field], value);
+    }
+    if (written < 0 || written > METRICS_FIELD_WIDTH) {
+        snprintf(text, sizeof(text), "%*s", METRICS_FIELD_WIDTH, "NaN");
+    }
+    memcpy(buffer + offsets[field], text, METRICS_FIELD_WIDTH);
+}
+
+/**
+ * @brief Updates one value.
+ *
+ * @param field The field to update.
+ * @param value The new value; values that do not fit the slot are shown as NaN.
+ */
+void MetricsPage::setValue(MetricField field, double value) {
+    if (held) {
+        pending[field] = value;
+        pendingMask |= 1UL << field;
+        return;
+    }
+    patch(field, value);
+}
+
+/**
+ * @brief Defers updates until `release()`.
+ */
+void MetricsPage::hold() {
+    held = true;
+}
+
+/**
+ * @brief Applies deferred updates and resumes immediate updates.
+ */
+void MetricsPage::release() {
+    held = false;
+    for (int i = 0; i < METRIC_FIELD_COUNT; i++) {
+        if (pendingMask & (1UL << i)) {
+            patch(static_cast<MetricField>(i), pending[i]);
+        }
+    }
+    pendingMask = 0;
+}
+
+/**
+ * @brief Retrieves the complete HTTP response.
+ */
+const char* MetricsPage::getResponse() const {
+    return buffer;
+}
+
+/**
+ * @brief Retrieves the length of the complete HTTP response in bytes.
+ */
+size_t MetricsPage::getResponseLength() const {
+    return length;
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "MetricsServer.h"
+#include <string.h>
+
+/**
+ * @file MetricsServer.cpp
+ * @brief Implements the non-blocking metrics HTTP server.
+ */
+
+static const char NOT_FOUND_RESPONSE[] =
+    "HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\nConnection: close\r\nContent-Length: 10\r\n\r\nNot found\n";
+static const char BAD_REQUEST_RESPONSE[] =
+    "HTTP/1.1 400 Bad Request\r\nContent-Type: text/plain\r\nConnection: close\r\nContent-Length: 12\r\n\r\nBad request\n";
+
+/**
+ * @brief Constructs the server.
+ *
+ * @param socket The socket to serve on.
+ * @param page The page served for `/metrics`.
+ */
+MetricsServer::MetricsServer(MetricsSocket& socket, MetricsPage& page)
+    : socket(socket), page(page) {}
+
+/**
+ * @brief Starts listening.
+ *
+ * The socket can be opened before WiFi is associated; requests arrive once it is.
+ */
+void MetricsServer::begin() {
+    socket.begin();
+}
+
+/**
+ * @brief Closes the connection and releases the page.
+ */
+void MetricsServer::finish() {
+    socket.close();
+    if (holding) {
+        page.release();
+        holding = false;
+    }
+    active = false;
+    response = nullptr;
+}
+
+/**
+ * @brief Accepts, reads and answers requests incrementally.
+ *
+ * @param now The current time in ms.
+ */
+void MetricsServer::poll(unsigned long now) {
+    if (!active) {
+        if (!socket.accept()) {
+            return;
+        }
+        scanner.reset();
+        active = true;
+        sent = 0;
+        clientStart = now;
+    }
+
+    if (now - clientStart >= METRICS_CLIENT_TIMEOUT_MS) {
+        finish();
+        return;
+    }
+
+    if (response == nullptr) {
+        for (int i = 0; i < METRICS_MAX_BYTES_PER_POLL && socket.available() > 0; i++) {
+            HttpRequestTarget target = scanner.feed(static_cast<char>(socket.read()));
+            if (target == HTTP_PENDING) {
+                continue;
+            }
+
+            if (target == HTTP_METRICS) {
+                page.setValue(METRIC_SCRAPES, ++scrapes);
+                page.hold();
+                holding = true;
+                response = page.getResponse();
+                responseLength = page.getResponseLength();
+            } else if (target == HTTP_NOT_FOUND) {
+                response = NOT_FOUND_RESPONSE;
+                responseLength = sizeof(NOT_FOUND_RESPONSE) - 1;
+            } else {
+                response = BAD_REQUEST_RESPONSE;
+                responseLength = sizeof(BAD_REQUEST_RESPONSE) - 1;
+            }
+            break;
+        }
+
+        if (response == nullptr) {
+            if (!socket.connected()) {
+                finish();
+            }
+            return;
+        }
+    }
+
+    size_t room = socket.availableForWrite();
+    size_t chunk = responseLength - sent < room ? responseLength - sent : room;
+    if (chunk > 0) {
+        sent += socket.write(reinterpret_cast<const uint8_t*>(response + sent), chunk);
+    }
+    if (sent >= responseLength || !socket.connected()) {
+        finish();
+    }
+}
\ No newline at end of file
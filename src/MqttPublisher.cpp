@@ -0,0 +1,220 @@
+#include "MqttPublisher.h"
+#include "Logger.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @file MqttPublisher.cpp
+ * @brief Implements batching, offline queueing and rate-limited draining of MQTT messages.
+ */
+
+/**
+ * @brief Constructs the publisher.
+ *
+ * @param transport The connection to the broker.
+ * @param topic The topic to publish to.
+ * @param deviceId The device identifier written into each batch.
+ */
+MqttPublisher::MqttPublisher(MqttTransport& transport, const char* topic, const char* deviceId)
+    : transport(transport), topic(topic), deviceId(deviceId) {}
+
+/**
+ * @brief Retrieves the slot holding the open batch.
+ */
+MqttPublisher::Slot& MqttPublisher::batchSlot() {
+    return slots[(head + queued) % MQTT_QUEUE_SLOTS];
+}
+
+/**
+ * @brief Starts a new batch in the slot after the queued messages.
+ *
+ * Drops the oldest message if the ring is full.
+ *
+ * @param now The current time in ms.
+ */
+void MqttPublisher::openBatch(unsigned long now) {
+    if (queued == MQTT_QUEUE_SLOTS) {
+        head = (head + 1) % MQTT_QUEUE_SLOTS;
+        queued--;
+        stats.queueDepth = queued;
+        stats.dropped++;
+        Logger::warning("MQTT: queue full, dropped the oldest batch");
+    }
+
+    Slot& slot = batchSlot();
+    int length = snprintf(slot.payload, sizeof(slot.payload), "{\"device\":\"%s\",\"seq\":%lu,\"samples\":[",
+                          deviceId, static_cast<unsigned long>(sequence++));
+    slot.length = static_cast<uint16_t>(length < static_cast<int>(sizeof(slot.payload)) ? length : sizeof(slot.payload) - 1);
+    batchOpen = true;
+    batchSamples = 0;
+    batchStart = now;
+}
+
+/**
+ * @brief Terminates the open batch and appends it to the queue.
+ *
+ * `addSample()` always leaves room for the two closing characters.
+ */
+void MqttPublisher::closeBatch() {
+    Slot& slot = batchSlot();
+    slot.payload[slot.length++] = ']';
+    slot.payload[slot.length++] = '}';
+    batchOpen = false;
+    queued++;
+    if (queued > stats.maxQueueDepth) {
+        stats.maxQueueDepth = queued;
+    }
+    stats.queueDepth = queued;
+}
+
+/**
+ * @brief Appends a sample to the open batch.
+ *
+ * The row is formatted once into a small buffer and copied into the batch. A batch that
+ * cannot take the row is closed and a new one started. A sample whose row does not fit
+ * the buffer (a huge reading prints up to 40 digits) is dropped and counted as rejected.
+ *
+ * @param sample The readings to publish.
+ * @param now The current time in ms.
+ */
+void MqttPublisher::addSample(const HistorySample& sample, unsigned long now) {
+    char row[128];
+    // One character stays free for the closing bracket
+    const size_t space = sizeof(row) - 1;
+    size_t length = snprintf(row, space, "[%lu", static_cast<unsigned long>(sample.timestampMs));
+    for (int i = 0; i < HISTORY_CHANNEL_COUNT; i++) {
+        int written;
+        // JSON has no representation for NaN or infinity
+        if (isfinite(sample.values[i])) {
+            written = snprintf(row + length, space - length, ",%.2f", sample.values[i]);
+        } else {
+            written = snprintf(row + length, space - length, ",null");
+        }
+        if (written < 0 || static_cast<size_t>(written) >= space - length) {
+            stats.rejected++;
+            Logger::warning("MQTT: sample does not fit a row, dropped");
+            return;
+        }
+        length += written;
+    }
+    row[length++] = ']';
+
+    if (batchOpen && batchSlot().length + 1 + length + 2 > MQTT_PAYLOAD_SIZE) {
+        closeBatch();
+    }
+    if (!batchOpen) {
+        openBatch(now);
+    }
+
+    Slot& slot = batchSlot();
+    if (batchSamples > 0) {
+        slot.payload[slot.length++] = ',';
+    }
+    memcpy(slot.payload + slot.length, row, length);
+    slot.length += length;
+    batchSamples++;
+}
+
+/**
+ * @brief Handles connection state changes and reconnection with backoff.
+ *
+ * @param now The current time in ms.
+ * @return `true` if the transport is connected, `false` otherwise.
+ */
+bool MqttPublisher::maintainConnection(unsigned long now) {
+    if (transport.isConnected()) {
+        connected = true;
+        return true;
+    }
+
+    if (connected) {
+        connected = false;
+        lastConnectAttempt = now;
+        reconnectDelay = MQTT_RECONNECT_MIN_MS;
+        Logger::warning("MQTT: connection lost, queueing batches");
+        return false;
+    }
+
+    if (now - lastConnectAttempt < reconnectDelay) {
+        return false;
+    }
+    lastConnectAttempt = now;
+
+    if (!transport.connect()) {
+        reconnectDelay = reconnectDelay * 2 < MQTT_RECONNECT_MAX_MS ? reconnectDelay * 2 : MQTT_RECONNECT_MAX_MS;
+        Logger::debug("MQTT: connection attempt failed");
+        return false;
+    }
+
+    connected = true;
+    reconnectDelay = MQTT_RECONNECT_MIN_MS;
+    stats.reconnects++;
+    if (Logger::isEnabled(LOG_INFO)) {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "MQTT: connected, %u batches queued", static_cast<unsigned>(queued));
+        Logger::info(buffer);
+    }
+    return true;
+}
+
+/**
+ * @brief Closes due batches, keeps the connection alive and publishes at most one message.
+ *
+ * @param now The current time in ms.
+ */
+void MqttPublisher::poll(unsigned long now) {
+    if (batchOpen && now - batchStart >= MQTT_BATCH_INTERVAL_MS) {
+        closeBatch();
+    }
+
+    if (now - rateWindowStart >= MQTT_RATE_WINDOW_MS) {
+        stats.messagesPerSecond = rateWindowCount * 1000.0f / (now - rateWindowStart);
+        rateWindowStart = now;
+        rateWindowCount = 0;
+    }
+
+    if (!maintainConnection(now)) {
+        return;
+    }
+    transport.loop();
+
+    if (queued == 0 || now - lastPublish < MQTT_DRAIN_INTERVAL_MS) {
+        return;
+    }
+    lastPublish = now;
+
+    const Slot& slot = slots[head];
+    if (!transport.publish(topic, slot.payload, slot.length)) {
+        stats.failures++;
+        return;
+    }
+    head = (head + 1) % MQTT_QUEUE_SLOTS;
+    queued--;
+    stats.queueDepth = queued;
+    stats.published++;
+    rateWindowCount++;
+}
+
+/**
+ * @brief Retrieves the publishing statistics.
+ */
+const MqttPublisherStats& MqttPublisher::getStatistics() const {
+    return stats;
+}
+
+/**
+ * @brief Logs the publishing statistics.
+ */
+void MqttPublisher::logStatistics() const {
+    if (!Logger::isEnabled(LOG_INFO)) {
+        return;
+    }
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer),
+             "MQTT: %lu published, %lu failed, %lu dropped, %lu rejected, queue %u (max %u), %.2f msg/s",
+             static_cast<unsigned long>(stats.published), static_cast<unsigned long>(stats.failures),
+             static_cast<unsigned long>(stats.dropped), static_cast<unsigned long>(stats.rejected),
+             static_cast<unsigned>(stats.queueDepth), static_cast<unsigned>(stats.maxQueueDepth), stats.messagesPerSecond);
+    Logger::info(buffer);
+}
\ No newline at end of file
@@ -0,0 +1,211 @@
+#include "PageManager.h"
+#include <Arduino.h>
+
+/**
+ * @file PageManager.cpp
+ * @brief Implements the page selection and lazy rendering.
+ */
+
+/**
+ * @brief Constructs the page manager.
+ *
+ * @param displayManager The display the pages are drawn on.
+ * @param pages The pages; the array must outlive the page manager.
+ * @param pageCount Number of pages.
+ * @param rotationCount Number of leading pages cycled by the rotation and `next()`.
+ */
+PageManager::PageManager(DisplayManager& displayManager, DisplayPage* const* pages, uint8_t pageCount,
+                         uint8_t rotationCount)
+    : displayManager(displayManager), pages(pages), pageCount(pageCount), rotationCount(rotationCount) {
+    for (BackgroundSlot& slot : slots) {
+        slot.page = -1;
+        slot.lastUse = 0;
+    }
+}
+
+/**
+ * @brief Makes a page visible.
+ *
+ * Selecting the visible page again only restarts the rotation interval.
+ *
+ * @param page The page index.
+ * @param now The current time in ms.
+ */
+void PageManager::switchTo(uint8_t page, unsigned long now) {
+    if (page >= pageCount) {
+        return;
+    }
+    if (page != currentPage) {
+        currentPage = page;
+        switched = true;
+        stats.switches++;
+    }
+    lastSwitchTime = now;
+}
+
+/**
+ * @brief Shows the next page of the rotation and holds it for `DISPLAY_PAGE_HOLD_MS`.
+ *
+ * Pages outside the rotation, such as an alert page, are left for the first page. A
+ * pinned page comes back after `DISPLAY_PAGE_INTERVAL_MS`, so a button press only
+ * glances at the other pages while an alert is active.
+ *
+ * @param now The current time in ms.
+ */
+void PageManager::next(unsigned long now) {
+    switchTo(currentPage + 1 < rotationCount ? currentPage + 1 : 0, now);
+    held = true;
+    holdForever = false;
+    holdStart = now;
+    holdDuration = pinnedPage >= 0 ? DISPLAY_PAGE_INTERVAL_MS : DISPLAY_PAGE_HOLD_MS;
+}
+
+/**
+ * @brief Shows a page and holds the rotation.
+ *
+ * @param page The page index.
+ * @param now The current time in ms.
+ * @param holdMs How long the rotation is held in ms, or 0 to pin the page until `release()`.
+ */
+void PageManager::show(uint8_t page, unsigned long now, unsigned long holdMs) {
+    switchTo(page, now);
+    held = true;
+    holdForever = holdMs == 0;
+    holdStart = now;
+    holdDuration = holdMs;
+    if (holdForever && page < pageCount) {
+        pinnedPage = page;
+    }
+}
+
+/**
+ * @brief Unpins the page, ends any hold and resumes the rotation from a page.
+ *
+ * @param page The page index.
+ * @param now The current time in ms.
+ */
+void PageManager::release(uint8_t page, unsigned long now) {
+    held = false;
+    holdForever = false;
+    pinnedPage = -1;
+    switchTo(page, now);
+}
+
+/**
+ * @brief Records that values of the given input groups changed.
+ *
+ * @param inputs A combination of `DisplayInput` flags.
+ */
+void PageManager::invalidate(uint8_t inputs) {
+    pendingInputs |= inputs;
+}
+
+/**
+ * @brief Advances the rotation and renders the visible page if needed.
+ *
+ * @param now The current time in ms.
+ * @return `true` if a frame was rendered, `false` otherwise.
+ */
+bool PageManager::update(unsigned long now) {
+    if (!rendered) {
+        lastSwitchTime = now; // The rotation interval starts with the first frame
+    }
+    if (held && !holdForever && now - holdStart >= holdDuration) {
+        if (pinnedPage >= 0) {
+            switchTo(pinnedPage, now);
+            holdForever = true;
+        } else {
+            held = false;
+        }
+    }
+    if (!held && rotationCount > 0 && now - lastSwitchTime >= DISPLAY_PAGE_INTERVAL_MS) {
+        switchTo(currentPage + 1 < rotationCount ? currentPage + 1 : 0, now);
+    }
+
+    DisplayPage* page = pages[currentPage];
+    bool due = switched || (pendingInputs & page->getInputs()) != 0;
+    unsigned long refreshInterval = page->getRefreshInterval();
+    if (!due && refreshInterval > 0) {
+        // Render whenever a multiple of the interval is crossed, so blinking stays in phase
+        due = now / refreshInterval != lastRenderTime / refreshInterval;
+    }
+    if (!due) {
+        return false;
+    }
+
+    render(now);
+    return true;
+}
+
+/**
+ * @brief Restores the cached background of the current page, drawing it on a miss.
+ */
+void PageManager::prepareBackground() {
+    if (currentSlot >= 0 && slots[currentSlot].page == currentPage) {
+        displayManager.restoreBuffer(slots[currentSlot].pixels);
+        slots[currentSlot].lastUse = ++useCounter;
+        stats.backgroundHits++;
+        return;
+    }
+
+    int victim = 0;
+    for (int i = 0; i < DISPLAY_BACKGROUND_SLOTS; i++) {
+        if (slots[i].page == currentPage) {
+            currentSlot = i;
+            slots[i].lastUse = ++useCounter;
+            displayManager.restoreBuffer(slots[i].pixels);
+            stats.backgroundHits++;
+            return;
+        }
+        if (slots[i].lastUse < slots[victim].lastUse) {
+            victim = i;
+        }
+    }
+
+    // Unused slots have `lastUse` 0 and are taken first
+    BackgroundSlot& slot = slots[victim];
+    displayManager.clear();
+    pages[currentPage]->drawBackground(displayManager);
+    displayManager.saveBuffer(slot.pixels);
+    slot.page = currentPage;
+    slot.lastUse = ++useCounter;
+    currentSlot = victim;
+    stats.backgroundMisses++;
+}
+
+/**
+ * @brief Draws the current page and transfers it to the panel.
+ *
+ * @param now The current time in ms.
+ */
+void PageManager::render(unsigned long now) {
+    uint32_t startUs = micros();
+    prepareBackground();
+    pages[currentPage]->drawContent(displayManager, now);
+    displayManager.flush();
+
+    switched = false;
+    pendingInputs = 0;
+    rendered = true;
+    lastRenderTime = now;
+
+    stats.renders++;
+    stats.lastRenderUs = micros() - startUs;
+    if (stats.lastRenderUs > stats.maxRenderUs) {
+        stats.maxRenderUs = stats.lastRenderUs;
+    }
+}
+
+/**
+ * @brief Retrieves the index of the visible page.
+ */
+uint8_t PageManager::getCurrentPage() const {
+    return currentPage;
+}
+
+/**
+ * @brief Retrieves the rendering statistics.
+ */
+const PageManagerStats& PageManager::getStatistics() const {
+    return stats;
+}
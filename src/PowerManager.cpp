@@ -0,0 +1,189 @@
+#include "PowerManager.h"
+#include <stdio.h>
+#include <string.h>
+#include "Logger.h"
+
+/**
+ * @file PowerManager.cpp
+ * @brief Implements the low-power schedule and the RTC state record.
+ */
+
+#define POWER_MAGIC 0x50575231UL // "PWR1"
+
+/**
+ * @brief Constructs the manager.
+ *
+ * @param store The memory holding the record.
+ */
+PowerManager::PowerManager(RtcStore& store) : store(store) {
+    memset(&record, 0, sizeof(record));
+}
+
+/**
+ * @brief Restores the record from RTC memory.
+ *
+ * A cold boot, or a wake whose record does not validate, starts a new record with the
+ * monotonic clock at zero and the first sample due immediately.
+ *
+ * @param reason The cause of the boot reported by the hardware.
+ * @return `true` if the state was restored, `false` if this is treated as a cold boot.
+ */
+bool PowerManager::begin(WakeReason reason) {
+    static_assert(sizeof(Record) <= RTC_STATE_MAX_BYTES, "Retained state does not fit the RTC memory");
+    static_assert(sizeof(Record) % 4 == 0, "RTC memory is accessed in 4-byte blocks");
+
+    wakeReason = reason;
+    if (reason != WAKE_COLD_BOOT) {
+        if (store.read(&record, sizeof(record)) && record.magic == POWER_MAGIC &&
+            record.checksum == computeChecksum()) {
+            record.wakeCount++;
+            if (Logger::isEnabled(LOG_INFO)) {
+                char buffer[64];
+                snprintf(buffer, sizeof(buffer), "%s wake #%lu at %lu ms",
+                         reason == WAKE_BUTTON ? "Button" : "Timer",
+                         static_cast<unsigned long>(record.wakeCount), static_cast<unsigned long>(record.clockMs));
+                Logger::info(buffer);
+            }
+            return true;
+        }
+        Logger::warning("Retained state invalid, starting cold.");
+    }
+
+    wakeReason = WAKE_COLD_BOOT;
+    memset(&record, 0, sizeof(record));
+    record.magic = POWER_MAGIC;
+    return false;
+}
+
+/**
+ * @brief Retrieves the cause of the current boot after `begin()`.
+ */
+WakeReason PowerManager::getWakeReason() const {
+    return wakeReason;
+}
+
+/**
+ * @brief Retrieves the number of wakes since the cold boot.
+ */
+uint32_t PowerManager::getWakeCount() const {
+    return record.wakeCount;
+}
+
+/**
+ * @brief Accesses the application state.
+ */
+RetainedState& PowerManager::getState() {
+    return record.state;
+}
+
+/**
+ * @brief Converts a `millis()` value of the current boot to monotonic time.
+ *
+ * @param millisNow Milliseconds since the current boot.
+ * @return The monotonic time in ms.
+ */
+uint32_t PowerManager::getTimeMs(uint32_t millisNow) const {
+    return record.clockMs + millisNow;
+}
+
+/**
+ * @brief Checks whether a sample should be taken on this wake.
+ *
+ * The RTC timer of the ESP8266 drifts by a few percent, so wakes up to
+ * `LOW_POWER_WAKE_TOLERANCE_MS` early still count as on time.
+ *
+ * @param millisNow Milliseconds since the current boot.
+ */
+bool PowerManager::isSampleDue(uint32_t millisNow) const {
+    int32_t untilDue = static_cast<int32_t>(record.nextSampleMs - getTimeMs(millisNow));
+    return untilDue <= static_cast<int32_t>(LOW_POWER_WAKE_TOLERANCE_MS);
+}
+
+/**
+ * @brief Schedules the next sample after one has been taken.
+ *
+ * The schedule keeps its phase; after a long delay (missed samples) it restarts from now.
+ *
+ * @param millisNow Milliseconds since the current boot.
+ */
+void PowerManager::sampleTaken(uint32_t millisNow) {
+    uint32_t now = getTimeMs(millisNow);
+    record.nextSampleMs += LOW_POWER_SAMPLE_INTERVAL_MS;
+    if (static_cast<int32_t>(record.nextSampleMs - now) <= static_cast<int32_t>(LOW_POWER_WAKE_TOLERANCE_MS)) {
+        record.nextSampleMs = now + LOW_POWER_SAMPLE_INTERVAL_MS;
+    }
+}
+
+/**
+ * @brief Keeps the display on for a while.
+ *
+ * @param millisNow Milliseconds since the current boot.
+ * @param durationMs How long the display stays on in ms.
+ */
+void PowerManager::holdDisplay(uint32_t millisNow, uint32_t durationMs) {
+    record.displayUntilMs = getTimeMs(millisNow) + durationMs;
+}
+
+/**
+ * @brief Checks whether the display is still held on.
+ *
+ * @param millisNow Milliseconds since the current boot.
+ */
+bool PowerManager::isDisplayHeld(uint32_t millisNow) const {
+    return static_cast<int32_t>(record.displayUntilMs - getTimeMs(millisNow)) > 0;
+}
+
+/**
+ * @brief Computes how long to sleep until the next sample or display timeout.
+ *
+ * A sample that is still outstanding (the SCD30 had no data) is retried after
+ * `LOW_POWER_RETRY_MS`.
+ *
+ * @param millisNow Milliseconds since the current boot.
+ * @return The sleep duration in ms, at least `LOW_POWER_MIN_SLEEP_MS`.
+ */
+uint32_t PowerManager::planSleep(uint32_t millisNow) const {
+    uint32_t now = getTimeMs(millisNow);
+    uint32_t wakeAt = record.nextSampleMs;
+    if (isSampleDue(millisNow)) {
+        wakeAt = now + LOW_POWER_RETRY_MS;
+    }
+    if (isDisplayHeld(millisNow) && static_cast<int32_t>(record.displayUntilMs - wakeAt) < 0) {
+        wakeAt = record.displayUntilMs;
+    }
+
+    uint32_t sleepMs = wakeAt - now;
+    return sleepMs < LOW_POWER_MIN_SLEEP_MS ? LOW_POWER_MIN_SLEEP_MS : sleepMs;
+}
+
+/**
+ * @brief Writes the record before going to sleep.
+ *
+ * @param millisNow Milliseconds since the current boot.
+ * @param sleepMs The sleep duration that follows in ms.
+ * @return `true` if the write succeeded, `false` otherwise.
+ */
+bool PowerManager::save(uint32_t millisNow, uint32_t sleepMs) {
+    record.clockMs = getTimeMs(millisNow) + sleepMs;
+    record.checksum = computeChecksum();
+    if (!store.write(&record, sizeof(record))) {
+        Logger::error("Writing retained state failed");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Computes the checksum of the record.
+ *
+ * @return The checksum over all fields except `checksum` itself.
+ */
+uint32_t PowerManager::computeChecksum() const {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&record);
+    uint32_t hash = 2166136261UL;
+    for (size_t i = 0; i < offsetof(Record, checksum); i++) {
+        hash ^= bytes[i];
+        hash *= 16777619UL;
+    }
+    return hash;
+}
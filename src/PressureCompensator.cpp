@@ -0,0 +1,123 @@
+#include "PressureCompensator.h"
+#include "Logger.h"
+#include <math.h>
+#include <stdio.h>
+
+/**
+ * @file PressureCompensator.cpp
+ * @brief Implements the deadband and rate limiting of the SCD30 pressure compensation.
+ */
+
+/**
+ * @brief Constructs the compensator.
+ *
+ * @param sink The receiver of the compensation commands.
+ * @param deadband Pressure change that triggers a write in hPa.
+ * @param minInterval Minimum time between writes in ms.
+ */
+PressureCompensator::PressureCompensator(AmbientPressureSink& sink, float deadband, unsigned long minInterval)
+    : sink(sink), deadband(deadband), minInterval(minInterval) {}
+
+/**
+ * @brief Processes a new pressure reading and writes it to the sensor if needed.
+ *
+ * The first valid reading is always written. Afterwards a reading outside the deadband
+ * is written as soon as the rate limit allows; until then it is counted as rate limited
+ * and retried with the next reading.
+ *
+ * @param pressureHpa The ambient pressure in hPa.
+ * @param timestampMs The reading timestamp in ms (e.g. from `millis()`).
+ * @return `true` if a compensation value was written, `false` otherwise.
+ */
+bool PressureCompensator::update(float pressureHpa, unsigned long timestampMs) {
+    if (!(pressureHpa >= PRESSURE_COMP_MIN_HPA && pressureHpa <= PRESSURE_COMP_MAX_HPA)) {
+        stats.rejected++;
+        return false;
+    }
+
+    if (hasWritten) {
+        if (fabsf(pressureHpa - lastWrittenMbar) < deadband) {
+            stats.skippedDeadband++;
+            return false;
+        }
+        if (timestampMs - lastWriteTime < minInterval) {
+            stats.skippedRateLimit++;
+            return false;
+        }
+    }
+
+    uint16_t pressureMbar = static_cast<uint16_t>(lroundf(pressureHpa));
+    if (!sink.setAmbientPressure(pressureMbar)) {
+        stats.failures++;
+        Logger::error("Setting SCD30 ambient pressure failed");
+        return false;
+    }
+
+    hasWritten = true;
+    lastWrittenMbar = pressureMbar;
+    lastWriteTime = timestampMs;
+    stats.writes++;
+
+    if (Logger::isEnabled(LOG_INFO)) {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "SCD30 pressure compensation set to %u mbar", pressureMbar);
+        Logger::info(buffer);
+    }
+    return true;
+}
+
+/**
+ * @brief Retrieves the write statistics.
+ *
+ * @return The counters since startup.
+ */
+const PressureCompensationStats& PressureCompensator::getStatistics() const {
+    return stats;
+}
+
+/**
+ * @brief Captures the compensator state.
+ *
+ * @param state Receives the snapshot.
+ */
+void PressureCompensator::getState(PressureCompensatorState& state) const {
+    state.hasWritten = hasWritten ? 1 : 0;
+    state.reserved = 0;
+    state.lastWrittenMbar = lastWrittenMbar;
+    state.lastWriteTime = lastWriteTime;
+    state.stats = stats;
+}
+
+/**
+ * @brief Continues from a previously captured state.
+ *
+ * Without it, the first reading after every restart would be written to the SCD30, which
+ * restarts its measurement.
+ *
+ * @param state The snapshot.
+ */
+void PressureCompensator::setState(const PressureCompensatorState& state) {
+    hasWritten = state.hasWritten != 0;
+    lastWrittenMbar = state.lastWrittenMbar;
+    lastWriteTime = state.lastWriteTime;
+    stats = state.stats;
+}
+
+/**
+ * @brief Logs the write statistics.
+ */
+void PressureCompensator::logStatistics() const {
+    if (!Logger::isEnabled(LOG_INFO)) {
+        return;
+    }
+    char buffer[160];
+    snprintf(buffer, sizeof(buffer),
+             "Pressure compensation: %lu writes, %lu failed, %lu avoided (deadband %lu, rate limit %lu), %lu rejected",
+             static_cast<unsigned long>(stats.writes),
+             static_cast<unsigned long>(stats.failures),
+             static_cast<unsigned long>(stats.skippedDeadband + stats.skippedRateLimit),
+             static_cast<unsigned long>(stats.skippedDeadband),
+             static_cast<unsigned long>(stats.skippedRateLimit),
+             static_cast<unsigned long>(stats.rejected));
+    Logger::info(buffer);
+}
\ No newline at end of file
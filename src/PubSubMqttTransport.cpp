@@ -0,0 +1,64 @@
+#include "PubSubMqttTransport.h"
+
+/**
+ * @file PubSubMqttTransport.cpp
+ * @brief Implements the MQTT transport over WiFi.
+ */
+
+/**
+ * @brief Constructs the transport.
+ *
+ * @param host The broker host name or address.
+ * @param port The broker port.
+ * @param clientId The MQTT client identifier.
+ */
+PubSubMqttTransport::PubSubMqttTransport(const char* host, uint16_t port, const char* clientId)
+    : client(wifiClient), host(host), port(port), clientId(clientId) {}
+
+/**
+ * @brief Connects to the broker once WiFi is associated.
+ *
+ * @return `true` if connected to the broker, `false` otherwise.
+ */
+bool PubSubMqttTransport::connect() {
+    if (WIFI_SSID[0] == '\0' || WiFi.status() != WL_CONNECTED) {
+        return false;
+    }
+
+    if (!configured) {
+        wifiClient.setTimeout(MQTT_CONNECT_TIMEOUT_MS);
+        // The MQTT handshake timeout is in whole seconds
+        client.setSocketTimeout((MQTT_CONNECT_TIMEOUT_MS + 999) / 1000);
+        client.setServer(host, port);
+        // Room for the largest batch plus the topic and the MQTT header
+        client.setBufferSize(MQTT_PAYLOAD_SIZE + 128);
+        configured = true;
+    }
+    return client.connected() || client.connect(clientId);
+}
+
+/**
+ * @brief Checks whether the broker connection is up.
+ */
+bool PubSubMqttTransport::isConnected() {
+    return configured && client.connected();
+}
+
+/**
+ * @brief Publishes one message.
+ *
+ * @param topic The topic.
+ * @param payload The message payload.
+ * @param length The payload length in bytes.
+ * @return `true` if the message was sent, `false` otherwise.
+ */
+bool PubSubMqttTransport::publish(const char* topic, const char* payload, size_t length) {
+    return client.publish(topic, reinterpret_cast<const uint8_t*>(payload), length, false);
+}
+
+/**
+ * @brief Services keep-alive and incoming packets.
+ */
+void PubSubMqttTransport::loop() {
+    client.loop();
+}
\ No newline at end of file
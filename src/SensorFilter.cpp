@@ -0,0 +1,194 @@
+#include "SensorFilter.h"
+
+/**
+ * @file SensorFilter.cpp
+ * @brief Implements the fixed-point Kalman filters for CO2 and temperature.
+ */
+
+#define FIXED_SHIFT 16
+#define FIXED_ONE (1L << FIXED_SHIFT)
+
+/**
+ * @brief Converts a float to Q16.16; folded at compile time for constants.
+ */
+static constexpr fixed_t fixedFromFloat(float value) {
+    return static_cast<fixed_t>(value * FIXED_ONE);
+}
+
+/**
+ * @brief Limits a reading to a range that fits Q16.16; NaN maps to the lower bound.
+ */
+static inline float clampReading(float value, float low, float high) {
+    if (!(value >= low)) {
+        return low;
+    }
+    return value > high ? high : value;
+}
+
+/**
+ * @brief Converts a Q16.16 number to float.
+ */
+static inline float fixedToFloat(fixed_t value) {
+    return static_cast<float>(value) / FIXED_ONE;
+}
+
+/**
+ * @brief Multiplies two Q16.16 numbers.
+ */
+static inline fixed_t fixedMul(fixed_t a, fixed_t b) {
+    return static_cast<fixed_t>((static_cast<int64_t>(a) * b) >> FIXED_SHIFT);
+}
+
+// Noise model in Q16.16. Variances are capped at 10000 so that the sum of two of them
+// still fits into the integer part of a Q16.16 number.
+static constexpr fixed_t CO2_PROCESS_VARIANCE = fixedFromFloat(FILTER_CO2_PROCESS_NOISE_PPM * FILTER_CO2_PROCESS_NOISE_PPM);
+static constexpr fixed_t CO2_NOISE = fixedFromFloat(FILTER_CO2_NOISE_PPM);
+static constexpr fixed_t CO2_NOISE_RELATIVE = fixedFromFloat(FILTER_CO2_NOISE_RELATIVE);
+static constexpr fixed_t CO2_MAX_NOISE = fixedFromFloat(100.0f);
+static constexpr fixed_t CO2_MAX_VARIANCE = fixedFromFloat(10000.0f);
+static constexpr fixed_t CO2_STEP = fixedFromFloat(FILTER_CO2_STEP_PPM);
+static constexpr fixed_t TEMP_PROCESS_VARIANCE = fixedFromFloat(FILTER_TEMP_PROCESS_NOISE * FILTER_TEMP_PROCESS_NOISE);
+static constexpr fixed_t TEMP_BMP_VARIANCE = fixedFromFloat(FILTER_TEMP_NOISE_BMP * FILTER_TEMP_NOISE_BMP);
+static constexpr fixed_t TEMP_SCD_VARIANCE = fixedFromFloat(FILTER_TEMP_NOISE_SCD * FILTER_TEMP_NOISE_SCD);
+
+/**
+ * @brief Feeds one set of raw readings into the filters.
+ *
+ * The first sample initializes all states. Afterwards each call performs a prediction
+ * (adding process noise) followed by the measurement updates. Readings outside
+ * `FILTER_CO2_MAX_PPM` and `FILTER_TEMP_MIN`..`FILTER_TEMP_MAX` are clamped first.
+ *
+ * @param rawCO2 The CO2 concentration from the SCD30 in ppm.
+ * @param temperatureSCD The temperature from the SCD30 in °C.
+ * @param temperatureBMP The temperature from the BMP280 in °C.
+ */
+void SensorFilter::update(float rawCO2, float temperatureSCD, float temperatureBMP) {
+    // Q16.16 ends at 32767, below the 40000 ppm range of the SCD30
+    fixed_t measuredCO2 = fixedFromFloat(clampReading(rawCO2, 0.0f, FILTER_CO2_MAX_PPM));
+    fixed_t measuredSCD = fixedFromFloat(clampReading(temperatureSCD, FILTER_TEMP_MIN, FILTER_TEMP_MAX));
+    fixed_t measuredBMP = fixedFromFloat(clampReading(temperatureBMP, FILTER_TEMP_MIN, FILTER_TEMP_MAX));
+
+    // Measurement noise grows with the concentration
+    fixed_t co2Noise = CO2_NOISE + fixedMul(CO2_NOISE_RELATIVE, measuredCO2);
+    if (co2Noise > CO2_MAX_NOISE) {
+        co2Noise = CO2_MAX_NOISE;
+    }
+    fixed_t co2NoiseVariance = fixedMul(co2Noise, co2Noise);
+
+    if (!initialized) {
+        co2 = measuredCO2;
+        co2Variance = co2NoiseVariance;
+        temperature = measuredBMP;
+        temperatureVariance = TEMP_BMP_VARIANCE;
+        selfHeatingBias = measuredSCD - measuredBMP;
+        initialized = true;
+        return;
+    }
+
+    // CO2: reopen the covariance on a step so the estimate follows immediately
+    co2Variance += CO2_PROCESS_VARIANCE;
+    fixed_t innovation = measuredCO2 - co2;
+    if (innovation > CO2_STEP || innovation < -CO2_STEP || co2Variance > CO2_MAX_VARIANCE) {
+        co2Variance = CO2_MAX_VARIANCE;
+    }
+    kalmanUpdate(co2, co2Variance, measuredCO2, co2NoiseVariance);
+
+    // Temperature: track the self-heating offset slowly, then fuse both sources
+    selfHeatingBias += ((measuredSCD - measuredBMP) - selfHeatingBias) >> FILTER_BIAS_SHIFT;
+    temperatureVariance += TEMP_PROCESS_VARIANCE;
+    kalmanUpdate(temperature, temperatureVariance, measuredBMP, TEMP_BMP_VARIANCE);
+    kalmanUpdate(temperature, temperatureVariance, measuredSCD - selfHeatingBias, TEMP_SCD_VARIANCE);
+}
+
+/**
+ * @brief Applies one Kalman measurement update to a scalar state.
+ *
+ * @param state The state estimate, updated in place.
+ * @param variance The state variance, updated in place.
+ * @param measurement The measurement.
+ * @param noiseVariance The measurement noise variance.
+ */
+void SensorFilter::kalmanUpdate(fixed_t& state, fixed_t& variance, fixed_t measurement, fixed_t noiseVariance) {
+    int64_t totalVariance = static_cast<int64_t>(variance) + noiseVariance;
+    if (totalVariance <= 0) {
+        return;
+    }
+
+    fixed_t gain = static_cast<fixed_t>((static_cast<int64_t>(variance) << FIXED_SHIFT) / totalVariance);
+    state += fixedMul(gain, measurement - state);
+    variance = fixedMul(FIXED_ONE - gain, variance);
+}
+
+/**
+ * @brief Discards the filter state; the next sample reinitializes it.
+ */
+void SensorFilter::reset() {
+    initialized = false;
+}
+
+/**
+ * @brief Captures the filter state.
+ *
+ * @param state Receives the snapshot.
+ */
+void SensorFilter::getState(SensorFilterState& state) const {
+    state.initialized = initialized ? 1 : 0;
+    state.co2 = co2;
+    state.co2Variance = co2Variance;
+    state.temperature = temperature;
+    state.temperatureVariance = temperatureVariance;
+    state.selfHeatingBias = selfHeatingBias;
+}
+
+/**
+ * @brief Continues from a previously captured state.
+ *
+ * The converged self-heating bias in particular takes hundreds of samples to learn again.
+ *
+ * @param state The snapshot.
+ */
+void SensorFilter::setState(const SensorFilterState& state) {
+    initialized = state.initialized != 0;
+    co2 = state.co2;
+    co2Variance = state.co2Variance;
+    temperature = state.temperature;
+    temperatureVariance = state.temperatureVariance;
+    selfHeatingBias = state.selfHeatingBias;
+}
+
+/**
+ * @brief Retrieves the filtered CO2 concentration.
+ *
+ * @return The CO2 concentration in ppm.
+ */
+float SensorFilter::getCO2() const {
+    return fixedToFloat(co2);
+}
+
+/**
+ * @brief Retrieves the fused temperature.
+ *
+ * @return The temperature in °C.
+ */
+float SensorFilter::getTemperature() const {
+    return fixedToFloat(temperature);
+}
+
+/**
+ * @brief Retrieves the estimated SCD30 self-heating bias.
+ *
+ * @return The offset of the SCD30 temperature against the BMP280 in °C.
+ */
+float SensorFilter::getSelfHeatingBias() const {
+    return fixedToFloat(selfHeatingBias);
+}
+
+/**
+ * @brief Converts an SCD30 temperature reading by removing the self-heating bias.
+ *
+ * @param temperatureSCD The temperature from the SCD30 in °C.
+ * @return The compensated temperature in °C.
+ */
+float SensorFilter::compensateTemperatureSCD(float temperatureSCD) const {
+    return temperatureSCD - fixedToFloat(selfHeatingBias);
+}
\ No newline at end of file
@@ -0,0 +1,267 @@
+#include "SensorGroup.h"
+
+/**
+ * @file SensorGroup.cpp
+ * @brief Implements the multiplexed polling of several rooms.
+ */
+
+/**
+ * @brief Checks whether a time has been reached, across a `millis()` wrap.
+ */
+static inline bool isDue(unsigned long time, unsigned long now) {
+    return static_cast<long>(now - time) >= 0;
+}
+
+/**
+ * @brief Constructs an empty group.
+ *
+ * @param mux The multiplexer.
+ * @param measurementIntervalMs The measurement interval set on every sensor in ms.
+ */
+SensorGroup::SensorGroup(MuxBus& mux, unsigned long measurementIntervalMs)
+    : mux(mux), measurementIntervalMs(measurementIntervalMs) {}
+
+/**
+ * @brief Adds a room.
+ *
+ * @param sensor The sensors of the room; they must outlive the group.
+ * @param channel The multiplexer channel of the sensors.
+ * @return `true` if the room was added, `false` if the group is full.
+ */
+bool SensorGroup::addRoom(RoomSensor& sensor, uint8_t channel) {
+    if (roomCount >= SENSOR_GROUP_MAX_ROOMS) {
+        return false;
+    }
+    SensorRoom& room = rooms[roomCount++];
+    room.sensor = &sensor;
+    room.channel = channel;
+    return true;
+}
+
+/**
+ * @brief Selects a channel unless it is already selected.
+ *
+ * @param channel The channel.
+ * @return `true` if the channel is selected, `false` if the multiplexer did not answer.
+ */
+bool SensorGroup::selectChannel(uint8_t channel) {
+    if (currentChannel == channel) {
+        return true;
+    }
+    stats.channelSwitches++;
+    if (!mux.selectChannel(channel)) {
+        currentChannel = -1;
+        return false;
+    }
+    currentChannel = channel;
+    return true;
+}
+
+/**
+ * @brief Initializes the sensors of a room and sets their measurement interval.
+ *
+ * A room that comes online is due at once; one that fails waits `SENSOR_GROUP_RESTART_MS`
+ * for the next attempt.
+ *
+ * @param room The room.
+ * @param now The current time in ms.
+ * @return `true` if the room is online, `false` if it waits for the next attempt.
+ */
+bool SensorGroup::startRoom(SensorRoom& room, unsigned long now) {
+    room.online = selectChannel(room.channel) && room.sensor->initializeSensors(true) &&
+                  room.sensor->setMeasurementInterval(measurementIntervalMs / 1000);
+    room.nextReadyMs = room.online ? now : now + SENSOR_GROUP_RESTART_MS;
+    room.lastSampleMs = now;
+    return room.online;
+}
+
+/**
+ * @brief Initializes the sensors of all rooms and sets their measurement interval.
+ *
+ * All rooms start due, so the first `poll()` looks for data everywhere.
+ *
+ * @param now The current time in ms.
+ * @return The number of rooms that are online.
+ */
+uint8_t SensorGroup::begin(unsigned long now) {
+    uint8_t online = 0;
+    for (uint8_t i = 0; i < roomCount; i++) {
+        if (startRoom(rooms[i], now)) {
+            online++;
+        }
+    }
+    return online;
+}
+
+/**
+ * @brief Reads and processes the measurement of a room whose channel is selected.
+ *
+ * @param room The room.
+ * @param now The current time in ms.
+ */
+void SensorGroup::readRoom(SensorRoom& room, unsigned long now) {
+    room.lastSample.timestampMs = static_cast<uint32_t>(now);
+    room.lastSampleMs = now;
+    room.sensor->readSample(room.lastSample.values);
+    const float* values = room.lastSample.values;
+    room.filter.update(values[HISTORY_CO2], values[HISTORY_TEMP_SCD], values[HISTORY_TEMP_BMP]);
+    room.co2 = room.filter.getCO2();
+    room.samples++;
+    stats.samples++;
+}
+
+/**
+ * @brief Reads every room whose measurement is due.
+ *
+ * @param now The current time in ms.
+ * @return A bit mask of the rooms that delivered a new sample.
+ */
+uint8_t SensorGroup::poll(unsigned long now) {
+    alertChanges = 0;
+    onlineChanges = 0;
+
+    // Take silent rooms offline and try one offline room again; initializing holds the bus for a while
+    bool restarted = false;
+    for (uint8_t i = 0; i < roomCount; i++) {
+        SensorRoom& room = rooms[i];
+        if (room.online) {
+            if (isDue(room.lastSampleMs + SENSOR_GROUP_OFFLINE_MS, now)) {
+                room.online = false;
+                room.nextReadyMs = now + SENSOR_GROUP_RESTART_MS;
+                onlineChanges |= 1 << i;
+            }
+        } else if (!restarted && isDue(room.nextReadyMs, now)) {
+            restarted = true;
+            stats.restarts++;
+            if (startRoom(room, now)) {
+                onlineChanges |= 1 << i;
+            }
+        }
+    }
+
+    // Collect the due rooms, most overdue first; at most eight, so insertion sort it is
+    uint8_t order[SENSOR_GROUP_MAX_ROOMS];
+    uint8_t dueCount = 0;
+    for (uint8_t i = 0; i < roomCount; i++) {
+        if (!rooms[i].online || !isDue(rooms[i].nextReadyMs, now)) {
+            continue;
+        }
+        uint8_t position = dueCount++;
+        while (position > 0 && static_cast<long>(rooms[i].nextReadyMs - rooms[order[position - 1]].nextReadyMs) < 0) {
+            order[position] = order[position - 1];
+            position--;
+        }
+        order[position] = i;
+    }
+    if (dueCount == 0) {
+        return 0;
+    }
+    stats.passes++;
+
+    // A due room on the selected channel goes first, which saves one switch per pass
+    for (uint8_t position = 1; position < dueCount; position++) {
+        if (rooms[order[position]].channel == currentChannel) {
+            uint8_t index = order[position];
+            for (; position > 0; position--) {
+                order[position] = order[position - 1];
+            }
+            order[0] = index;
+            break;
+        }
+    }
+
+    uint8_t updated = 0;
+    for (uint8_t position = 0; position < dueCount; position++) {
+        uint8_t index = order[position];
+        SensorRoom& room = rooms[index];
+        if (!selectChannel(room.channel)) {
+            room.nextReadyMs = now + SENSOR_GROUP_RETRY_MS;
+            continue;
+        }
+
+        stats.dataChecks++;
+        if (!room.sensor->isDataAvailable()) {
+            room.notReady++;
+            room.nextReadyMs = now + SENSOR_GROUP_RETRY_MS;
+            continue;
+        }
+
+        readRoom(room, now);
+        // Look again slightly before the next measurement, which catches a sensor clock
+        // running fast before a measurement is overwritten
+        room.nextReadyMs = now + measurementIntervalMs - SENSOR_GROUP_RETRY_MS;
+        AlertLevel previousLevel = room.alertMonitor.getLevel();
+        if (room.alertMonitor.evaluate(room.co2) != previousLevel) {
+            alertChanges |= 1 << index;
+        }
+        updated |= 1 << index;
+    }
+    return updated;
+}
+
+/**
+ * @brief Selects the channel of a room, e.g. to calibrate its sensors.
+ *
+ * @param index The room index.
+ * @return `true` if the channel is selected, `false` otherwise.
+ */
+bool SensorGroup::selectRoom(uint8_t index) {
+    return index < roomCount && selectChannel(rooms[index].channel);
+}
+
+/**
+ * @brief Sets the alert thresholds of every room.
+ *
+ * @param moderate The moderate threshold in ppm.
+ * @param critical The critical threshold in ppm.
+ * @return `true` if the thresholds were accepted, `false` if they are not ordered or not positive.
+ */
+bool SensorGroup::setThresholds(float moderate, float critical) {
+    for (uint8_t i = 0; i < roomCount; i++) {
+        if (!rooms[i].alertMonitor.setThresholds(moderate, critical)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Retrieves the rooms whose alert level changed in the last `poll()`.
+ *
+ * @return A bit mask of room indices.
+ */
+uint8_t SensorGroup::getAlertChanges() const {
+    return alertChanges;
+}
+
+/**
+ * @brief Retrieves the rooms that went offline or came back online in the last `poll()`.
+ *
+ * @return A bit mask of room indices.
+ */
+uint8_t SensorGroup::getOnlineChanges() const {
+    return onlineChanges;
+}
+
+/**
+ * @brief Retrieves the number of rooms.
+ */
+uint8_t SensorGroup::getRoomCount() const {
+    return roomCount;
+}
+
+/**
+ * @brief Retrieves the state of a room.
+ *
+ * @param index The room index.
+ */
+const SensorRoom& SensorGroup::getRoom(uint8_t index) const {
+    return rooms[index];
+}
+
+/**
+ * @brief Retrieves the bus traffic statistics.
+ */
+const SensorGroupStats& SensorGroup::getStatistics() const {
+    return stats;
+}
@@ -0,0 +1,535 @@
+#include "SerialConsole.h"
+#include "Logger.h"
+#include "BuildProfile.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @file SerialConsole.cpp
+ * @brief Implements the serial command console.
+ */
+
+/**
+ * @brief Parses a complete decimal integer.
+ *
+ * @param text The text to parse.
+ * @param value Receives the parsed value.
+ * @return `true` if the whole text is a valid integer, `false` otherwise.
+ */
+static bool parseLong(const char* text, long& value) {
+    char* end;
+    value = strtol(text, &end, 10);
+    return end != text && *end == '\0';
+}
+
+/**
+ * @brief Parses a complete decimal number.
+ *
+ * @param text The text to parse.
+ * @param value Receives the parsed value.
+ * @return `true` if the whole text is a valid number, `false` otherwise.
+ */
+static bool parseFloat(const char* text, float& value) {
+    char* end;
+    value = strtof(text, &end);
+    return end != text && *end == '\0';
+}
+
+/**
+ * @brief Constructs the console.
+ *
+ * @param stream The stream to read commands from and answer on (usually `Serial`).
+ * @param sensorManager The sensor manager for calibration commands.
+ * @param displayManager The display manager for the blink interval.
+ * @param alertMonitor The alert monitor for the thresholds.
+ * @param exposureAccumulator The exposure accumulator for the history dump.
+ * @param pressureCompensator The pressure compensator for statistics.
+ * @param ventilationEstimator The ventilation estimator for statistics.
+ * @param historyArchive The compressed history for the compressed dump.
+ * @param mqttPublisher The MQTT publisher for statistics.
+ * @param traceRecorder The trace recorder for the trace commands.
+ * @param measurementPipeline The pipeline for the stage timing.
+ * @param pageManager The page manager for the render statistics.
+ */
+SerialConsole::SerialConsole(Stream& stream, SensorManager& sensorManager, DisplayManager& displayManager,
+                             AlertMonitor& alertMonitor, ExposureAccumulator& exposureAccumulator,
+                             PressureCompensator& pressureCompensator, VentilationEstimator& ventilationEstimator,
+                             HistoryArchive& historyArchive, MqttPublisher& mqttPublisher,
+                             TraceRecorder& traceRecorder, MeasurementPipeline& measurementPipeline,
+                             PageManager& pageManager)
+    : stream(stream), sensorManager(sensorManager), displayManager(displayManager),
+      alertMonitor(alertMonitor), exposureAccumulator(exposureAccumulator),
+      pressureCompensator(pressureCompensator), ventilationEstimator(ventilationEstimator),
+      historyArchive(historyArchive), mqttPublisher(mqttPublisher),
+      traceRecorder(traceRecorder), measurementPipeline(measurementPipeline), pageManager(pageManager) {}
+
+/**
+ * @brief Routes the sensor commands to the rooms of a multi-room build.
+ *
+ * The single-room sensor manager, filter and compensation are idle in such a build.
+ *
+ * @param sensorGroup The rooms.
+ * @param roomSensors The sensors of each room, indexed like the rooms.
+ */
+void SerialConsole::setRooms(SensorGroup& sensorGroup, SensorManager* roomSensors) {
+    this->sensorGroup = &sensorGroup;
+    this->roomSensors = roomSensors;
+}
+
+/**
+ * @brief Processes pending input without blocking.
+ *
+ * Emits the next line of a running dump, then consumes up to
+ * `CONSOLE_MAX_BYTES_PER_POLL` bytes and stops early after one complete command.
+ */
+void SerialConsole::poll() {
+    if (dumpIndex >= 0) {
+        printExposureEntry(static_cast<uint8_t>(dumpIndex));
+        if (++dumpIndex >= EXPOSURE_HOUR_COUNT + EXPOSURE_DAY_COUNT) {
+            dumpIndex = -1;
+        }
+    } else if (blockDumpIndex >= 0) {
+        if (blockDumpIndex < historyArchive.getBlockCount()) {
+            const HistoryEncoder& block = historyArchive.getBlock(static_cast<uint8_t>(blockDumpIndex));
+            printBlock("HIST:", block.getData(), block.getSize());
+        }
+        if (++blockDumpIndex >= historyArchive.getBlockCount()) {
+            blockDumpIndex = -1;
+        }
+    } else if (traceDumpIndex >= 0) {
+        if (traceDumpIndex < traceRecorder.getBlockCount()) {
+            const TraceEncoder& block = traceRecorder.getBlock(static_cast<uint8_t>(traceDumpIndex));
+            printBlock("TRACE:", block.getData(), block.getSize());
+        }
+        if (++traceDumpIndex >= traceRecorder.getBlockCount()) {
+            traceDumpIndex = -1;
+        }
+    }
+
+    for (int i = 0; i < CONSOLE_MAX_BYTES_PER_POLL && stream.available() > 0; i++) {
+        if (feed(static_cast<char>(stream.read()))) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Feeds one character into the line parser.
+ *
+ * Lines end with CR or LF; backspace removes the last character. Lines longer than
+ * the buffer are discarded up to their end and reported as an error.
+ *
+ * @param c The received character.
+ * @return `true` if the character completed a command line, `false` otherwise.
+ */
+bool SerialConsole::feed(char c) {
+    if (c == '\r' || c == '\n') {
+        if (overflow) {
+            overflow = false;
+            length = 0;
+            respond("error: line too long");
+            return false;
+        }
+        if (length == 0) {
+            return false;
+        }
+        line[length] = '\0';
+        execute();
+        length = 0;
+        return true;
+    }
+
+    if (c == '\b' || c == 0x7F) {
+        if (length > 0 && !overflow) {
+            length--;
+        }
+        return false;
+    }
+
+    if (overflow) {
+        return false;
+    }
+    if (length >= CONSOLE_BUFFER_SIZE - 1) {
+        overflow = true;
+        return false;
+    }
+    line[length++] = c;
+    return false;
+}
+
+/**
+ * @brief Tokenizes the current line in place and runs the matching command.
+ */
+void SerialConsole::execute() {
+    char* argv[CONSOLE_MAX_ARGS];
+    int argc = 0;
+    char* cursor = line;
+
+    while (*cursor != '\0') {
+        while (*cursor == ' ' || *cursor == '\t') {
+            *cursor++ = '\0';
+        }
+        if (*cursor == '\0') {
+            break;
+        }
+        if (argc == CONSOLE_MAX_ARGS) {
+            respond("error: too many arguments");
+            return;
+        }
+        argv[argc++] = cursor;
+        while (*cursor != '\0' && *cursor != ' ' && *cursor != '\t') {
+            cursor++;
+        }
+    }
+
+    if (argc == 0) {
+        return;
+    }
+
+    for (const Command& command : commands) {
+        if (strcmp(argv[0], command.name) == 0) {
+            (this->*command.handler)(argc, argv);
+            return;
+        }
+    }
+    respond("error: unknown command '%s', try 'help'", argv[0]);
+}
+
+/**
+ * @brief Prints a formatted response line.
+ *
+ * Responses go straight to the console stream, independent of the log level. Formats are
+ * kept short enough for `CONSOLE_RESPONSE_SIZE` with 10-digit counters; a line that still
+ * does not fit ends in "..." so the truncation is visible.
+ *
+ * @param format The printf-style format string.
+ */
+void SerialConsole::respond(const char* format, ...) {
+    char buffer[CONSOLE_RESPONSE_SIZE];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length >= static_cast<int>(sizeof(buffer))) {
+        memcpy(buffer + sizeof(buffer) - 4, "...", 4);
+    }
+    stream.println(buffer);
+}
+
+/**
+ * @brief Prints one encoded block as a base64 line.
+ *
+ * A full block takes 4/3 as many characters as it has bytes. `tools/history-decoder`
+ * turns `HIST:` lines back into readings, and `tools/trace-replay` replays `TRACE:` lines.
+ *
+ * @param prefix The line prefix, e.g. `HIST:`.
+ * @param data The block.
+ * @param size The size of the block in bytes.
+ */
+void SerialConsole::printBlock(const char* prefix, const uint8_t* data, size_t size) {
+    static_assert(TRACE_BLOCK_BYTES <= HISTORY_BLOCK_BYTES, "Text buffer is sized for history blocks");
+    char text[4 * ((HISTORY_BLOCK_BYTES + 2) / 3) + 1];
+    encodeBase64(data, size, text, sizeof(text));
+    stream.print(prefix);
+    stream.println(text);
+}
+
+/**
+ * @brief Prints one exposure rollup, independent of the log level.
+ *
+ * @param index 0 to `EXPOSURE_HOUR_COUNT` - 1 selects an hour (newest first), the
+ *              following `EXPOSURE_DAY_COUNT` indices select a day (newest first).
+ */
+void SerialConsole::printExposureEntry(uint8_t index) {
+    bool hour = index < EXPOSURE_HOUR_COUNT;
+    unsigned age = hour ? index : index - EXPOSURE_HOUR_COUNT;
+    const ExposureTotals& totals = hour ? exposureAccumulator.getHour(age) : exposureAccumulator.getDay(age);
+    respond("%s -%u: moderate %.2f ppm*h / %.1f min, critical %.2f ppm*h / %.1f min", hour ? "hour" : "day", age,
+            totals.ppmHours[EXPOSURE_MODERATE], totals.secondsAbove[EXPOSURE_MODERATE] / 60.0f,
+            totals.ppmHours[EXPOSURE_CRITICAL], totals.secondsAbove[EXPOSURE_CRITICAL] / 60.0f);
+}
+
+/**
+ * @brief Lists the commands.
+ */
+void SerialConsole::cmdHelp(int, char*[]) {
+    for (const Command& command : commands) {
+        respond("  %s", command.usage);
+    }
+}
+
+/**
+ * @brief Shows or sets the log level (0 = none ... 4 = debug).
+ *
+ * @param argc Number of words.
+ * @param argv The words; argv[1] is the optional new level.
+ */
+void SerialConsole::cmdLogLevel(int argc, char* argv[]) {
+    if (argc == 1) {
+        respond("loglevel %d", static_cast<int>(Logger::getLogLevel()));
+        return;
+    }
+
+    long level;
+    if (argc != 2 || !parseLong(argv[1], level) || level < LOG_NONE || level > LOG_DEBUG) {
+        respond("error: usage loglevel [0-4]");
+        return;
+    }
+    if (!Logger::isCompiled(static_cast<LogLevel>(level))) {
+        respond("error: this build profile logs up to level %d", static_cast<int>(ACTIVE_PROFILE.maxLogLevel));
+        return;
+    }
+    Logger::setLogLevel(static_cast<LogLevel>(level));
+    respond("ok");
+}
+
+/**
+ * @brief Shows or sets an alert threshold.
+ *
+ * The exposure bands follow the alert thresholds.
+ *
+ * @param argc Number of words.
+ * @param argv The words; argv[1] selects the threshold, argv[2] is the new value in ppm.
+ */
+void SerialConsole::cmdThreshold(int argc, char* argv[]) {
+    if (argc == 1) {
+        respond("threshold moderate %.0f critical %.0f ppm",
+                alertMonitor.getModerateThreshold(), alertMonitor.getCriticalThreshold());
+        return;
+    }
+
+    float value;
+    if (argc != 3 || !parseFloat(argv[2], value)) {
+        respond("error: usage threshold [moderate|critical <ppm>]");
+        return;
+    }
+
+    float moderate = alertMonitor.getModerateThreshold();
+    float critical = alertMonitor.getCriticalThreshold();
+    if (strcmp(argv[1], "moderate") == 0) {
+        moderate = value;
+    } else if (strcmp(argv[1], "critical") == 0) {
+        critical = value;
+    } else {
+        respond("error: usage threshold [moderate|critical <ppm>]");
+        return;
+    }
+
+    if (!alertMonitor.setThresholds(moderate, critical)) {
+        respond("error: thresholds must satisfy 0 < moderate < critical");
+        return;
+    }
+    exposureAccumulator.setThresholds(moderate, critical);
+    if (sensorGroup != nullptr) {
+        sensorGroup->setThresholds(moderate, critical);
+    }
+    respond("ok");
+}
+
+/**
+ * @brief Shows or sets the blink interval of warnings.
+ *
+ * @param argc Number of words.
+ * @param argv The words; argv[1] is the optional new interval in ms.
+ */
+void SerialConsole::cmdInterval(int argc, char* argv[]) {
+    if (argc == 1) {
+        respond("interval %lu ms", displayManager.getBlinkInterval());
+        return;
+    }
+
+    long interval;
+    if (argc != 2 || !parseLong(argv[1], interval) || interval <= 0) {
+        respond("error: usage interval [<ms>]");
+        return;
+    }
+    displayManager.setBlinkInterval(static_cast<unsigned long>(interval));
+    respond("ok");
+}
+
+/**
+ * @brief Forces an SCD30 recalibration to `FRESH_AIR_CO2`.
+ *
+ * @param argc Number of words.
+ * @param argv The words; argv[1] is the room number (from 1) in multi-room builds.
+ */
+void SerialConsole::cmdCalibrate(int argc, char* argv[]) {
+    SensorManager* target = &sensorManager;
+    if (sensorGroup != nullptr) {
+        long room;
+        if (argc != 2 || !parseLong(argv[1], room) || room < 1 || room > sensorGroup->getRoomCount()) {
+            respond("error: usage calibrate <room 1-%u>", static_cast<unsigned>(sensorGroup->getRoomCount()));
+            return;
+        }
+        uint8_t index = static_cast<uint8_t>(room - 1);
+        if (!sensorGroup->getRoom(index).online || !sensorGroup->selectRoom(index)) {
+            respond("error: room %ld is offline", room);
+            return;
+        }
+        target = &roomSensors[index];
+    } else if (argc != 1) {
+        respond("error: usage calibrate");
+        return;
+    }
+
+    if (!target->calibrateSCD30()) {
+        respond("error: calibration failed");
+        return;
+    }
+    respond("ok");
+}
+
+/**
+ * @brief Clears the calibration flag so the next boot recalibrates.
+ */
+void SerialConsole::cmdResetCalibration(int, char*[]) {
+    sensorManager.resetCalibrationFlag();
+    respond("ok");
+}
+
+/**
+ * @brief Prints runtime statistics.
+ */
+void SerialConsole::cmdStats(int, char*[]) {
+    respond("uptime %lu s, free heap %lu bytes", millis() / 1000,
+            static_cast<unsigned long>(ESP.getFreeHeap()));
+    if (sensorGroup != nullptr) {
+        printRoomStats();
+    } else {
+        respond("alert level %d (moderate %.0f, critical %.0f ppm)", static_cast<int>(alertMonitor.getLevel()),
+                alertMonitor.getModerateThreshold(), alertMonitor.getCriticalThreshold());
+
+        const ExposureTotals& today = exposureAccumulator.getDay();
+        respond("exposure today: moderate %.2f ppm*h / %.1f min", today.ppmHours[EXPOSURE_MODERATE],
+                today.secondsAbove[EXPOSURE_MODERATE] / 60.0f);
+        respond("exposure today: critical %.2f ppm*h / %.1f min", today.ppmHours[EXPOSURE_CRITICAL],
+                today.secondsAbove[EXPOSURE_CRITICAL] / 60.0f);
+
+        if (ventilationEstimator.hasEstimate()) {
+            respond("ventilation: %.2f air changes/h (R2 %.2f)",
+                    ventilationEstimator.getLastAirChangeRate(), ventilationEstimator.getLastFitQuality());
+        } else {
+            respond("ventilation: no estimate yet");
+        }
+
+        const PressureCompensationStats& pressure = pressureCompensator.getStatistics();
+        respond("pressure compensation: %lu writes, %lu failed, %lu avoided",
+                static_cast<unsigned long>(pressure.writes), static_cast<unsigned long>(pressure.failures),
+                static_cast<unsigned long>(pressure.skippedDeadband + pressure.skippedRateLimit));
+        respond("pressure compensation: %lu readings rejected", static_cast<unsigned long>(pressure.rejected));
+    }
+
+    respond("history: %lu samples in %lu bytes (%u blocks), %lu recorded",
+            static_cast<unsigned long>(historyArchive.getStoredSamples()),
+            static_cast<unsigned long>(historyArchive.getStoredBytes()),
+            static_cast<unsigned>(historyArchive.getBlockCount()),
+            static_cast<unsigned long>(historyArchive.getTotalSamples()));
+
+    const MqttPublisherStats& mqtt = mqttPublisher.getStatistics();
+    respond("mqtt: %lu published, %lu failed, %lu dropped, %lu rejected",
+            static_cast<unsigned long>(mqtt.published), static_cast<unsigned long>(mqtt.failures),
+            static_cast<unsigned long>(mqtt.dropped), static_cast<unsigned long>(mqtt.rejected));
+    respond("mqtt: queue %u (max %u), %.2f msg/s", static_cast<unsigned>(mqtt.queueDepth),
+            static_cast<unsigned>(mqtt.maxQueueDepth), mqtt.messagesPerSecond);
+
+    respond("trace: %s, %lu events (%lu samples) in %lu bytes (%u blocks)",
+            traceRecorder.isRecording() ? "recording" : "stopped",
+            static_cast<unsigned long>(traceRecorder.getTotalEvents()),
+            static_cast<unsigned long>(traceRecorder.getTotalSamples()),
+            static_cast<unsigned long>(traceRecorder.getStoredBytes()),
+            static_cast<unsigned>(traceRecorder.getBlockCount()));
+
+    const PageManagerStats& display = pageManager.getStatistics();
+    respond("display: page %u, %lu renders, %lu switches", static_cast<unsigned>(pageManager.getCurrentPage()),
+            static_cast<unsigned long>(display.renders), static_cast<unsigned long>(display.switches));
+    respond("display: render last %lu us, max %lu us", static_cast<unsigned long>(display.lastRenderUs),
+            static_cast<unsigned long>(display.maxRenderUs));
+    respond("display: background %lu hits, %lu misses", static_cast<unsigned long>(display.backgroundHits),
+            static_cast<unsigned long>(display.backgroundMisses));
+
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        const PipelineStageTiming& timing = measurementPipeline.getTiming(static_cast<PipelineStage>(stage));
+        respond("stage %s: last %lu us, mean %lu us, max %lu us",
+                MeasurementPipeline::getStageName(static_cast<PipelineStage>(stage)),
+                static_cast<unsigned long>(timing.lastUs),
+                static_cast<unsigned long>(timing.count > 0 ? timing.totalUs / timing.count : 0),
+                static_cast<unsigned long>(timing.maxUs));
+    }
+}
+
+/**
+ * @brief Prints one line per room and the bus traffic of a multi-room build.
+ */
+void SerialConsole::printRoomStats() {
+    respond("thresholds: moderate %.0f, critical %.0f ppm", alertMonitor.getModerateThreshold(),
+            alertMonitor.getCriticalThreshold());
+    for (uint8_t i = 0; i < sensorGroup->getRoomCount(); i++) {
+        const SensorRoom& room = sensorGroup->getRoom(i);
+        respond("room %u: %s, CO2 %.0f ppm, alert level %d, %lu samples, %lu not ready", i + 1U,
+                room.online ? "online" : "offline", room.co2, static_cast<int>(room.alertMonitor.getLevel()),
+                static_cast<unsigned long>(room.samples), static_cast<unsigned long>(room.notReady));
+    }
+    const SensorGroupStats& bus = sensorGroup->getStatistics();
+    respond("rooms: %lu passes, %lu channel switches, %lu data checks",
+            static_cast<unsigned long>(bus.passes), static_cast<unsigned long>(bus.channelSwitches),
+            static_cast<unsigned long>(bus.dataChecks));
+    respond("rooms: %lu restart attempts", static_cast<unsigned long>(bus.restarts));
+}
+
+/**
+ * @brief Starts or stops the trace recording, or shows its state.
+ *
+ * Starting discards the previous trace.
+ *
+ * @param argc Number of words.
+ * @param argv The words; argv[1] is `start` or `stop`.
+ */
+void SerialConsole::cmdTrace(int argc, char* argv[]) {
+    if constexpr (!ACTIVE_PROFILE.traceRecorder) {
+        respond("error: tracing is not included in this build profile");
+        return;
+    }
+    if (argc == 1) {
+        respond("trace %s, %lu events", traceRecorder.isRecording() ? "recording" : "stopped",
+                static_cast<unsigned long>(traceRecorder.getTotalEvents()));
+        return;
+    }
+
+    if (argc == 2 && strcmp(argv[1], "start") == 0) {
+        traceDumpIndex = -1;
+        traceRecorder.start();
+    } else if (argc == 2 && strcmp(argv[1], "stop") == 0) {
+        traceRecorder.stop();
+    } else {
+        respond("error: usage trace [start|stop]");
+        return;
+    }
+    respond("ok");
+}
+
+/**
+ * @brief Starts a history dump; one entry or block is emitted per `poll()`.
+ *
+ * @param argc Number of words.
+ * @param argv The words; argv[1] is `history` for the exposure rollups, `compressed`
+ *             for the compressed readings or `trace` for the recorded sensor trace.
+ */
+void SerialConsole::cmdDump(int argc, char* argv[]) {
+    if (argc == 2 && strcmp(argv[1], "history") == 0) {
+        blockDumpIndex = -1;
+        traceDumpIndex = -1;
+        dumpIndex = 0;
+    } else if (argc == 2 && strcmp(argv[1], "compressed") == 0) {
+        dumpIndex = -1;
+        traceDumpIndex = -1;
+        blockDumpIndex = 0;
+    } else if (argc == 2 && strcmp(argv[1], "trace") == 0) {
+        dumpIndex = -1;
+        blockDumpIndex = -1;
+        traceDumpIndex = 0;
+    } else {
+        respond("error: usage dump history|compressed|trace");
+    }
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#include "Tca9548aMux.h"
+
+/**
+ * @file Tca9548aMux.cpp
+ * @brief Implements the TCA9548A channel selection.
+ */
+
+/**
+ * @brief Constructs the multiplexer.
+ *
+ * @param wire The upstream bus.
+ * @param address The I2C address (0x70 to 0x77).
+ */
+Tca9548aMux::Tca9548aMux(TwoWire& wire, uint8_t address) : wire(wire), address(address) {}
+
+/**
+ * @brief Routes the I2C bus to one channel.
+ *
+ * The control register holds one enable bit per channel; exactly one is set.
+ *
+ * @param channel The channel (0 to 7).
+ * @return `true` if the multiplexer acknowledged, `false` otherwise.
+ */
+bool Tca9548aMux::selectChannel(uint8_t channel) {
+    if (channel >= SENSOR_GROUP_MAX_ROOMS) {
+        return false;
+    }
+    wire.beginTransmission(address);
+    wire.write(static_cast<uint8_t>(1 << channel));
+    return wire.endTransmission() == 0;
+}
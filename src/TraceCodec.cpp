@@ -0,0 +1,201 @@
+#include "TraceCodec.h"
+#include <string.h>
+
+/**
+ * @file TraceCodec.cpp
+ * @brief Implements the trace block codec.
+ */
+
+/**
+ * @brief Writes a LEB128 varint.
+ *
+ * @param value The value.
+ * @param out Receives the bytes; at least 5 bytes must be available.
+ * @return The number of bytes written.
+ */
+static size_t writeVarint(uint32_t value, uint8_t* out) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = static_cast<uint8_t>(value);
+    return length;
+}
+
+/**
+ * @brief Maps a signed difference to an unsigned number with small magnitudes first.
+ */
+static inline uint32_t zigzagEncode(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+/**
+ * @brief Inverts `zigzagEncode()`.
+ */
+static inline int32_t zigzagDecode(uint32_t value) {
+    return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+/**
+ * @brief Constructs an empty block.
+ */
+TraceEncoder::TraceEncoder() {
+    reset();
+}
+
+/**
+ * @brief Discards the block contents.
+ */
+void TraceEncoder::reset() {
+    memset(buffer, 0, sizeof(buffer));
+    buffer[0] = TRACE_FORMAT_VERSION;
+    size = TRACE_HEADER_BYTES;
+    eventCount = 0;
+    lastTimestamp = 0;
+    memset(lastValues, 0, sizeof(lastValues));
+}
+
+/**
+ * @brief Appends one event.
+ *
+ * The event is encoded into a scratch buffer first, so a block never holds a partial event.
+ *
+ * @param event The event; its timestamp must not precede the previous one.
+ * @return `true` if the event was stored, `false` if the block is full.
+ */
+bool TraceEncoder::append(const TraceEvent& event) {
+    if (eventCount == UINT16_MAX) {
+        return false;
+    }
+
+    uint8_t scratch[TRACE_MAX_EVENT_BYTES];
+    int32_t values[HISTORY_CHANNEL_COUNT];
+    uint32_t delta = event.timestampMs - lastTimestamp;
+    // Deltas beyond 2^31 ms (25 days) cannot be tagged; they only occur across a millis() wrap
+    size_t length = writeVarint(((delta & 0x7FFFFFFFUL) << 1) | (event.type == TRACE_SAMPLE ? 1 : 0), scratch);
+    length += writeVarint(event.pollMicros, scratch + length);
+    if (event.type == TRACE_SAMPLE) {
+        for (int i = 0; i < HISTORY_CHANNEL_COUNT; i++) {
+            values[i] = quantizeReading(event.values[i]);
+            length += writeVarint(zigzagEncode(values[i] - lastValues[i]), scratch + length);
+        }
+    }
+
+    if (size + length > sizeof(buffer)) {
+        return false;
+    }
+    memcpy(buffer + size, scratch, length);
+    size += length;
+    lastTimestamp = event.timestampMs;
+    if (event.type == TRACE_SAMPLE) {
+        memcpy(lastValues, values, sizeof(lastValues));
+    }
+
+    eventCount++;
+    buffer[2] = static_cast<uint8_t>(eventCount >> 8);
+    buffer[3] = static_cast<uint8_t>(eventCount);
+    return true;
+}
+
+/**
+ * @brief Retrieves the encoded block.
+ */
+const uint8_t* TraceEncoder::getData() const {
+    return buffer;
+}
+
+/**
+ * @brief Retrieves the size of the encoded block in bytes.
+ */
+size_t TraceEncoder::getSize() const {
+    return size;
+}
+
+/**
+ * @brief Retrieves the number of events in the block.
+ */
+uint16_t TraceEncoder::getEventCount() const {
+    return eventCount;
+}
+
+/**
+ * @brief Starts decoding a block.
+ *
+ * @param data The encoded block.
+ * @param size The size of the block in bytes.
+ * @return `true` if the header is valid, `false` otherwise.
+ */
+bool TraceDecoder::begin(const uint8_t* data, size_t size) {
+    this->data = data;
+    this->size = size;
+    position = TRACE_HEADER_BYTES;
+    eventsRead = 0;
+    lastTimestamp = 0;
+    memset(lastValues, 0, sizeof(lastValues));
+
+    if (size < TRACE_HEADER_BYTES || data[0] != TRACE_FORMAT_VERSION) {
+        eventCount = 0;
+        return false;
+    }
+    eventCount = static_cast<uint16_t>((data[2] << 8) | data[3]);
+    return true;
+}
+
+/**
+ * @brief Reads one LEB128 varint.
+ *
+ * @param value Receives the value.
+ * @return `true` on success, `false` if the block ends early.
+ */
+bool TraceDecoder::readVarint(uint32_t& value) {
+    value = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7) {
+        if (position >= size) {
+            return false;
+        }
+        uint8_t byte = data[position++];
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Decodes the next event.
+ *
+ * @param event Receives the event.
+ * @return `true` if an event was decoded, `false` at the end of the block or on corrupt data.
+ */
+bool TraceDecoder::next(TraceEvent& event) {
+    uint32_t tagged;
+    if (eventsRead >= eventCount || !readVarint(tagged) || !readVarint(event.pollMicros)) {
+        return false;
+    }
+
+    lastTimestamp += tagged >> 1;
+    event.timestampMs = lastTimestamp;
+    event.type = (tagged & 1) ? TRACE_SAMPLE : TRACE_POLL_EMPTY;
+    for (int i = 0; i < HISTORY_CHANNEL_COUNT; i++) {
+        if (event.type == TRACE_SAMPLE) {
+            uint32_t zigzag;
+            if (!readVarint(zigzag)) {
+                return false;
+            }
+            lastValues[i] += zigzagDecode(zigzag);
+        }
+        event.values[i] = static_cast<float>(lastValues[i]) / HISTORY_VALUE_RESOLUTION;
+    }
+
+    eventsRead++;
+    return true;
+}
+
+/**
+ * @brief Retrieves the number of events announced by the header.
+ */
+uint16_t TraceDecoder::getEventCount() const {
+    return eventCount;
+}
@@ -0,0 +1,98 @@
+#include "TraceRecorder.h"
+
+/**
+ * @file TraceRecorder.cpp
+ * @brief Implements the ring of trace blocks.
+ */
+
+/**
+ * @brief Discards the previous trace and starts recording.
+ */
+void TraceRecorder::start() {
+    blocks[0].reset();
+    newest = 0;
+    count = 1;
+    events = 0;
+    samples = 0;
+    recording = true;
+}
+
+/**
+ * @brief Stops recording and keeps the trace for export.
+ */
+void TraceRecorder::stop() {
+    recording = false;
+}
+
+/**
+ * @brief Checks whether events are being recorded.
+ */
+bool TraceRecorder::isRecording() const {
+    return recording;
+}
+
+/**
+ * @brief Records one event if recording, starting a new block if the current one is full.
+ *
+ * @param event The event.
+ */
+void TraceRecorder::record(const TraceEvent& event) {
+    if (!recording) {
+        return;
+    }
+
+    if (!blocks[newest].append(event)) {
+        newest = (newest + 1) % BLOCK_COUNT;
+        if (count < BLOCK_COUNT) {
+            count++;
+        }
+        blocks[newest].reset();
+        blocks[newest].append(event);
+    }
+    events++;
+    if (event.type == TRACE_SAMPLE) {
+        samples++;
+    }
+}
+
+/**
+ * @brief Retrieves the number of blocks in use.
+ */
+uint8_t TraceRecorder::getBlockCount() const {
+    return count;
+}
+
+/**
+ * @brief Retrieves a block.
+ *
+ * @param index 0 for the oldest block up to `getBlockCount()` - 1 for the newest.
+ * @return The block.
+ */
+const TraceEncoder& TraceRecorder::getBlock(uint8_t index) const {
+    return blocks[(newest + BLOCK_COUNT + 1 - count + index) % BLOCK_COUNT];
+}
+
+/**
+ * @brief Retrieves the number of events recorded since the last start.
+ */
+uint32_t TraceRecorder::getTotalEvents() const {
+    return events;
+}
+
+/**
+ * @brief Retrieves the number of samples recorded since the last start.
+ */
+uint32_t TraceRecorder::getTotalSamples() const {
+    return samples;
+}
+
+/**
+ * @brief Retrieves the number of encoded bytes currently held.
+ */
+uint32_t TraceRecorder::getStoredBytes() const {
+    uint32_t bytes = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        bytes += getBlock(i).getSize();
+    }
+    return bytes;
+}
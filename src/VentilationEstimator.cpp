@@ -0,0 +1,212 @@
+#include "VentilationEstimator.h"
+#include "Logger.h"
+#include <math.h>
+#include <stdio.h>
+
+/**
+ * @file VentilationEstimator.cpp
+ * @brief Implements the online air change rate estimation from CO2 decay episodes.
+ */
+
+/**
+ * @brief Constructs the estimator.
+ *
+ * @param outdoorCO2 The CO2 level the decay converges to in ppm.
+ */
+VentilationEstimator::VentilationEstimator(float outdoorCO2)
+    : outdoorCO2(outdoorCO2) {}
+
+/**
+ * @brief Feeds one CO2 sample into the estimator.
+ *
+ * While idle, the estimator tracks the running peak of the smoothed CO2 signal. An episode
+ * opens once the concentration has dropped `VENT_DECAY_START_DROP` below that peak, and
+ * closes when it rises `VENT_RISE_TOLERANCE` above the episode minimum (windows closed,
+ * people returning) or approaches outdoor level, where the logarithm is dominated by noise.
+ *
+ * @param co2 The CO2 concentration in ppm.
+ * @param timestampMs The sample timestamp in ms (e.g. from `millis()`).
+ * @return `true` if this sample completed an episode with a valid estimate.
+ */
+bool VentilationEstimator::addSample(float co2, unsigned long timestampMs) {
+    if (hasLastSample && timestampMs - lastTimestamp > VENT_MAX_SAMPLE_GAP_MS) {
+        if (episodeActive) {
+            Logger::debug("Ventilation episode aborted: sample gap too large.");
+        }
+        reset();
+    }
+
+    // Episode boundaries are detected on a smoothed signal so sensor noise cannot open
+    // or close episodes; the fit itself uses the raw samples.
+    if (!hasLastSample) {
+        smoothedCO2 = co2;
+    } else {
+        smoothedCO2 += VENT_SMOOTHING_FACTOR * (co2 - smoothedCO2);
+    }
+    bool firstSample = !hasLastSample;
+    hasLastSample = true;
+    lastTimestamp = timestampMs;
+
+    if (!episodeActive) {
+        if (firstSample || smoothedCO2 >= peakCO2) {
+            peakCO2 = smoothedCO2;
+        } else if (peakCO2 - smoothedCO2 >= VENT_DECAY_START_DROP &&
+                   smoothedCO2 - outdoorCO2 > VENT_MIN_EXCESS) {
+            startEpisode(co2, timestampMs);
+        }
+        return false;
+    }
+
+    if (smoothedCO2 > minCO2 + VENT_RISE_TOLERANCE || smoothedCO2 - outdoorCO2 <= VENT_MIN_EXCESS) {
+        bool valid = finishEpisode();
+        peakCO2 = smoothedCO2;
+        return valid;
+    }
+
+    if (co2 - outdoorCO2 > 0.0f) {
+        addPoint(co2, timestampMs);
+    }
+    if (smoothedCO2 < minCO2) {
+        minCO2 = smoothedCO2;
+    }
+    return false;
+}
+
+/**
+ * @brief Starts a new episode with the given sample as its first point.
+ *
+ * @param co2 The CO2 concentration in ppm.
+ * @param timestampMs The sample timestamp in ms.
+ */
+void VentilationEstimator::startEpisode(float co2, unsigned long timestampMs) {
+    Logger::debug("Ventilation episode started.");
+    episodeActive = true;
+    episodeStart = timestampMs;
+    minCO2 = smoothedCO2;
+    count = 0;
+    episodeSeconds = 0.0f;
+    meanT = 0.0f;
+    meanY = 0.0f;
+    coMomentTY = 0.0f;
+    momentTT = 0.0f;
+    momentYY = 0.0f;
+    addPoint(co2, timestampMs);
+}
+
+/**
+ * @brief Adds one point to the running regression.
+ *
+ * Uses Welford-style updates of the means and co-moments, which stay numerically
+ * stable in single precision even for episodes lasting several hours.
+ *
+ * @param co2 The CO2 concentration in ppm.
+ * @param timestampMs The sample timestamp in ms.
+ */
+void VentilationEstimator::addPoint(float co2, unsigned long timestampMs) {
+    float t = (timestampMs - episodeStart) / 1000.0f;
+    float y = logf(co2 - outdoorCO2);
+
+    count++;
+    float dt = t - meanT;
+    float dy = y - meanY;
+    meanT += dt / count;
+    meanY += dy / count;
+    coMomentTY += dt * (y - meanY);
+    momentTT += dt * (t - meanT);
+    momentYY += dy * (y - meanY);
+    episodeSeconds = t;
+}
+
+/**
+ * @brief Closes the running episode and evaluates the fit.
+ *
+ * The slope of the log excess over time is the negative air change rate per second.
+ * Episodes that are too short, not decaying or fitting poorly are discarded.
+ *
+ * @return `true` if the episode produced a valid estimate, `false` otherwise.
+ */
+bool VentilationEstimator::finishEpisode() {
+    episodeActive = false;
+
+    if (count < VENT_MIN_SAMPLES || episodeSeconds < VENT_MIN_DURATION_S ||
+        momentTT <= 0.0f || momentYY <= 0.0f) {
+        Logger::debug("Ventilation episode discarded: too short.");
+        return false;
+    }
+
+    float slope = coMomentTY / momentTT;
+    float fitQuality = (coMomentTY * coMomentTY) / (momentTT * momentYY);
+    if (slope >= 0.0f || fitQuality < VENT_MIN_FIT_QUALITY) {
+        Logger::debug("Ventilation episode discarded: poor fit.");
+        return false;
+    }
+
+    estimateAvailable = true;
+    lastAirChangeRate = -slope * 3600.0f;
+    lastFitQuality = fitQuality;
+    lastEpisodeMinutes = episodeSeconds / 60.0f;
+
+    if (Logger::isEnabled(LOG_INFO)) {
+        char buffer[80];
+        snprintf(buffer, sizeof(buffer), "Ventilation: %.2f air changes/h over %.1f min (R2 %.2f)",
+                 lastAirChangeRate, lastEpisodeMinutes, lastFitQuality);
+        Logger::info(buffer);
+    }
+    return true;
+}
+
+/**
+ * @brief Discards the running episode and the detection state.
+ *
+ * The result of the last completed episode is kept.
+ */
+void VentilationEstimator::reset() {
+    episodeActive = false;
+    hasLastSample = false;
+    count = 0;
+}
+
+/**
+ * @brief Checks whether a decay episode is currently being fitted.
+ *
+ * @return `true` while an episode is active.
+ */
+bool VentilationEstimator::isEpisodeActive() const {
+    return episodeActive;
+}
+
+/**
+ * @brief Checks whether at least one valid estimate has been produced.
+ *
+ * @return `true` if the last-episode getters hold valid data.
+ */
+bool VentilationEstimator::hasEstimate() const {
+    return estimateAvailable;
+}
+
+/**
+ * @brief Retrieves the air change rate of the last valid episode.
+ *
+ * @return The air change rate in 1/h.
+ */
+float VentilationEstimator::getLastAirChangeRate() const {
+    return lastAirChangeRate;
+}
+
+/**
+ * @brief Retrieves the fit quality of the last valid episode.
+ *
+ * @return The coefficient of determination (R^2) of the log-linear fit.
+ */
+float VentilationEstimator::getLastFitQuality() const {
+    return lastFitQuality;
+}
+
+/**
+ * @brief Retrieves the duration of the last valid episode.
+ *
+ * @return The episode duration in minutes.
+ */
+float VentilationEstimator::getLastEpisodeMinutes() const {
+    return lastEpisodeMinutes;
+}
\ No newline at end of file
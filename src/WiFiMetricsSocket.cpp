@@ -0,0 +1,86 @@
+#include "WiFiMetricsSocket.h"
+
+/**
+ * @file WiFiMetricsSocket.cpp
+ * @brief Implements the metrics server socket on the ESP8266 WiFi stack.
+ */
+
+/**
+ * @brief Constructs the socket.
+ *
+ * @param port The TCP port to listen on.
+ */
+WiFiMetricsSocket::WiFiMetricsSocket(uint16_t port)
+    : server(port) {}
+
+/**
+ * @brief Starts listening.
+ *
+ * The socket can be opened before WiFi is associated; connections arrive once it is.
+ */
+void WiFiMetricsSocket::begin() {
+    server.begin();
+}
+
+/**
+ * @brief Accepts a waiting connection without blocking.
+ *
+ * @return `true` if a connection was accepted, `false` if none is waiting.
+ */
+bool WiFiMetricsSocket::accept() {
+    client = server.accept();
+    if (!client) {
+        return false;
+    }
+    client.setNoDelay(true);
+    return true;
+}
+
+/**
+ * @brief Retrieves the number of received bytes that can be read.
+ */
+int WiFiMetricsSocket::available() {
+    return client.available();
+}
+
+/**
+ * @brief Reads one received byte.
+ *
+ * @return The byte, or -1 if none is available.
+ */
+int WiFiMetricsSocket::read() {
+    return client.read();
+}
+
+/**
+ * @brief Retrieves the number of bytes the send buffer accepts without blocking.
+ */
+size_t WiFiMetricsSocket::availableForWrite() {
+    return client.availableForWrite();
+}
+
+/**
+ * @brief Queues bytes for sending.
+ *
+ * @param data The bytes.
+ * @param length The number of bytes.
+ * @return The number of bytes queued.
+ */
+size_t WiFiMetricsSocket::write(const uint8_t* data, size_t length) {
+    return client.write(data, length);
+}
+
+/**
+ * @brief Checks whether the peer is still connected or unread data remains.
+ */
+bool WiFiMetricsSocket::connected() {
+    return client.connected();
+}
+
+/**
+ * @brief Closes the connection without waiting for the queued data to be acknowledged.
+ */
+void WiFiMetricsSocket::close() {
+    // Queued data is still sent after the close
+    client.stop(1);
+}
\ No newline at end of file
@@ -1,131 +1,663 @@
-#include <Wire.h>
-#include <Adafruit_GFX.h>
-#include <Adafruit_SSD1306.h>
-#include <Adafruit_BMP280.h>
-#include <SparkFun_SCD30_Arduino_Library.h>
-#include <EEPROM.h> // Include EEPROM library
-#include "config.h" // Include the configuration file
-#include "DisplayManager.h"
-#include "SensorManager.h"
-#include "Logger.h"
-#include <Arduino.h>
-#include "I2CScanner.h"
-
-/**
- * @file main.cpp
- * @brief Main entry point for the CO2 Meter application.
- * 
- * This file initializes the system, including the display, sensors, and logger.
- * It continuously retrieves sensor data, logs it, and displays warnings or normal readings
- * based on CO2 levels.
- */
-
-/**
- * @brief Instance of the DisplayManager class for managing the OLED display.
- */
-DisplayManager displayManager;
-
-/**
- * @brief Instance of the SensorManager class for managing the SCD30 and BMP280 sensors.
- */
-SensorManager sensorManager;
-
-/**
- * @brief Instance of the I2CScanner class for scanning the I2C bus.
- */
-I2CScanner i2cScanner;
-
-/**
- * @brief Initializes the system, including the display, sensors, and logger.
- * 
- * This function sets up the serial communication, initializes the display and sensors,
- * and performs a calibration check for the SCD30 sensor. If any initialization fails,
- * the system halts.
- */
-void setup() {
-    Serial.begin(115200);
-    while (!Serial);
-
-    Logger::error("This is test error message.");    // Should always print
-    Logger::warning("This test a warning message."); // Should not print if LOG_LEVEL=LOG_ERROR
-    Logger::info("This is test info message.");      // Should not print if LOG_LEVEL=LOG_ERROR
-    Logger::debug("This is test debug message.");    // Should not print if LOG_LEVEL=LOG_ERROR
-
-    Logger::info("Initializing...");
-
-#if RUN_I2C_SCANNER == TRUE
-    i2cScanner.scan();
-#endif
-
-    // Initialize the display
-    if (!displayManager.initialize()) {
-        Logger::error("Display initialization failed!");
-        for (;;); // Halt if display initialization fails
-    }
-
-#if RUN_DISPLAY_CHECK == TRUE
-    displayManager.runDisplayCheck();
-#endif
-
-    displayManager.splashScreen("Initializing...");
-    delay(2000);
-
-    // Initialize sensors
-    if (!sensorManager.initializeSensors()) {
-        displayManager.splashScreen("Sensor init failed!");
-        Logger::info("Sensor init failed!");
-        for (;;); // Halt if sensor initialization fails
-    }
-
-    // Check and calibrate the SCD30 sensor
-    sensorManager.checkAndCalibrateSCD30();
-    Logger::info("Initialization complete.");
-}
-
-/**
- * @brief Main loop for retrieving sensor data and updating the display.
- * 
- * This function continuously retrieves sensor data, logs the readings, and updates the display.
- * It displays warnings if CO2 levels exceed predefined thresholds or normal readings otherwise.
- */
-void loop() {
-    Logger::debug("Entering loop...");
-
-    if (sensorManager.isDataAvailable()) {
-        Logger::debug("Sensor data is available.");
-
-        // Retrieve sensor readings
-        float co2 = sensorManager.getCO2();
-        float temperatureSCD = sensorManager.getTemperatureSCD();
-        float humidity = sensorManager.getHumidity();
-        float temperatureBMP = sensorManager.getTemperatureBMP();
-        float pressure = sensorManager.getPressure();
-
-        Logger::debug("Sensor readings retrieved.");
-        Logger::info(("CO2: " + String(co2) + " ppm").c_str());
-        Logger::info(("Temperature (SCD30): " + String(temperatureSCD) + " °C").c_str());
-        Logger::info(("Temperature (BMP280): " + String(temperatureBMP) + " °C").c_str());
-        Logger::info(("Humidity: " + String(humidity) + " %").c_str());
-        Logger::info(("Pressure: " + String(pressure) + " hPa").c_str());
-
-        // Display warnings or normal readings based on CO2 levels
-        if (co2 > CO2_CRITICAL_THRESHOLD) {
-            Logger::warning("CRITICAL: High CO2 levels!");
-            displayManager.showBlinkingWarning(
-                "CRITICAL:", "High CO2", "levels!", "",
-                co2, temperatureSCD, temperatureBMP, humidity, pressure);
-        } else if (co2 > CO2_MODERATE_THRESHOLD) {
-            Logger::warning("MODERATE: Elevated CO2 levels!");
-            displayManager.showBlinkingWarning(
-                "MODERATE:", "Elevated CO2", "levels!", "",
-                co2, temperatureSCD, temperatureBMP, humidity, pressure);
-        } else {
-            Logger::info("Displaying normal readings.");
-            displayManager.showNormalScreen(co2, temperatureSCD, temperatureBMP, humidity, pressure);
-        }
-    } else {
-        Logger::debug("Sensor data not available.");
-    }
-
-    delay(1000); // Short delay for smoother blinking
+#include <Wire.h>
+#include <Adafruit_GFX.h>
+#include <Adafruit_SSD1306.h>
+#include <Adafruit_BMP280.h>
+#include <SparkFun_SCD30_Arduino_Library.h>
+#include <EEPROM.h> // Include EEPROM library
+#include "config.h" // Include the configuration file
+#include "DisplayManager.h"
+#include "DisplayPage.h"
+#include "MeterPages.h"
+#include "PageManager.h"
+#include "Button.h"
+#include "SensorManager.h"
+#include "Logger.h"
+#include "BuildProfile.h"
+#include <Arduino.h>
+#include "I2CScanner.h"
+#include "VentilationEstimator.h"
+#include "ExposureAccumulator.h"
+#include "SensorFilter.h"
+#include "PressureCompensator.h"
+#include "AlertMonitor.h"
+#include "HistoryArchive.h"
+#include "MetricsPage.h"
+#include "MetricsServer.h"
+#include "WiFiMetricsSocket.h"
+#include "MqttPublisher.h"
+#include "PubSubMqttTransport.h"
+#include "SerialConsole.h"
+#include "TraceRecorder.h"
+#include "MeasurementPipeline.h"
+#include "PowerManager.h"
+#include "EspRtcStore.h"
+#include "SensorGroup.h"
+#include "Tca9548aMux.h"
+
+/**
+ * @file main.cpp
+ * @brief Main entry point for the CO2 Meter application.
+ * 
+ * This file initializes the system, including the display, sensors, and logger.
+ * It continuously retrieves sensor data, logs it, and displays warnings or normal readings
+ * based on CO2 levels.
+ */
+
+/**
+ * @brief Instance of the DisplayManager class for managing the OLED display.
+ */
+DisplayManager displayManager;
+
+/**
+ * @brief Values shown by the display pages.
+ */
+DisplayModel displayModel = {};
+
+/**
+ * @brief Instance of the MeterPages class holding the display pages.
+ */
+MeterPages meterPages(displayModel, displayManager);
+
+#if SENSOR_ROOMS > 1
+/**
+ * @brief Instance of the Tca9548aMux class routing the I2C bus to the rooms.
+ */
+Tca9548aMux roomMux(Wire);
+
+/**
+ * @brief One SensorManager per room, on multiplexer channels 0 to `SENSOR_ROOMS - 1`.
+ */
+SensorManager roomSensors[SENSOR_ROOMS];
+
+/**
+ * @brief Instance of the SensorGroup class polling the rooms.
+ */
+SensorGroup sensorGroup(roomMux, SCD30_INTERVAL_MS);
+
+/**
+ * @brief Instance of the RoomsPage class listing the rooms.
+ */
+RoomsPage roomsPage(sensorGroup);
+
+/**
+ * @brief The pages shown in multi-room mode.
+ */
+DisplayPage* const roomPages[] = { &roomsPage };
+
+/**
+ * @brief Instance of the PageManager class showing the rooms page.
+ */
+PageManager pageManager(displayManager, roomPages, 1, 1);
+#else
+/**
+ * @brief Instance of the PageManager class selecting and rendering the display pages.
+ */
+PageManager pageManager(displayManager, meterPages.getPages(), PAGE_COUNT, PAGE_ROTATION_COUNT);
+#endif
+
+/**
+ * @brief Instance of the Button class debouncing the page button.
+ */
+Button pageButton;
+
+/**
+ * @brief Instance of the SensorManager class for managing the SCD30 and BMP280 sensors.
+ */
+SensorManager sensorManager;
+
+/**
+ * @brief Instance of the PressureCompensator class forwarding the BMP280 pressure to the SCD30.
+ */
+PressureCompensator pressureCompensator(sensorManager);
+
+/**
+ * @brief Instance of the I2CScanner class for scanning the I2C bus.
+ */
+I2CScanner i2cScanner;
+
+/**
+ * @brief Instance of the SensorFilter class for smoothing CO2 and fusing the temperatures.
+ */
+SensorFilter sensorFilter;
+
+/**
+ * @brief Instance of the VentilationEstimator class for estimating the air change rate.
+ */
+VentilationEstimator ventilationEstimator;
+
+/**
+ * @brief Instance of the ExposureAccumulator class for the CO2 exposure rollups.
+ */
+ExposureAccumulator exposureAccumulator;
+
+/**
+ * @brief Instance of the AlertMonitor class holding the runtime alert thresholds.
+ */
+AlertMonitor alertMonitor;
+
+/**
+ * @brief Instance of the HistoryArchive class holding the compressed raw readings.
+ */
+HistoryArchive historyArchive;
+
+/**
+ * @brief Instance of the PubSubMqttTransport class connecting to the MQTT broker over WiFi.
+ */
+PubSubMqttTransport mqttTransport;
+
+/**
+ * @brief Instance of the MqttPublisher class publishing batches of readings.
+ */
+MqttPublisher mqttPublisher(mqttTransport);
+
+/**
+ * @brief Instance of the MetricsPage class holding the pre-rendered Prometheus response.
+ */
+MetricsPage metricsPage;
+
+/**
+ * @brief Instance of the WiFiMetricsSocket class listening for metrics scrapes on METRICS_PORT.
+ */
+WiFiMetricsSocket metricsSocket;
+
+/**
+ * @brief Instance of the MetricsServer class serving the metrics page over HTTP.
+ */
+MetricsServer metricsServer(metricsSocket, metricsPage);
+
+/**
+ * @brief Instance of the TraceRecorder class recording the raw sensor stream on request.
+ */
+TraceRecorder traceRecorder;
+
+/**
+ * @brief Instance of the MeasurementPipeline class running the sensor-to-display path.
+ */
+MeasurementPipeline measurementPipeline(sensorManager, sensorFilter, pressureCompensator,
+                                        exposureAccumulator, ventilationEstimator, alertMonitor,
+                                        pageManager, displayModel, traceRecorder);
+
+/**
+ * @brief Instance of the SerialConsole class for runtime tuning over Serial.
+ */
+SerialConsole serialConsole(Serial, sensorManager, displayManager, alertMonitor,
+                            exposureAccumulator, pressureCompensator, ventilationEstimator,
+                            historyArchive, mqttPublisher, traceRecorder, measurementPipeline,
+                            pageManager);
+
+/**
+ * @brief Longest busy time of a loop iteration since boot in us.
+ */
+unsigned long loopBusyMaxUs = 0;
+
+/**
+ * @brief Number of sensor samples processed since boot.
+ */
+unsigned long samplesProcessed = 0;
+
+/**
+ * @brief Time of the last sensor poll in ms.
+ */
+unsigned long lastSensorPoll = 0;
+
+#if LOW_POWER
+/**
+ * @brief Instance of the EspRtcStore class keeping the retained state in RTC memory.
+ */
+EspRtcStore rtcStore;
+
+/**
+ * @brief Instance of the PowerManager class planning the deep-sleep schedule.
+ */
+PowerManager powerManager(rtcStore);
+
+/**
+ * @brief Maps the reset reason reported by the SDK to the cause of the wake.
+ * 
+ * The wake button is wired to RST, so a button press shows up as an external reset.
+ * 
+ * @return The wake reason; `PowerManager` downgrades it to a cold boot if no valid state is retained.
+ */
+WakeReason readWakeReason() {
+    switch (ESP.getResetInfoPtr()->reason) {
+    case REASON_DEEP_SLEEP_AWAKE:
+        return WAKE_TIMER;
+    case REASON_EXT_SYS_RST:
+        return WAKE_BUTTON;
+    default:
+        return WAKE_COLD_BOOT;
+    }
+}
+
+/**
+ * @brief Takes one sample and feeds it through the filter, compensation, exposure and alert stages.
+ * 
+ * @param state The retained state receiving the readings.
+ * @return `true` if the SCD30 delivered data within `LOW_POWER_DATA_TIMEOUT_MS`, `false` otherwise.
+ */
+bool takeLowPowerSample(RetainedState& state) {
+    unsigned long waitStart = millis();
+    bool available = sensorManager.isDataAvailable();
+    while (!available && millis() - waitStart < LOW_POWER_DATA_TIMEOUT_MS) {
+        delay(LOW_POWER_DATA_POLL_MS);
+        available = sensorManager.isDataAvailable();
+    }
+    if (!available) {
+        state.missedSamples++;
+        Logger::warning("SCD30 data not ready, retrying later.");
+        return false;
+    }
+
+    float co2 = sensorManager.getCO2();
+    float temperatureSCD = sensorManager.getTemperatureSCD();
+    float humidity = sensorManager.getHumidity();
+    float temperatureBMP = sensorManager.getTemperatureBMP();
+    float pressure = sensorManager.getPressure();
+    uint32_t now = powerManager.getTimeMs(millis());
+
+    char buffer[96];
+    if (Logger::isEnabled(LOG_INFO)) {
+        snprintf(buffer, sizeof(buffer), "CO2: %.2f ppm, SCD30: %.2f °C, BMP280: %.2f °C, %.2f %%, %.2f hPa",
+                 co2, temperatureSCD, temperatureBMP, humidity, pressure);
+        Logger::info(buffer);
+    }
+
+    state.lastSample = { now, { co2, temperatureSCD, temperatureBMP, humidity, pressure } };
+    state.samples++;
+
+    sensorFilter.update(co2, temperatureSCD, temperatureBMP);
+    if (pressureCompensator.update(pressure, now)) {
+        pressureCompensator.logStatistics();
+    }
+    exposureAccumulator.addSample(sensorFilter.getCO2(), now);
+    state.alertLevel = alertMonitor.evaluate(sensorFilter.getCO2());
+
+    if (Logger::isEnabled(LOG_INFO)) {
+        snprintf(buffer, sizeof(buffer), "Sample %lu taken %lu ms after wake",
+                 static_cast<unsigned long>(state.samples), millis());
+        Logger::info(buffer);
+    }
+    return true;
+}
+
+/**
+ * @brief Runs one wake of the low-power duty cycle and deep-sleeps until the next one.
+ * 
+ * Replaces the continuous `loop()` when built with `LOW_POWER`. Filter, compensation and
+ * exposure state, the alert thresholds and the calibration flag come from RTC memory, so a
+ * wake only restarts the peripherals and reads the sensors. The display is switched on for
+ * alerts and for `LOW_POWER_BUTTON_DISPLAY_MS` after a button wake, and off otherwise. WiFi
+ * stays off, so MQTT, the metrics endpoint and the history archive are not available.
+ */
+void runLowPowerCycle() {
+    bool restored = powerManager.begin(readWakeReason());
+    RetainedState& state = powerManager.getState();
+    // A wake after a failed sensor start starts the sensors like a cold boot, keeping the clock
+    bool warm = restored && state.sensorsStarted;
+    bool buttonWake = powerManager.getWakeReason() == WAKE_BUTTON;
+
+    bool displayReady = false;
+    if (!warm || buttonWake || state.displayOn) {
+        displayReady = displayManager.initialize();
+    }
+
+    if (!warm) {
+        Logger::info("Low-power mode, cold boot.");
+        WiFi.mode(WIFI_OFF);
+        WiFi.forceSleepBegin();
+        if (displayReady) {
+            displayManager.splashScreen("Low power mode");
+        }
+    }
+
+    // A running SCD30 measurement is kept across wakes so its data is ready on arrival
+    if (!sensorManager.initializeSensors(!warm)) {
+        Logger::error("Sensor init failed, retrying after sleep.");
+        // Without a save the retry would restore the previous record and its clock
+        powerManager.save(millis(), LOW_POWER_RETRY_MS);
+        Serial.flush();
+        ESP.deepSleep(LOW_POWER_RETRY_MS * 1000ULL, WAKE_RF_DISABLED);
+    }
+    state.sensorsStarted = 1;
+
+    EEPROM.begin(EEPROM_SIZE);
+    exposureAccumulator.begin();
+    if (warm) {
+        sensorFilter.setState(state.filter);
+        pressureCompensator.setState(state.pressure);
+        exposureAccumulator.setRunningState(state.exposure);
+        alertMonitor.setThresholds(state.moderateThreshold, state.criticalThreshold);
+        exposureAccumulator.setThresholds(state.moderateThreshold, state.criticalThreshold);
+    } else {
+        sensorManager.setMeasurementInterval(LOW_POWER_SAMPLE_INTERVAL_MS / 1000);
+    }
+
+    if (!state.calibrated) {
+        sensorManager.checkAndCalibrateSCD30();
+        state.calibrated = 1;
+    }
+
+    if (buttonWake) {
+        powerManager.holdDisplay(millis(), LOW_POWER_BUTTON_DISPLAY_MS);
+    }
+    if (powerManager.isSampleDue(millis()) && takeLowPowerSample(state)) {
+        powerManager.sampleTaken(millis());
+    }
+
+    AlertLevel alertLevel = static_cast<AlertLevel>(state.alertLevel);
+    bool displayOn = alertLevel != ALERT_NONE || powerManager.isDisplayHeld(millis());
+    if (displayReady) {
+        const float* values = state.lastSample.values;
+        float co2 = sensorFilter.getCO2();
+        float temperatureSCD = sensorFilter.compensateTemperatureSCD(values[HISTORY_TEMP_SCD]);
+        if (alertLevel == ALERT_CRITICAL) {
+            displayManager.showWarning("CRITICAL:", "High CO2", "levels!", "");
+        } else if (alertLevel == ALERT_MODERATE) {
+            displayManager.showWarning("MODERATE:", "Elevated CO2", "levels!", "");
+        } else if (displayOn) {
+            displayManager.showNormalScreen(co2, temperatureSCD, values[HISTORY_TEMP_BMP],
+                                            values[HISTORY_HUMIDITY], values[HISTORY_PRESSURE]);
+        }
+
+        // The panel keeps showing its content while the ESP8266 sleeps
+        if (displayOn) {
+            displayManager.wake();
+        } else {
+            displayManager.sleep();
+        }
+    }
+    state.displayOn = displayReady && displayOn;
+
+    sensorFilter.getState(state.filter);
+    pressureCompensator.getState(state.pressure);
+    exposureAccumulator.getRunningState(state.exposure);
+    state.moderateThreshold = alertMonitor.getModerateThreshold();
+    state.criticalThreshold = alertMonitor.getCriticalThreshold();
+
+    uint32_t sleepMs = powerManager.planSleep(millis());
+    powerManager.save(millis(), sleepMs);
+
+    if (Logger::isEnabled(LOG_INFO)) {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "Awake for %lu ms, sleeping for %lu ms",
+                 millis(), static_cast<unsigned long>(sleepMs));
+        Logger::info(buffer);
+    }
+    Serial.flush();
+    ESP.deepSleep(sleepMs * 1000ULL, WAKE_RF_DISABLED);
+}
+#endif
+
+#if SENSOR_ROOMS > 1
+/**
+ * @brief Initializes the sensors of all rooms.
+ *
+ * @return `true` if at least one room is online, `false` otherwise.
+ */
+bool setupRooms() {
+    for (uint8_t i = 0; i < SENSOR_ROOMS; i++) {
+        sensorGroup.addRoom(roomSensors[i], i);
+    }
+    uint8_t online = sensorGroup.begin(millis());
+    serialConsole.setRooms(sensorGroup, roomSensors);
+
+    LogLevel level = online < SENSOR_ROOMS ? LOG_WARNING : LOG_INFO;
+    if (Logger::isEnabled(level)) {
+        char buffer[40];
+        snprintf(buffer, sizeof(buffer), "%u of %u rooms online", online, SENSOR_ROOMS);
+        Logger::log(level, buffer);
+    }
+    return online > 0;
+}
+
+/**
+ * @brief Calibrates the SCD30 of every online room unless the calibration flag is set.
+ *
+ * One flag covers all rooms, so all sensors are calibrated together in fresh air.
+ */
+void calibrateRooms() {
+    if (EEPROM.read(EEPROM_CALIBRATION_FLAG_ADDRESS) == CALIBRATION_DONE) {
+        Logger::info(MSG_ALREADY_CALIBRATED);
+        return;
+    }
+    Logger::info(MSG_CALIBRATION_NEEDED);
+    for (uint8_t i = 0; i < sensorGroup.getRoomCount(); i++) {
+        if (sensorGroup.getRoom(i).online && sensorGroup.selectRoom(i)) {
+            roomSensors[i].calibrateSCD30();
+        }
+    }
+    EEPROM.write(EEPROM_CALIBRATION_FLAG_ADDRESS, CALIBRATION_DONE);
+    EEPROM.commit();
+}
+
+/**
+ * @brief Reads the rooms that are due and logs their readings, alert changes and online state.
+ *
+ * @param now The current time in ms.
+ */
+void pollRooms(unsigned long now) {
+    uint8_t updated = sensorGroup.poll(now);
+    uint8_t onlineChanges = sensorGroup.getOnlineChanges();
+    char buffer[96];
+    if (onlineChanges != 0) {
+        for (uint8_t i = 0; i < sensorGroup.getRoomCount(); i++) {
+            if ((onlineChanges & (1 << i)) == 0) {
+                continue;
+            }
+            bool online = sensorGroup.getRoom(i).online;
+            if (Logger::isEnabled(online ? LOG_INFO : LOG_WARNING)) {
+                snprintf(buffer, sizeof(buffer), "Room %u: %s", i + 1, online ? "back online" : "offline");
+                Logger::log(online ? LOG_INFO : LOG_WARNING, buffer);
+            }
+        }
+        pageManager.invalidate(INPUT_READINGS);
+    }
+    if (updated == 0) {
+        return;
+    }
+    uint8_t alertChanges = sensorGroup.getAlertChanges();
+
+    for (uint8_t i = 0; i < sensorGroup.getRoomCount(); i++) {
+        if ((updated & (1 << i)) == 0) {
+            continue;
+        }
+        const SensorRoom& room = sensorGroup.getRoom(i);
+        samplesProcessed++;
+        if (Logger::isEnabled(LOG_INFO)) {
+            const float* raw = room.lastSample.values;
+            snprintf(buffer, sizeof(buffer), "Room %u: CO2 %.2f ppm (filtered %.2f), %.2f C, %.2f %%, %.2f hPa",
+                     i + 1, raw[HISTORY_CO2], room.co2, raw[HISTORY_TEMP_SCD], raw[HISTORY_HUMIDITY],
+                     raw[HISTORY_PRESSURE]);
+            Logger::info(buffer);
+        }
+        if ((alertChanges & (1 << i)) == 0) {
+            continue;
+        }
+        AlertLevel level = room.alertMonitor.getLevel();
+        if (!Logger::isEnabled(level == ALERT_NONE ? LOG_INFO : LOG_WARNING)) {
+            continue;
+        }
+        switch (level) {
+            case ALERT_CRITICAL:
+                snprintf(buffer, sizeof(buffer), "Room %u: CRITICAL: High CO2 levels!", i + 1);
+                Logger::warning(buffer);
+                break;
+            case ALERT_MODERATE:
+                snprintf(buffer, sizeof(buffer), "Room %u: MODERATE: Elevated CO2 levels!", i + 1);
+                Logger::warning(buffer);
+                break;
+            default:
+                snprintf(buffer, sizeof(buffer), "Room %u: CO2 back to normal.", i + 1);
+                Logger::info(buffer);
+                break;
+        }
+    }
+    pageManager.invalidate(alertChanges != 0 ? INPUT_READINGS | INPUT_ALERT : INPUT_READINGS);
+    metricsPage.setValue(METRIC_SAMPLES, samplesProcessed);
+}
+#endif
+
+/**
+ * @brief Initializes the system, including the display, sensors, and logger.
+ * 
+ * This function sets up the serial communication, initializes the display and sensors,
+ * and performs a calibration check for the SCD30 sensor. If any initialization fails,
+ * the system halts.
+ */
+void setup() {
+    Serial.begin(115200);
+    while (!Serial);
+
+#if LOW_POWER
+    runLowPowerCycle(); // Does not return
+#endif
+
+    Logger::error("This is test error message.");    // Should always print
+    Logger::warning("This test a warning message."); // Should not print if LOG_LEVEL=LOG_ERROR
+    Logger::info("This is test info message.");      // Should not print if LOG_LEVEL=LOG_ERROR
+    Logger::debug("This is test debug message.");    // Should not print if LOG_LEVEL=LOG_ERROR
+
+    Logger::info("Initializing...");
+    if (Logger::isEnabled(LOG_INFO)) {
+        char buffer[40];
+        snprintf(buffer, sizeof(buffer), "Build profile: %s", ACTIVE_PROFILE.name);
+        Logger::info(buffer);
+    }
+
+    if constexpr (ACTIVE_PROFILE.i2cScanner) {
+        i2cScanner.scan();
+    }
+
+    // Initialize the display
+    if (!displayManager.initialize()) {
+        Logger::error("Display initialization failed!");
+        for (;;); // Halt if display initialization fails
+    }
+
+    if constexpr (ACTIVE_PROFILE.displayCheck) {
+        displayManager.runDisplayCheck();
+    }
+
+    displayManager.splashScreen("Initializing...");
+    delay(2000);
+
+    // Initialize sensors
+#if SENSOR_ROOMS > 1
+    if (!setupRooms()) {
+#else
+    if (!sensorManager.initializeSensors()) {
+#endif
+        displayManager.splashScreen("Sensor init failed!");
+        Logger::info("Sensor init failed!");
+        for (;;); // Halt if sensor initialization fails
+    }
+#if SENSOR_ROOMS == 1
+    // The SCD30 keeps its interval across power cycles, e.g. the 60 s of a low-power firmware
+    if (!sensorManager.setMeasurementInterval(SCD30_INTERVAL_MS / 1000)) {
+        Logger::error("Setting the SCD30 measurement interval failed.");
+    }
+#endif
+
+    // Map the emulated EEPROM holding the calibration flag and exposure history
+    EEPROM.begin(EEPROM_SIZE);
+
+    // Check and calibrate the SCD30 sensor
+#if SENSOR_ROOMS > 1
+    calibrateRooms();
+#else
+    sensorManager.checkAndCalibrateSCD30();
+#endif
+
+    // Restore the exposure rollups of previous runs
+    exposureAccumulator.begin();
+
+    // Associate with WiFi in the background for MQTT and the metrics endpoint
+    if (WIFI_SSID[0] != '\0') {
+        Logger::info("Starting WiFi...");
+        WiFi.mode(WIFI_STA);
+        WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+    }
+    metricsServer.begin();
+
+    pinMode(BUTTON_PIN, INPUT_PULLUP);
+    Logger::info("Initialization complete.");
+}
+
+/**
+ * @brief Main loop for retrieving sensor data and updating the display.
+ * 
+ * This function continuously retrieves sensor data, logs the readings, and updates the display.
+ * The sensors are polled every `SENSOR_POLL_INTERVAL_MS`; in between, the loop only serves
+ * the page button, the console and the network, so a page switch never delays a poll by
+ * more than one render.
+ */
+void loop() {
+    unsigned long loopStart = micros();
+    Logger::debug("Entering loop...");
+    if constexpr (ACTIVE_PROFILE.serialConsole) {
+        serialConsole.poll();
+    }
+    mqttPublisher.poll(millis());
+    metricsServer.poll(millis());
+
+    if (pageButton.update(digitalRead(BUTTON_PIN) == LOW, millis())) {
+        pageManager.next(millis());
+    }
+
+#if SENSOR_ROOMS > 1
+    // The group predicts when each room has data, so it is asked on every iteration
+    pollRooms(millis());
+#else
+    bool pollDue = millis() - lastSensorPoll >= SENSOR_POLL_INTERVAL_MS;
+    if (pollDue) {
+        lastSensorPoll = millis();
+    }
+    if (pollDue && measurementPipeline.poll(millis())) {
+        const PipelineReadings& readings = measurementPipeline.getReadings();
+
+        // Keep the raw readings compressed for export with 'dump compressed'
+        uint32_t encodeStart = ESP.getCycleCount();
+        historyArchive.append(readings.raw);
+        uint32_t encodeCycles = ESP.getCycleCount() - encodeStart;
+        if (Logger::isEnabled(LOG_DEBUG)) {
+            char buffer[48];
+            snprintf(buffer, sizeof(buffer), "History sample encoded in %lu cycles",
+                     static_cast<unsigned long>(encodeCycles));
+            Logger::debug(buffer);
+        }
+        mqttPublisher.addSample(readings.raw, millis());
+
+        const float* raw = readings.raw.values;
+        metricsPage.setValue(METRIC_CO2, raw[HISTORY_CO2]);
+        metricsPage.setValue(METRIC_CO2_FILTERED, readings.co2);
+        metricsPage.setValue(METRIC_TEMPERATURE_SCD, readings.temperatureSCD);
+        metricsPage.setValue(METRIC_TEMPERATURE_BMP, raw[HISTORY_TEMP_BMP]);
+        metricsPage.setValue(METRIC_HUMIDITY, raw[HISTORY_HUMIDITY]);
+        metricsPage.setValue(METRIC_PRESSURE, raw[HISTORY_PRESSURE]);
+        metricsPage.setValue(METRIC_ALERT_LEVEL, readings.alertLevel);
+        metricsPage.setValue(METRIC_SAMPLES, ++samplesProcessed);
+    }
+#endif
+    pageManager.update(millis());
+
+    unsigned long loopBusyUs = micros() - loopStart;
+    if (loopBusyUs > loopBusyMaxUs) {
+        loopBusyMaxUs = loopBusyUs;
+    }
+    metricsPage.setValue(METRIC_LOOP_LAST, loopBusyUs / 1e6);
+    metricsPage.setValue(METRIC_LOOP_MAX, loopBusyMaxUs / 1e6);
+    metricsPage.setValue(METRIC_FREE_HEAP, ESP.getFreeHeap());
+    metricsPage.setValue(METRIC_UPTIME, millis() / 1000);
+
+    // The health page changes at most once per second
+    if (displayModel.uptimeSeconds != millis() / 1000) {
+        displayModel.uptimeSeconds = millis() / 1000;
+        displayModel.freeHeap = ESP.getFreeHeap();
+        displayModel.samples = samplesProcessed;
+        displayModel.loopBusyMaxUs = loopBusyMaxUs;
+        displayModel.renderMaxUs = pageManager.getStatistics().maxRenderUs;
+        pageManager.invalidate(INPUT_HEALTH);
+    }
+
+    delay(LOOP_IDLE_MS);
 }
\ No newline at end of file
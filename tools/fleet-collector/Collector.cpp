@@ -0,0 +1,416 @@
+#include "Collector.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <fstream>
+#include <functional>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sstream>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @file Collector.cpp
+ * @brief Implements the multi-threaded telemetry collector.
+ */
+
+/**
+ * @brief Returns the CPU time consumed by the calling thread in s.
+ */
+static double threadCpuSeconds() {
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Derives a device identifier from a source path (its file name without extension).
+ */
+static std::string deviceIdFromPath(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    size_t dot = name.find_last_of('.');
+    return dot == std::string::npos || dot == 0 ? name : name.substr(0, dot);
+}
+
+/**
+ * @brief Constructs the collector.
+ *
+ * @param options The configuration.
+ */
+Collector::Collector(const CollectorOptions& options)
+    : options(options), stopping(false) {
+    if (this->options.workers == 0) {
+        this->options.workers = 1;
+    }
+    for (unsigned i = 0; i < this->options.workers; i++) {
+        workers.push_back(std::unique_ptr<Worker>(new Worker()));
+    }
+}
+
+/**
+ * @brief Selects the worker that owns a device.
+ */
+Collector::Worker& Collector::shardOf(const std::string& deviceId) {
+    return *workers[std::hash<std::string>()(deviceId) % workers.size()];
+}
+
+/**
+ * @brief Looks up or creates a device in its worker.
+ */
+DeviceSeries& Collector::deviceIn(Worker& worker, const std::string& deviceId) {
+    std::unique_ptr<DeviceSeries>& device = worker.devices[deviceId];
+    if (!device) {
+        device.reset(new DeviceSeries(deviceId));
+    }
+    return *device;
+}
+
+/**
+ * @brief Returns the monotonic time in ms.
+ */
+uint64_t Collector::monotonicMs() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Parses all complete lines of a chunk.
+ *
+ * @param device The device the lines belong to.
+ * @param data The chunk.
+ * @param size The chunk size in bytes.
+ * @param replay Whether timestamps come from the device's virtual clock.
+ * @param nowMs The receive time in ms for live data.
+ * @return The number of bytes consumed (up to and including the last newline).
+ */
+size_t Collector::processChunk(DeviceSeries& device, const char* data, size_t size, bool replay, uint64_t nowMs) {
+    const char* cursor = data;
+    const char* end = data + size;
+    while (cursor < end) {
+        const char* newline = static_cast<const char*>(memchr(cursor, '\n', end - cursor));
+        if (newline == nullptr) {
+            break;
+        }
+        processLine(device, cursor, newline, replay, nowMs);
+        cursor = newline + 1;
+    }
+    return cursor - data;
+}
+
+/**
+ * @brief Parses one line and records its reading.
+ *
+ * Replayed files carry no timestamps, so every `CO2:` line (the first line of each block
+ * printed by the firmware) advances the device's virtual clock by the sample interval.
+ */
+void Collector::processLine(DeviceSeries& device, const char* begin, const char* end, bool replay, uint64_t nowMs) {
+    if (end > begin && end[-1] == '\r') {
+        end--;
+    }
+    if (end == begin) {
+        // Terminals in canonical mode turn CRLF into two line breaks
+        return;
+    }
+    device.lines++;
+
+    LogLine line;
+    if (!parseLogLine(std::string_view(begin, end - begin), line)) {
+        device.malformed++;
+        return;
+    }
+    if (line.level == LineLevel::Warning) {
+        device.warnings++;
+    } else if (line.level == LineLevel::Error) {
+        device.errors++;
+    }
+
+    Channel channel;
+    float value;
+    if (!parseReading(line.message, channel, value)) {
+        return;
+    }
+    if (replay && channel == CHANNEL_CO2) {
+        device.clockMs += options.intervalMs;
+    }
+    device.add(channel, replay ? device.clockMs : nowMs, value);
+}
+
+/**
+ * @brief Collects from all sources until finite sources are exhausted or `stop()` is called.
+ *
+ * Regular files are read to their end. Terminals and the UDP socket keep the collector
+ * running until `stop()` is called (e.g. by SIGINT).
+ *
+ * @return `true` on success, `false` if a source could not be opened.
+ */
+bool Collector::run() {
+    for (const std::string& path : options.sources) {
+        int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_NOCTTY);
+        if (fd < 0) {
+            fprintf(stderr, "Cannot open %s: %s\n", path.c_str(), strerror(errno));
+            return false;
+        }
+
+        std::string deviceId = deviceIdFromPath(path);
+        Worker& worker = shardOf(deviceId);
+        std::unique_ptr<Source> source(new Source());
+        source->fd = fd;
+        source->terminal = isatty(fd);
+        source->device = &deviceIn(worker, deviceId);
+        worker.sources.push_back(std::move(source));
+    }
+
+    std::thread udpThread;
+    if (options.udpPort > 0) {
+        udpThread = std::thread(&Collector::udpLoop, this);
+    }
+    for (std::unique_ptr<Worker>& worker : workers) {
+        worker->thread = std::thread(&Collector::workerLoop, this, std::ref(*worker));
+    }
+    for (std::unique_ptr<Worker>& worker : workers) {
+        worker->thread.join();
+    }
+    if (udpThread.joinable()) {
+        stop();
+        udpThread.join();
+    }
+    return true;
+}
+
+/**
+ * @brief Reads the sources of one worker until they are exhausted or collection stops.
+ */
+void Collector::workerLoop(Worker& worker) {
+    std::vector<pollfd> descriptors;
+    std::vector<Source*> polled;
+    std::vector<std::pair<std::string, std::string>> datagrams;
+
+    while (!stopping.load()) {
+        {
+            std::lock_guard<std::mutex> lock(worker.inboxMutex);
+            datagrams.swap(worker.inbox);
+        }
+        uint64_t nowMs = monotonicMs();
+        for (std::pair<std::string, std::string>& datagram : datagrams) {
+            DeviceSeries& device = deviceIn(worker, datagram.first);
+            if (datagram.second.empty() || datagram.second.back() != '\n') {
+                datagram.second.push_back('\n');
+            }
+            processChunk(device, datagram.second.data(), datagram.second.size(), false, nowMs);
+        }
+        datagrams.clear();
+
+        descriptors.clear();
+        polled.clear();
+        for (std::unique_ptr<Source>& source : worker.sources) {
+            if (source->fd >= 0) {
+                descriptors.push_back({ source->fd, POLLIN, 0 });
+                polled.push_back(source.get());
+            }
+        }
+        if (descriptors.empty()) {
+            if (options.udpPort <= 0) {
+                break;
+            }
+            poll(nullptr, 0, 50);
+            continue;
+        }
+
+        if (poll(descriptors.data(), descriptors.size(), 50) <= 0) {
+            continue;
+        }
+        nowMs = monotonicMs();
+        for (size_t i = 0; i < descriptors.size(); i++) {
+            if (descriptors[i].revents == 0) {
+                continue;
+            }
+            Source& source = *polled[i];
+            ssize_t received = read(source.fd, source.buffer + source.used, SOURCE_BUFFER_SIZE - source.used);
+            if (received < 0 && (errno == EAGAIN || errno == EINTR)) {
+                continue;
+            }
+            if (received <= 0) {
+                // End of file, or the other side of a terminal hung up
+                if (source.used > 0) {
+                    source.buffer[source.used] = '\n';
+                    processChunk(*source.device, source.buffer, source.used + 1, !source.terminal, nowMs);
+                }
+                close(source.fd);
+                source.fd = -1;
+                continue;
+            }
+
+            size_t available = source.used + received;
+            size_t consumed = processChunk(*source.device, source.buffer, available, !source.terminal, nowMs);
+            source.used = available - consumed;
+            if (source.used == SOURCE_BUFFER_SIZE) {
+                // A single line filling the whole buffer is garbage; drop it
+                source.device->malformed++;
+                source.used = 0;
+            } else if (source.used > 0) {
+                memmove(source.buffer, source.buffer + consumed, source.used);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Receives UDP datagrams and dispatches them to the owning workers.
+ *
+ * Each sender address identifies one device.
+ */
+void Collector::udpLoop() {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        fprintf(stderr, "Cannot create UDP socket: %s\n", strerror(errno));
+        return;
+    }
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(options.udpPort));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        fprintf(stderr, "Cannot bind UDP port %d: %s\n", options.udpPort, strerror(errno));
+        close(fd);
+        return;
+    }
+
+    timeval timeout = { 0, 100000 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    char buffer[UDP_DATAGRAM_SIZE];
+    while (!stopping.load()) {
+        sockaddr_in sender;
+        socklen_t senderSize = sizeof(sender);
+        ssize_t received = recvfrom(fd, buffer, sizeof(buffer), 0, reinterpret_cast<sockaddr*>(&sender), &senderSize);
+        if (received <= 0) {
+            continue;
+        }
+
+        char deviceId[32];
+        snprintf(deviceId, sizeof(deviceId), "udp:%s:%u", inet_ntoa(sender.sin_addr), ntohs(sender.sin_port));
+        Worker& worker = shardOf(deviceId);
+        std::lock_guard<std::mutex> lock(worker.inboxMutex);
+        worker.inbox.emplace_back(deviceId, std::string(buffer, received));
+    }
+    close(fd);
+}
+
+/**
+ * @brief Replays all sources from memory and reports the throughput.
+ *
+ * Each file is loaded once and replayed `benchRepeat` times as `devicesPerSource`
+ * synthetic devices, so disk I/O is excluded from the measurement. Throughput per core
+ * is the number of lines divided by the CPU time of the worker threads.
+ *
+ * @return `true` on success, `false` if a source could not be loaded.
+ */
+bool Collector::runBenchmark() {
+    std::vector<std::string> contents;
+    for (const std::string& path : options.sources) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            fprintf(stderr, "Cannot open %s\n", path.c_str());
+            return false;
+        }
+        std::ostringstream content;
+        content << file.rdbuf();
+        contents.push_back(content.str());
+    }
+
+    for (size_t i = 0; i < options.sources.size(); i++) {
+        for (unsigned copy = 0; copy < options.devicesPerSource; copy++) {
+            std::string deviceId = deviceIdFromPath(options.sources[i]) + "#" + std::to_string(copy);
+            Worker& worker = shardOf(deviceId);
+            worker.benchInputs.emplace_back(&deviceIn(worker, deviceId), contents[i]);
+        }
+    }
+
+    uint64_t startMs = monotonicMs();
+    for (std::unique_ptr<Worker>& worker : workers) {
+        Worker* self = worker.get();
+        worker->thread = std::thread([this, self]() {
+            double start = threadCpuSeconds();
+            for (unsigned repeat = 0; repeat < options.benchRepeat; repeat++) {
+                for (std::pair<DeviceSeries*, std::string>& input : self->benchInputs) {
+                    processChunk(*input.first, input.second.data(), input.second.size(), true, 0);
+                }
+            }
+            self->cpuSeconds = threadCpuSeconds() - start;
+        });
+    }
+    for (std::unique_ptr<Worker>& worker : workers) {
+        worker->thread.join();
+    }
+    double wallSeconds = (monotonicMs() - startMs) / 1000.0;
+
+    uint64_t totalLines = 0;
+    double totalCpu = 0.0;
+    for (size_t i = 0; i < workers.size(); i++) {
+        uint64_t lines = 0;
+        for (const auto& entry : workers[i]->devices) {
+            lines += entry.second->lines;
+        }
+        totalLines += lines;
+        totalCpu += workers[i]->cpuSeconds;
+        printf("worker %zu: %zu devices, %llu lines, %.3f s CPU, %.2f M lines/s\n",
+               i, workers[i]->devices.size(), static_cast<unsigned long long>(lines), workers[i]->cpuSeconds,
+               workers[i]->cpuSeconds > 0.0 ? lines / workers[i]->cpuSeconds / 1e6 : 0.0);
+    }
+    printf("total: %llu lines in %.3f s wall, %.2f M lines/s, %.2f M lines/s per core\n",
+           static_cast<unsigned long long>(totalLines), wallSeconds,
+           wallSeconds > 0.0 ? totalLines / wallSeconds / 1e6 : 0.0,
+           totalCpu > 0.0 ? totalLines / totalCpu / 1e6 : 0.0);
+    return true;
+}
+
+/**
+ * @brief Ends live collection; safe to call from a signal handler.
+ */
+void Collector::stop() {
+    stopping.store(true);
+}
+
+/**
+ * @brief Prints the per-device statistics, sorted by device identifier.
+ *
+ * @param out The output stream.
+ */
+void Collector::printSummary(FILE* out) const {
+    std::vector<const DeviceSeries*> devices;
+    for (const std::unique_ptr<Worker>& worker : workers) {
+        for (const auto& entry : worker->devices) {
+            devices.push_back(entry.second.get());
+        }
+    }
+    std::sort(devices.begin(), devices.end(), [](const DeviceSeries* a, const DeviceSeries* b) {
+        return a->getName() < b->getName();
+    });
+
+    for (const DeviceSeries* device : devices) {
+        fprintf(out, "%s: %llu lines, %llu warnings, %llu errors, %llu malformed, %.0f s covered\n",
+                device->getName().c_str(),
+                static_cast<unsigned long long>(device->lines),
+                static_cast<unsigned long long>(device->warnings),
+                static_cast<unsigned long long>(device->errors),
+                static_cast<unsigned long long>(device->malformed),
+                device->spanMs(CHANNEL_CO2) / 1000.0);
+        for (int i = 0; i < CHANNEL_COUNT; i++) {
+            Channel channel = static_cast<Channel>(i);
+            const RollingStats& stats = device->getStats(channel);
+            if (stats.count() == 0) {
+                continue;
+            }
+            fprintf(out, "  %-12s n=%-8llu last=%-9.2f mean=%-9.2f sd=%-7.2f min=%-9.2f max=%.2f\n",
+                    channelName(channel), static_cast<unsigned long long>(stats.count()),
+                    stats.last(), stats.mean(), stats.stddev(), stats.min(), stats.max());
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+#ifndef COLLECTOR_H
+#define COLLECTOR_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "DeviceSeries.h"
+
+/**
+ * @file Collector.h
+ * @brief Multi-threaded collector for the serial telemetry of many meters.
+ */
+
+#define SOURCE_BUFFER_SIZE 65536 ///< Read buffer per file or terminal source
+#define UDP_DATAGRAM_SIZE 2048   ///< Largest accepted UDP datagram
+
+/**
+ * @struct CollectorOptions
+ * @brief Command-line configuration of the collector.
+ */
+struct CollectorOptions {
+    unsigned workers = 1;          ///< Number of worker threads
+    int udpPort = 0;               ///< Localhost UDP port to listen on, 0 to disable
+    unsigned benchRepeat = 0;      ///< Replay count in benchmark mode, 0 for live mode
+    unsigned devicesPerSource = 1; ///< Synthetic devices per file in benchmark mode
+    uint32_t intervalMs = 2000;    ///< Sample interval assumed for replayed files in ms
+    std::vector<std::string> sources; ///< Files or terminal devices to read
+};
+
+/**
+ * @class Collector
+ * @brief Ingests `Logger` text streams and aggregates them per device.
+ *
+ * Every device is owned by exactly one worker thread (chosen by hashing its identifier),
+ * so device state is never shared. Files and pseudo-terminals are read by the owning
+ * worker itself; UDP datagrams are received by one thread and handed to the owning
+ * worker's inbox, which is the only synchronized path.
+ *
+ * Lines are parsed in place in the read buffers; only an incomplete trailing line is
+ * moved to the front of its buffer before the next read.
+ */
+class Collector {
+private:
+    /**
+     * @struct Source
+     * @brief A file or terminal read by its owning worker.
+     */
+    struct Source {
+        int fd = -1;                       ///< Open descriptor, -1 once finished
+        bool terminal = false;             ///< Whether the source is a live terminal
+        DeviceSeries* device = nullptr;    ///< Device the lines belong to
+        size_t used = 0;                   ///< Bytes of an incomplete line in `buffer`
+        char buffer[SOURCE_BUFFER_SIZE];   ///< Read buffer
+    };
+
+    /**
+     * @struct Worker
+     * @brief A worker thread and the devices it owns.
+     */
+    struct Worker {
+        std::thread thread; ///< The worker thread
+        std::unordered_map<std::string, std::unique_ptr<DeviceSeries>> devices; ///< Owned devices
+        std::vector<std::unique_ptr<Source>> sources; ///< Owned file and terminal sources
+        std::vector<std::pair<DeviceSeries*, std::string>> benchInputs; ///< Benchmark replay inputs
+        std::mutex inboxMutex; ///< Guards `inbox`
+        std::vector<std::pair<std::string, std::string>> inbox; ///< UDP datagrams (device, payload)
+        double cpuSeconds = 0.0; ///< Thread CPU time in benchmark mode
+    };
+
+    CollectorOptions options; ///< Configuration
+    std::vector<std::unique_ptr<Worker>> workers; ///< Worker threads
+    std::atomic<bool> stopping; ///< Set to end live collection
+
+    /**
+     * @brief Selects the worker that owns a device.
+     */
+    Worker& shardOf(const std::string& deviceId);
+
+    /**
+     * @brief Looks up or creates a device in its worker.
+     */
+    static DeviceSeries& deviceIn(Worker& worker, const std::string& deviceId);
+
+    /**
+     * @brief Parses all complete lines of a chunk.
+     *
+     * @param device The device the lines belong to.
+     * @param data The chunk.
+     * @param size The chunk size in bytes.
+     * @param replay Whether timestamps come from the device's virtual clock.
+     * @param nowMs The receive time in ms for live data.
+     * @return The number of bytes consumed (up to and including the last newline).
+     */
+    size_t processChunk(DeviceSeries& device, const char* data, size_t size, bool replay, uint64_t nowMs);
+
+    /**
+     * @brief Parses one line and records its reading.
+     */
+    void processLine(DeviceSeries& device, const char* begin, const char* end, bool replay, uint64_t nowMs);
+
+    /**
+     * @brief Reads the sources of one worker until they are exhausted or collection stops.
+     */
+    void workerLoop(Worker& worker);
+
+    /**
+     * @brief Receives UDP datagrams and dispatches them to the owning workers.
+     */
+    void udpLoop();
+
+    /**
+     * @brief Returns the monotonic time in ms.
+     */
+    static uint64_t monotonicMs();
+
+public:
+    /**
+     * @brief Constructs the collector.
+     *
+     * @param options The configuration.
+     */
+    explicit Collector(const CollectorOptions& options);
+
+    /**
+     * @brief Collects from all sources until finite sources are exhausted or `stop()` is called.
+     *
+     * @return `true` on success, `false` if a source could not be opened.
+     */
+    bool run();
+
+    /**
+     * @brief Replays all sources from memory and reports the throughput.
+     *
+     * @return `true` on success, `false` if a source could not be loaded.
+     */
+    bool runBenchmark();
+
+    /**
+     * @brief Ends live collection; safe to call from a signal handler.
+     */
+    void stop();
+
+    /**
+     * @brief Prints the per-device statistics.
+     *
+     * @param out The output stream.
+     */
+    void printSummary(FILE* out) const;
+};
+
+#endif // COLLECTOR_H
\ No newline at end of file
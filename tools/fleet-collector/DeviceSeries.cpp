@@ -0,0 +1,162 @@
+#include "DeviceSeries.h"
+#include <math.h>
+#include <utility>
+
+/**
+ * @file DeviceSeries.cpp
+ * @brief Implements the per-device time series and rolling statistics.
+ */
+
+/**
+ * @brief Adds a value, evicting the oldest one once the window is full.
+ *
+ * @param value The new value.
+ */
+void RollingStats::add(float value) {
+    if (filled == ROLLING_WINDOW) {
+        float evicted = window[next];
+        sum -= evicted;
+        sumSquares -= static_cast<double>(evicted) * evicted;
+    } else {
+        filled++;
+    }
+    window[next] = value;
+    next = (next + 1) % ROLLING_WINDOW;
+    sum += value;
+    sumSquares += static_cast<double>(value) * value;
+    total++;
+}
+
+/**
+ * @brief Number of values seen since start.
+ */
+uint64_t RollingStats::count() const {
+    return total;
+}
+
+/**
+ * @brief Most recent value (0 if none).
+ */
+float RollingStats::last() const {
+    return filled == 0 ? 0.0f : window[(next + ROLLING_WINDOW - 1) % ROLLING_WINDOW];
+}
+
+/**
+ * @brief Mean over the window.
+ */
+double RollingStats::mean() const {
+    return filled == 0 ? 0.0 : sum / filled;
+}
+
+/**
+ * @brief Standard deviation over the window.
+ */
+double RollingStats::stddev() const {
+    if (filled < 2) {
+        return 0.0;
+    }
+    double average = mean();
+    double variance = sumSquares / filled - average * average;
+    return variance > 0.0 ? sqrt(variance) : 0.0;
+}
+
+/**
+ * @brief Minimum over the window.
+ */
+float RollingStats::min() const {
+    float result = filled == 0 ? 0.0f : window[0];
+    for (size_t i = 1; i < filled; i++) {
+        if (window[i] < result) {
+            result = window[i];
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Maximum over the window.
+ */
+float RollingStats::max() const {
+    float result = filled == 0 ? 0.0f : window[0];
+    for (size_t i = 1; i < filled; i++) {
+        if (window[i] > result) {
+            result = window[i];
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Constructs an empty series.
+ *
+ * @param name The device identifier.
+ */
+DeviceSeries::DeviceSeries(std::string name)
+    : name(std::move(name)) {}
+
+/**
+ * @brief Appends a sample to a channel.
+ *
+ * The ring grows up to `SERIES_CAPACITY` samples and then overwrites the oldest one.
+ *
+ * @param channel The measurement channel.
+ * @param timestampMs The sample time in ms.
+ * @param value The measured value.
+ */
+void DeviceSeries::add(Channel channel, uint64_t timestampMs, float value) {
+    std::vector<SamplePoint>& ring = series[channel];
+    if (ring.size() < SERIES_CAPACITY) {
+        ring.push_back({ timestampMs, value });
+    } else {
+        ring[seriesNext[channel]] = { timestampMs, value };
+    }
+    seriesNext[channel] = (seriesNext[channel] + 1) % SERIES_CAPACITY;
+    stats[channel].add(value);
+}
+
+/**
+ * @brief Retrieves the device identifier.
+ */
+const std::string& DeviceSeries::getName() const {
+    return name;
+}
+
+/**
+ * @brief Retrieves the rolling statistics of a channel.
+ */
+const RollingStats& DeviceSeries::getStats(Channel channel) const {
+    return stats[channel];
+}
+
+/**
+ * @brief Retrieves the most recent samples of a channel, oldest first.
+ *
+ * @param channel The measurement channel.
+ * @param out Receives up to `SERIES_CAPACITY` samples.
+ */
+void DeviceSeries::copySeries(Channel channel, std::vector<SamplePoint>& out) const {
+    const std::vector<SamplePoint>& ring = series[channel];
+    out.clear();
+    if (ring.size() < SERIES_CAPACITY) {
+        out = ring;
+        return;
+    }
+    out.insert(out.end(), ring.begin() + seriesNext[channel], ring.end());
+    out.insert(out.end(), ring.begin(), ring.begin() + seriesNext[channel]);
+}
+
+/**
+ * @brief Time covered by the samples kept for a channel.
+ *
+ * @param channel The measurement channel.
+ * @return The time between the oldest and the newest kept sample in ms.
+ */
+uint64_t DeviceSeries::spanMs(Channel channel) const {
+    const std::vector<SamplePoint>& ring = series[channel];
+    if (ring.size() < 2) {
+        return 0;
+    }
+    size_t newest = (seriesNext[channel] + SERIES_CAPACITY - 1) % SERIES_CAPACITY;
+    size_t oldest = ring.size() < SERIES_CAPACITY ? 0 : seriesNext[channel];
+    return ring[newest].timestampMs - ring[oldest].timestampMs;
+}
\ No newline at end of file
@@ -0,0 +1,145 @@
+#ifndef DEVICE_SERIES_H
+#define DEVICE_SERIES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "LogLineParser.h"
+
+/**
+ * @file DeviceSeries.h
+ * @brief In-memory time series and rolling statistics of one meter.
+ */
+
+#define SERIES_CAPACITY 8192 ///< Samples kept per channel
+#define ROLLING_WINDOW 300   ///< Samples in the rolling statistics window (10 min at 2 s)
+
+/**
+ * @struct SamplePoint
+ * @brief One timestamped measurement.
+ */
+struct SamplePoint {
+    uint64_t timestampMs; ///< Sample time in ms
+    float value;          ///< Measured value
+};
+
+/**
+ * @class RollingStats
+ * @brief Mean, standard deviation, minimum and maximum over the last `ROLLING_WINDOW` samples.
+ *
+ * Sums are updated in O(1) per sample; minimum and maximum are computed on demand.
+ */
+class RollingStats {
+private:
+    float window[ROLLING_WINDOW]; ///< Ring of the most recent values
+    size_t next = 0;              ///< Ring position of the next value
+    size_t filled = 0;            ///< Number of valid values in the ring
+    double sum = 0.0;             ///< Sum of the values in the ring
+    double sumSquares = 0.0;      ///< Sum of the squared values in the ring
+    uint64_t total = 0;           ///< Values seen since start
+
+public:
+    /**
+     * @brief Adds a value, evicting the oldest one once the window is full.
+     *
+     * @param value The new value.
+     */
+    void add(float value);
+
+    /**
+     * @brief Number of values seen since start.
+     */
+    uint64_t count() const;
+
+    /**
+     * @brief Most recent value (0 if none).
+     */
+    float last() const;
+
+    /**
+     * @brief Mean over the window.
+     */
+    double mean() const;
+
+    /**
+     * @brief Standard deviation over the window.
+     */
+    double stddev() const;
+
+    /**
+     * @brief Minimum over the window.
+     */
+    float min() const;
+
+    /**
+     * @brief Maximum over the window.
+     */
+    float max() const;
+};
+
+/**
+ * @class DeviceSeries
+ * @brief Aggregated readings of one meter.
+ *
+ * Each channel keeps a ring of the last `SERIES_CAPACITY` samples and its rolling statistics.
+ * A `DeviceSeries` is owned by exactly one worker thread and is therefore not synchronized.
+ */
+class DeviceSeries {
+private:
+    std::string name; ///< Device identifier
+    std::vector<SamplePoint> series[CHANNEL_COUNT]; ///< Sample rings per channel
+    size_t seriesNext[CHANNEL_COUNT] = {}; ///< Ring positions per channel
+    RollingStats stats[CHANNEL_COUNT]; ///< Rolling statistics per channel
+
+public:
+    uint64_t lines = 0;     ///< Lines received
+    uint64_t malformed = 0; ///< Lines not in `Logger` format
+    uint64_t warnings = 0;  ///< `[WARNING]` lines (CO2 alerts)
+    uint64_t errors = 0;    ///< `[ERROR]` lines
+    uint64_t clockMs = 0;   ///< Virtual clock of replayed sources in ms
+
+    /**
+     * @brief Constructs an empty series.
+     *
+     * @param name The device identifier.
+     */
+    explicit DeviceSeries(std::string name);
+
+    /**
+     * @brief Appends a sample to a channel.
+     *
+     * @param channel The measurement channel.
+     * @param timestampMs The sample time in ms.
+     * @param value The measured value.
+     */
+    void add(Channel channel, uint64_t timestampMs, float value);
+
+    /**
+     * @brief Retrieves the device identifier.
+     */
+    const std::string& getName() const;
+
+    /**
+     * @brief Retrieves the rolling statistics of a channel.
+     */
+    const RollingStats& getStats(Channel channel) const;
+
+    /**
+     * @brief Retrieves the most recent samples of a channel, oldest first.
+     *
+     * @param channel The measurement channel.
+     * @param out Receives up to `SERIES_CAPACITY` samples.
+     */
+    void copySeries(Channel channel, std::vector<SamplePoint>& out) const;
+
+    /**
+     * @brief Time covered by the samples kept for a channel.
+     *
+     * @param channel The measurement channel.
+     * @return The time between the oldest and the newest kept sample in ms.
+     */
+    uint64_t spanMs(Channel channel) const;
+};
+
+#endif // DEVICE_SERIES_H
\ No newline at end of file
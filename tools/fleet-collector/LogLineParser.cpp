@@ -0,0 +1,106 @@
+#include "LogLineParser.h"
+#include <charconv>
+
+/**
+ * @file LogLineParser.cpp
+ * @brief Implements the zero-copy `Logger` line parser.
+ */
+
+/**
+ * @struct ReadingPrefix
+ * @brief Maps a message prefix printed by the firmware to its channel.
+ */
+struct ReadingPrefix {
+    std::string_view prefix; ///< Text preceding the value
+    Channel channel;         ///< Channel of the value
+};
+
+// Prefixes as printed by loop() in src/main.cpp
+static constexpr ReadingPrefix READING_PREFIXES[] = {
+    { "CO2: ", CHANNEL_CO2 },
+    { "Temperature (SCD30): ", CHANNEL_TEMP_SCD },
+    { "Temperature (BMP280): ", CHANNEL_TEMP_BMP },
+    { "Humidity: ", CHANNEL_HUMIDITY },
+    { "Pressure: ", CHANNEL_PRESSURE },
+};
+
+/**
+ * @brief Splits a line of the form `[LEVEL] message`.
+ *
+ * @param line The raw line.
+ * @param out Receives the level and a view of the message.
+ * @return `true` if the line has the `Logger` format, `false` otherwise.
+ */
+bool parseLogLine(std::string_view line, LogLine& out) {
+    while (!line.empty() && (line.back() == '\r' || line.back() == '\n')) {
+        line.remove_suffix(1);
+    }
+    if (line.size() < 3 || line.front() != '[') {
+        return false;
+    }
+
+    size_t close = line.find("] ");
+    if (close == std::string_view::npos) {
+        return false;
+    }
+
+    std::string_view tag = line.substr(1, close - 1);
+    if (tag == "INFO") {
+        out.level = LineLevel::Info;
+    } else if (tag == "DEBUG") {
+        out.level = LineLevel::Debug;
+    } else if (tag == "WARNING") {
+        out.level = LineLevel::Warning;
+    } else if (tag == "ERROR") {
+        out.level = LineLevel::Error;
+    } else {
+        out.level = LineLevel::Unknown;
+    }
+    out.message = line.substr(close + 2);
+    return true;
+}
+
+/**
+ * @brief Extracts a measurement from a log message.
+ *
+ * The firmware formats values with `String(float)`, i.e. as plain decimals.
+ *
+ * @param message The message part of a log line.
+ * @param channel Receives the measurement channel.
+ * @param value Receives the measured value.
+ * @return `true` if the message is a measurement line, `false` otherwise.
+ */
+bool parseReading(std::string_view message, Channel& channel, float& value) {
+    for (const ReadingPrefix& entry : READING_PREFIXES) {
+        if (message.compare(0, entry.prefix.size(), entry.prefix) != 0) {
+            continue;
+        }
+
+        const char* begin = message.data() + entry.prefix.size();
+        const char* end = message.data() + message.size();
+        std::from_chars_result result = std::from_chars(begin, end, value);
+        if (result.ec != std::errc() || result.ptr == begin) {
+            return false;
+        }
+        channel = entry.channel;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Returns a short name for a channel.
+ *
+ * @param channel The channel.
+ * @return The channel name (e.g. "co2").
+ */
+const char* channelName(Channel channel) {
+    switch (channel) {
+        case CHANNEL_CO2: return "co2";
+        case CHANNEL_TEMP_SCD: return "temp_scd30";
+        case CHANNEL_TEMP_BMP: return "temp_bmp280";
+        case CHANNEL_HUMIDITY: return "humidity";
+        case CHANNEL_PRESSURE: return "pressure";
+        default: return "unknown";
+    }
+}
\ No newline at end of file
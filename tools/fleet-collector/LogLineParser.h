@@ -0,0 +1,74 @@
+#ifndef LOG_LINE_PARSER_H
+#define LOG_LINE_PARSER_H
+
+#include <string_view>
+
+/**
+ * @file LogLineParser.h
+ * @brief Zero-copy parser for the text lines emitted by the firmware `Logger`.
+ */
+
+/**
+ * @enum LineLevel
+ * @brief Level tag of a `Logger::log` line.
+ */
+enum class LineLevel {
+    Error,   ///< `[ERROR]`
+    Warning, ///< `[WARNING]`
+    Info,    ///< `[INFO]`
+    Debug,   ///< `[DEBUG]`
+    Unknown  ///< `[UNKNOWN]` or any other tag
+};
+
+/**
+ * @enum Channel
+ * @brief Measurement channels printed by the firmware main loop.
+ */
+enum Channel {
+    CHANNEL_CO2 = 0,      ///< `CO2: <value> ppm`
+    CHANNEL_TEMP_SCD = 1, ///< `Temperature (SCD30): <value> °C`
+    CHANNEL_TEMP_BMP = 2, ///< `Temperature (BMP280): <value> °C`
+    CHANNEL_HUMIDITY = 3, ///< `Humidity: <value> %`
+    CHANNEL_PRESSURE = 4, ///< `Pressure: <value> hPa`
+    CHANNEL_COUNT = 5     ///< Number of channels
+};
+
+/**
+ * @struct LogLine
+ * @brief A parsed log line; `message` points into the caller's buffer.
+ */
+struct LogLine {
+    LineLevel level;          ///< Level tag
+    std::string_view message; ///< Text after the tag, without line terminators
+};
+
+/**
+ * @brief Splits a line of the form `[LEVEL] message`.
+ *
+ * Trailing CR/LF characters are ignored, so lines can be passed as received.
+ *
+ * @param line The raw line.
+ * @param out Receives the level and a view of the message.
+ * @return `true` if the line has the `Logger` format, `false` otherwise.
+ */
+bool parseLogLine(std::string_view line, LogLine& out);
+
+/**
+ * @brief Extracts a measurement from a log message.
+ *
+ * @param message The message part of a log line.
+ * @param channel Receives the measurement channel.
+ * @param value Receives the measured value.
+ * @return `true` if the message is a measurement line, `false` otherwise.
+ */
+bool parseReading(std::string_view message, Channel& channel, float& value);
+
+/**
+ * @brief Returns a short name for a channel.
+ *
+ * @param channel The channel.
+ * @return The channel name (e.g. "co2").
+ */
+const char* channelName(Channel channel);
+
+#endif // LOG_LINE_PARSER_H
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Collector.h"
+
+/**
+ * @file main.cpp
+ * @brief Command-line entry point of the fleet collector.
+ */
+
+static Collector* activeCollector = nullptr; ///< Collector stopped by SIGINT
+
+/**
+ * @brief Stops live collection on SIGINT so the summary is still printed.
+ */
+static void handleInterrupt(int) {
+    if (activeCollector != nullptr) {
+        activeCollector->stop();
+    }
+}
+
+/**
+ * @brief Prints the command-line usage.
+ */
+static void printUsage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [options] SOURCE...\n"
+            "  SOURCE             Log file or serial terminal (e.g. /dev/ttyUSB0) of one meter\n"
+            "  --workers N        Worker threads (default 1)\n"
+            "  --udp PORT         Also accept log lines as UDP datagrams on 127.0.0.1:PORT\n"
+            "  --interval-ms MS   Sample interval assumed for log files (default 2000)\n"
+            "  --bench REPEAT     Replay the files REPEAT times from memory and report throughput\n"
+            "  --devices K        Synthetic devices per file in benchmark mode (default 1)\n",
+            program);
+}
+
+/**
+ * @brief Parses an unsigned option value.
+ */
+static bool parseNumber(const char* text, unsigned long& out) {
+    char* end;
+    out = strtoul(text, &end, 10);
+    return *text != '\0' && *end == '\0';
+}
+
+int main(int argc, char** argv) {
+    CollectorOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        const char* argument = argv[i];
+        if (strncmp(argument, "--", 2) != 0) {
+            options.sources.push_back(argument);
+            continue;
+        }
+
+        unsigned long value;
+        if (i + 1 >= argc || !parseNumber(argv[i + 1], value)) {
+            printUsage(argv[0]);
+            return 2;
+        }
+        i++;
+        if (strcmp(argument, "--workers") == 0) {
+            options.workers = value;
+        } else if (strcmp(argument, "--udp") == 0) {
+            options.udpPort = static_cast<int>(value);
+        } else if (strcmp(argument, "--interval-ms") == 0) {
+            options.intervalMs = value;
+        } else if (strcmp(argument, "--bench") == 0) {
+            options.benchRepeat = value;
+        } else if (strcmp(argument, "--devices") == 0) {
+            options.devicesPerSource = value;
+        } else {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (options.sources.empty() && (options.benchRepeat > 0 || options.udpPort == 0)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    Collector collector(options);
+    if (options.benchRepeat > 0) {
+        return collector.runBenchmark() ? 0 : 1;
+    }
+
+    activeCollector = &collector;
+    signal(SIGINT, handleInterrupt);
+    bool success = collector.run();
+    activeCollector = nullptr;
+
+    collector.printSummary(stdout);
+    return success ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,323 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "HistoryCodec.h"
+#include "LogLineParser.h"
+
+/**
+ * @file main.cpp
+ * @brief Decodes `HIST:` lines from `dump compressed` and benchmarks the history codec.
+ */
+
+static const char* const CHANNEL_NAMES[HISTORY_CHANNEL_COUNT] = {
+    "co2", "temp_scd30", "temp_bmp280", "humidity", "pressure"
+};
+
+/**
+ * @brief Reads a whole file, or standard input for "-".
+ */
+static bool readFile(const char* path, std::string& out) {
+    if (strcmp(path, "-") == 0) {
+        char buffer[4096];
+        size_t received;
+        while ((received = fread(buffer, 1, sizeof(buffer), stdin)) > 0) {
+            out.append(buffer, received);
+        }
+        return true;
+    }
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return false;
+    }
+    std::ostringstream content;
+    content << file.rdbuf();
+    out = content.str();
+    return true;
+}
+
+/**
+ * @brief Returns a monotonic tick count: TSC cycles on x86, nanoseconds elsewhere.
+ */
+static uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * @brief Decodes all `HIST:` lines of the inputs and prints the readings as CSV.
+ *
+ * Blocks may overlap when the archive advanced during a dump, so samples are sorted
+ * by timestamp and duplicates are dropped.
+ */
+static int decode(const std::vector<const char*>& paths) {
+    std::vector<HistorySample> samples;
+    size_t blocks = 0;
+    size_t corrupt = 0;
+
+    for (const char* path : paths) {
+        std::string content;
+        if (!readFile(path, content)) {
+            return 1;
+        }
+        size_t position = 0;
+        while ((position = content.find("HIST:", position)) != std::string::npos) {
+            size_t begin = position + 5;
+            size_t end = content.find_first_of("\r\n", begin);
+            if (end == std::string::npos) {
+                end = content.size();
+            }
+            position = end;
+
+            uint8_t block[HISTORY_BLOCK_BYTES];
+            size_t size = decodeBase64(content.data() + begin, end - begin, block, sizeof(block));
+            HistoryDecoder decoder;
+            if (size == 0 || !decoder.begin(block, size)) {
+                corrupt++;
+                continue;
+            }
+            HistorySample sample;
+            uint16_t decoded = 0;
+            while (decoder.next(sample)) {
+                samples.push_back(sample);
+                decoded++;
+            }
+            if (decoded != decoder.getSampleCount()) {
+                corrupt++;
+            }
+            blocks++;
+        }
+    }
+
+    std::stable_sort(samples.begin(), samples.end(), [](const HistorySample& a, const HistorySample& b) {
+        return a.timestampMs < b.timestampMs;
+    });
+    samples.erase(std::unique(samples.begin(), samples.end(), [](const HistorySample& a, const HistorySample& b) {
+        return a.timestampMs == b.timestampMs;
+    }), samples.end());
+
+    printf("timestamp_ms");
+    for (const char* name : CHANNEL_NAMES) {
+        printf(",%s", name);
+    }
+    printf("\n");
+    for (const HistorySample& sample : samples) {
+        printf("%lu", static_cast<unsigned long>(sample.timestampMs));
+        for (float value : sample.values) {
+            printf(",%.2f", value);
+        }
+        printf("\n");
+    }
+    fprintf(stderr, "%zu blocks, %zu samples, %zu corrupt blocks\n", blocks, samples.size(), corrupt);
+    return corrupt == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Rebuilds the samples of a `Logger` text trace.
+ *
+ * The firmware prints each sample as five lines starting with `CO2:`. Traces carry no
+ * timestamps, so samples are spaced by `intervalMs` plus a deterministic jitter of up to
+ * `jitterMs` that mimics the timing of `loop()`.
+ *
+ * @param text The trace.
+ * @param samples Receives the samples.
+ * @param readingBytes Receives the size of the reading lines in the trace.
+ */
+static void parseTrace(const std::string& text, uint32_t intervalMs, uint32_t jitterMs,
+                       std::vector<HistorySample>& samples, size_t& readingBytes) {
+    static const int CHANNEL_MAP[CHANNEL_COUNT] = {
+        HISTORY_CO2, HISTORY_TEMP_SCD, HISTORY_TEMP_BMP, HISTORY_HUMIDITY, HISTORY_PRESSURE
+    };
+
+    HistorySample current = {};
+    bool pending = false;
+    uint32_t timestamp = 0;
+    uint32_t random = 12345;
+
+    size_t position = 0;
+    while (position < text.size()) {
+        size_t end = text.find('\n', position);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        std::string_view line(text.data() + position, end - position);
+        size_t lineBytes = end - position + 1;
+        position = end + 1;
+
+        LogLine parsed;
+        Channel channel;
+        float value;
+        if (!parseLogLine(line, parsed) || !parseReading(parsed.message, channel, value)) {
+            continue;
+        }
+        readingBytes += lineBytes;
+        if (channel == CHANNEL_CO2) {
+            if (pending) {
+                samples.push_back(current);
+            }
+            random = random * 1103515245 + 12345;
+            timestamp += intervalMs + (jitterMs > 0 ? (random >> 16) % (jitterMs + 1) : 0);
+            current.timestampMs = timestamp;
+            pending = true;
+        }
+        current.values[CHANNEL_MAP[channel]] = value;
+    }
+    if (pending) {
+        samples.push_back(current);
+    }
+}
+
+/**
+ * @brief Encodes traces block by block and reports compression ratio and encode cost.
+ */
+static int benchmark(const std::vector<const char*>& paths, uint32_t intervalMs, uint32_t jitterMs, unsigned repeat) {
+    std::vector<HistorySample> samples;
+    size_t readingBytes = 0;
+    for (const char* path : paths) {
+        std::string content;
+        if (!readFile(path, content)) {
+            return 1;
+        }
+        parseTrace(content, intervalMs, jitterMs, samples, readingBytes);
+    }
+    if (samples.empty()) {
+        fprintf(stderr, "No readings found\n");
+        return 1;
+    }
+
+    // Encode once for the size and the round-trip check
+    std::vector<std::vector<uint8_t>> blocks;
+    HistoryEncoder encoder;
+    for (const HistorySample& sample : samples) {
+        if (!encoder.append(sample)) {
+            blocks.emplace_back(encoder.getData(), encoder.getData() + encoder.getSize());
+            encoder.reset();
+            encoder.append(sample);
+        }
+    }
+    blocks.emplace_back(encoder.getData(), encoder.getData() + encoder.getSize());
+
+    size_t encodedBytes = 0;
+    size_t base64Bytes = 0;
+    float maxError[HISTORY_CHANNEL_COUNT] = {};
+    size_t index = 0;
+    for (const std::vector<uint8_t>& block : blocks) {
+        encodedBytes += block.size();
+        base64Bytes += 5 + 4 * ((block.size() + 2) / 3) + 2; // "HIST:" and CRLF
+        HistoryDecoder decoder;
+        decoder.begin(block.data(), block.size());
+        HistorySample decoded;
+        while (decoder.next(decoded)) {
+            const HistorySample& original = samples[index++];
+            if (decoded.timestampMs != original.timestampMs) {
+                fprintf(stderr, "Timestamp mismatch at sample %zu\n", index - 1);
+                return 1;
+            }
+            for (int i = 0; i < HISTORY_CHANNEL_COUNT; i++) {
+                maxError[i] = std::max(maxError[i], fabsf(decoded.values[i] - original.values[i]));
+            }
+        }
+    }
+    if (index != samples.size()) {
+        fprintf(stderr, "Decoded %zu of %zu samples\n", index, samples.size());
+        return 1;
+    }
+
+    // Time the encoder alone
+    uint64_t start = ticks();
+    for (unsigned r = 0; r < repeat; r++) {
+        encoder.reset();
+        for (const HistorySample& sample : samples) {
+            if (!encoder.append(sample)) {
+                encoder.reset();
+                encoder.append(sample);
+            }
+        }
+    }
+    uint64_t elapsed = ticks() - start;
+    double perSample = static_cast<double>(elapsed) / (static_cast<double>(repeat) * samples.size());
+
+    size_t binaryBytes = samples.size() * sizeof(HistorySample);
+    printf("samples:          %zu in %zu blocks\n", samples.size(), blocks.size());
+    printf("text readings:    %zu bytes (%.1f bytes/sample)\n", readingBytes, static_cast<double>(readingBytes) / samples.size());
+    printf("binary samples:   %zu bytes (%zu bytes/sample)\n", binaryBytes, sizeof(HistorySample));
+    printf("encoded:          %zu bytes (%.1f bits/sample)\n", encodedBytes, 8.0 * encodedBytes / samples.size());
+    printf("HIST lines:       %zu bytes\n", base64Bytes);
+    printf("ratio vs text:    %.1fx (%.1fx as HIST lines)\n",
+           static_cast<double>(readingBytes) / encodedBytes, static_cast<double>(readingBytes) / base64Bytes);
+    printf("ratio vs binary:  %.1fx\n", static_cast<double>(binaryBytes) / encodedBytes);
+#if defined(__x86_64__) || defined(__i386__)
+    printf("encode cost:      %.0f TSC cycles/sample\n", perSample);
+#else
+    printf("encode cost:      %.0f ns/sample\n", perSample);
+#endif
+    printf("max abs error:   ");
+    for (int i = 0; i < HISTORY_CHANNEL_COUNT; i++) {
+        printf(" %s %.3f", CHANNEL_NAMES[i], maxError[i]);
+    }
+    printf("\n");
+    return 0;
+}
+
+/**
+ * @brief Prints the command-line usage.
+ */
+static void printUsage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [FILE...]\n"
+            "       Decodes the HIST: lines of 'dump compressed' captures (default: stdin) to CSV\n"
+            "       %s --bench [--interval-ms MS] [--jitter-ms MS] [--repeat N] TRACE...\n"
+            "       Encodes the readings of Logger text traces and reports ratio and encode cost\n",
+            program, program);
+}
+
+int main(int argc, char** argv) {
+    bool bench = false;
+    unsigned long intervalMs = 2000;
+    unsigned long jitterMs = 20;
+    unsigned long repeat = 1000;
+    std::vector<const char*> paths;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--bench") == 0) {
+            bench = true;
+        } else if (strcmp(argv[i], "--interval-ms") == 0 && i + 1 < argc) {
+            intervalMs = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--jitter-ms") == 0 && i + 1 < argc) {
+            jitterMs = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = strtoul(argv[++i], nullptr, 10);
+        } else if (strncmp(argv[i], "--", 2) == 0) {
+            printUsage(argv[0]);
+            return 2;
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+
+    if (bench) {
+        if (paths.empty() || repeat == 0) {
+            printUsage(argv[0]);
+            return 2;
+        }
+        return benchmark(paths, intervalMs, jitterMs, repeat);
+    }
+    if (paths.empty()) {
+        paths.push_back("-");
+    }
+    return decode(paths);
+}
\ No newline at end of file
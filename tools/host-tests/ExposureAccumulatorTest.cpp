@@ -0,0 +1,205 @@
+#include <EEPROM.h>
+#include "ExposureAccumulator.h"
+#include "HostTest.h"
+#include "ReplayHardware.h"
+
+/**
+ * @file ExposureAccumulatorTest.cpp
+ * @brief Threshold crossings, sample gaps, rollovers and persistence of the exposure accumulator.
+ */
+
+static const unsigned long MS_PER_HOUR = 3600000UL;
+
+/**
+ * @brief Feeds a constant CO2 level every `stepMs` from `start` (exclusive) up to `end` (inclusive).
+ */
+static void feedConstant(ExposureAccumulator& accumulator, float co2, unsigned long start, unsigned long end,
+                         unsigned long stepMs) {
+    for (unsigned long t = start + stepMs; t <= end; t += stepMs) {
+        accumulator.addSample(co2, t);
+    }
+}
+
+TEST(exposureCrossingBetweenSamples) {
+    ExposureAccumulator accumulator;
+    // Rising through the moderate threshold halfway through a 10 s segment
+    accumulator.addSample(CO2_MODERATE_THRESHOLD - 100.0f, 0);
+    accumulator.addSample(CO2_MODERATE_THRESHOLD + 100.0f, 10000);
+    const ExposureTotals& hour = accumulator.getHour();
+    CHECK_NEAR(hour.secondsAbove[EXPOSURE_MODERATE], 5.0, 1e-4);
+    CHECK_NEAR(hour.ppmHours[EXPOSURE_MODERATE], 0.5 * 100.0 * 5.0 / 3600.0, 1e-6);
+    CHECK_EQ(hour.secondsAbove[EXPOSURE_CRITICAL], 0.0f);
+
+    // Falling through it a quarter of the way into the next segment
+    accumulator.addSample(CO2_MODERATE_THRESHOLD - 300.0f, 20000);
+    CHECK_NEAR(hour.secondsAbove[EXPOSURE_MODERATE], 7.5, 1e-4);
+    CHECK_NEAR(hour.ppmHours[EXPOSURE_MODERATE], (250.0 + 125.0) / 3600.0, 1e-6);
+
+    // A segment entirely above both thresholds counts the full trapezoid in both bands
+    accumulator.addSample(CO2_CRITICAL_THRESHOLD + 100.0f, 30000);
+    accumulator.addSample(CO2_CRITICAL_THRESHOLD + 300.0f, 40000);
+    const double crossing = 10.0 * 100.0 / 1400.0;
+    CHECK_NEAR(hour.secondsAbove[EXPOSURE_CRITICAL], crossing + 10.0, 1e-4);
+    CHECK_NEAR(hour.ppmHours[EXPOSURE_CRITICAL], (0.5 * 100.0 * crossing + 200.0 * 10.0) / 3600.0, 1e-6);
+    CHECK_NEAR(accumulator.getDay().ppmHours[EXPOSURE_CRITICAL], hour.ppmHours[EXPOSURE_CRITICAL], 1e-9);
+}
+
+TEST(exposureIrregularSpacing) {
+    ExposureAccumulator regular;
+    ExposureAccumulator irregular;
+    // The same linear ramp, sampled every 2 s and at uneven points
+    for (unsigned long t = 0; t <= 60000; t += 2000) {
+        regular.addSample(900.0f + t / 200.0f, t);
+    }
+    const unsigned long points[] = { 0, 500, 7000, 21300, 22000, 45000, 60000 };
+    for (unsigned long t : points) {
+        irregular.addSample(900.0f + t / 200.0f, t);
+    }
+    CHECK_NEAR(irregular.getHour().secondsAbove[EXPOSURE_MODERATE],
+               regular.getHour().secondsAbove[EXPOSURE_MODERATE], 1e-3);
+    CHECK_NEAR(irregular.getHour().ppmHours[EXPOSURE_MODERATE], regular.getHour().ppmHours[EXPOSURE_MODERATE], 1e-5);
+    CHECK_NEAR(regular.getHour().secondsAbove[EXPOSURE_MODERATE], 40.0, 1e-3);
+}
+
+TEST(exposureSkipsLongGaps) {
+    ExposureAccumulator accumulator;
+    accumulator.addSample(1500.0f, 0);
+    // Nothing is known about the level during a gap longer than the maximum interval
+    accumulator.addSample(1500.0f, EXPOSURE_MAX_SAMPLE_GAP_MS + 1000);
+    CHECK_EQ(accumulator.getHour().secondsAbove[EXPOSURE_MODERATE], 0.0f);
+
+    // The gap still advances the clock, and the next segment is integrated
+    accumulator.addSample(1500.0f, EXPOSURE_MAX_SAMPLE_GAP_MS + 61000);
+    CHECK_NEAR(accumulator.getHour().secondsAbove[EXPOSURE_MODERATE], 60.0, 1e-4);
+    ExposureRunningState state;
+    accumulator.getRunningState(state);
+    CHECK_EQ(state.hourElapsedMs, EXPOSURE_MAX_SAMPLE_GAP_MS + 61000);
+
+    // A gap of exactly the maximum interval is integrated
+    accumulator.addSample(1500.0f, 2 * EXPOSURE_MAX_SAMPLE_GAP_MS + 61000);
+    CHECK_NEAR(accumulator.getHour().secondsAbove[EXPOSURE_MODERATE], 60.0 + EXPOSURE_MAX_SAMPLE_GAP_MS / 1000.0, 1e-3);
+}
+
+TEST(exposureHourRollover) {
+    replay::reset();
+    ExposureAccumulator accumulator;
+    accumulator.begin();
+    accumulator.addSample(1500.0f, 0);
+    feedConstant(accumulator, 1500.0f, 0, MS_PER_HOUR, 60000);
+
+    // The segment ending on the boundary belongs to the completed hour
+    CHECK_NEAR(accumulator.getHour(1).secondsAbove[EXPOSURE_MODERATE], 3600.0, 1e-2);
+    CHECK_EQ(accumulator.getHour().secondsAbove[EXPOSURE_MODERATE], 0.0f);
+
+    feedConstant(accumulator, 1500.0f, MS_PER_HOUR, MS_PER_HOUR + 120000, 60000);
+    CHECK_NEAR(accumulator.getHour().secondsAbove[EXPOSURE_MODERATE], 120.0, 1e-3);
+    CHECK_NEAR(accumulator.getHour(1).ppmHours[EXPOSURE_MODERATE], 500.0, 1e-2);
+    // The running day spans both hours
+    CHECK_NEAR(accumulator.getDay().secondsAbove[EXPOSURE_MODERATE], 3720.0, 1e-2);
+
+    // A segment straddling the boundary is added to the hour it starts in; hours count
+    // operating time, so a long gap brings the clock close to the boundary first
+    ExposureAccumulator straddling;
+    straddling.addSample(1500.0f, 0);
+    straddling.addSample(1500.0f, MS_PER_HOUR - 30000);
+    straddling.addSample(1500.0f, MS_PER_HOUR + 30000);
+    CHECK_NEAR(straddling.getHour(1).secondsAbove[EXPOSURE_MODERATE], 60.0, 1e-4);
+    CHECK_EQ(straddling.getHour().secondsAbove[EXPOSURE_MODERATE], 0.0f);
+}
+
+TEST(exposureDayRollover) {
+    replay::reset();
+    ExposureAccumulator accumulator;
+    accumulator.begin();
+    accumulator.addSample(1500.0f, 0);
+    feedConstant(accumulator, 1500.0f, 0, 24 * MS_PER_HOUR, EXPOSURE_MAX_SAMPLE_GAP_MS);
+
+    ExposureRunningState state;
+    accumulator.getRunningState(state);
+    CHECK_EQ(state.currentDay, 1);
+    CHECK_EQ(state.hoursInDay, 0);
+    CHECK_EQ(state.hourElapsedMs, 0u);
+    CHECK_NEAR(accumulator.getDay(1).secondsAbove[EXPOSURE_MODERATE], 86400.0, 1.0);
+    CHECK_NEAR(accumulator.getDay(1).ppmHours[EXPOSURE_MODERATE], 24 * 500.0, 0.5);
+    CHECK_EQ(accumulator.getDay().secondsAbove[EXPOSURE_MODERATE], 0.0f);
+    // The hourly ring holds exactly one day, so the hour 24 ago is the running one
+    CHECK_NEAR(accumulator.getHour(23).secondsAbove[EXPOSURE_MODERATE], 3600.0, 1e-2);
+
+    // The day ring wraps after EXPOSURE_DAY_COUNT days and clears the reused slot
+    unsigned long end = (EXPOSURE_DAY_COUNT + 1) * 24 * MS_PER_HOUR;
+    feedConstant(accumulator, 900.0f, 24 * MS_PER_HOUR, end, EXPOSURE_MAX_SAMPLE_GAP_MS);
+    accumulator.getRunningState(state);
+    CHECK_EQ(state.currentDay, (EXPOSURE_DAY_COUNT + 1) % EXPOSURE_DAY_COUNT);
+    CHECK_EQ(accumulator.getDay().secondsAbove[EXPOSURE_MODERATE], 0.0f);
+    CHECK_EQ(accumulator.getDay(EXPOSURE_DAY_COUNT - 1).secondsAbove[EXPOSURE_MODERATE], 0.0f);
+}
+
+TEST(exposureRestoresFromEeprom) {
+    replay::reset();
+    {
+        ExposureAccumulator accumulator;
+        accumulator.begin();
+        accumulator.addSample(1500.0f, 0);
+        feedConstant(accumulator, 1500.0f, 0, 2 * MS_PER_HOUR + 600000, 60000);
+        CHECK_NEAR(accumulator.getHour().secondsAbove[EXPOSURE_MODERATE], 600.0, 1e-2);
+    }
+    // The record sits at its own address and leaves the calibration flag alone
+    CHECK_EQ(EEPROM.read(EEPROM_EXPOSURE_ADDRESS), 0x31);
+    CHECK_EQ(EEPROM.read(EEPROM_CALIBRATION_FLAG_ADDRESS), 0xFF);
+
+    // The rollovers were saved; the running hour restarts from the last rollover
+    ExposureAccumulator restored;
+    restored.begin();
+    ExposureRunningState state;
+    restored.getRunningState(state);
+    CHECK_EQ(state.currentHour, 2);
+    CHECK_EQ(state.hoursInDay, 2);
+    CHECK_EQ(state.hasLastSample, 0);
+    CHECK_NEAR(restored.getHour(1).secondsAbove[EXPOSURE_MODERATE], 3600.0, 1e-2);
+    CHECK_NEAR(restored.getHour(2).secondsAbove[EXPOSURE_MODERATE], 3600.0, 1e-2);
+    CHECK_NEAR(restored.getDay().secondsAbove[EXPOSURE_MODERATE], 7200.0, 1e-1);
+    CHECK(restored.save());
+
+    // A flipped bit invalidates the record
+    EEPROM.write(EEPROM_EXPOSURE_ADDRESS + 12, EEPROM.read(EEPROM_EXPOSURE_ADDRESS + 12) ^ 0x01);
+    ExposureAccumulator corrupted;
+    corrupted.begin();
+    CHECK_EQ(corrupted.getHour(1).secondsAbove[EXPOSURE_MODERATE], 0.0f);
+    CHECK_EQ(corrupted.getDay().secondsAbove[EXPOSURE_MODERATE], 0.0f);
+}
+
+TEST(exposureRunningStateAcrossSleep) {
+    replay::reset();
+    ExposureRunningState state;
+    {
+        ExposureAccumulator accumulator;
+        accumulator.begin();
+        accumulator.addSample(1500.0f, 0);
+        accumulator.addSample(1500.0f, 60000);
+        accumulator.getRunningState(state);
+    }
+
+    ExposureAccumulator resumed;
+    resumed.begin();
+    CHECK(resumed.setRunningState(state));
+    resumed.addSample(1500.0f, 120000);
+    CHECK_NEAR(resumed.getHour().secondsAbove[EXPOSURE_MODERATE], 120.0, 1e-3);
+
+    // A snapshot from before a rollover no longer matches the tables
+    state.currentHour = 5;
+    CHECK(!resumed.setRunningState(state));
+}
+
+TEST(exposureThresholdsCanChange) {
+    ExposureAccumulator accumulator;
+    CHECK_EQ(accumulator.getThreshold(EXPOSURE_MODERATE), static_cast<float>(CO2_MODERATE_THRESHOLD));
+    CHECK(!accumulator.setThresholds(1500.0f, 1200.0f));
+    CHECK(!accumulator.setThresholds(0.0f, 1200.0f));
+    CHECK_EQ(accumulator.getThreshold(EXPOSURE_CRITICAL), static_cast<float>(CO2_CRITICAL_THRESHOLD));
+
+    CHECK(accumulator.setThresholds(800.0f, 1200.0f));
+    accumulator.addSample(1000.0f, 0);
+    accumulator.addSample(1000.0f, 10000);
+    CHECK_NEAR(accumulator.getHour().ppmHours[EXPOSURE_MODERATE], 200.0 * 10.0 / 3600.0, 1e-6);
+    CHECK_EQ(accumulator.getHour().secondsAbove[EXPOSURE_CRITICAL], 0.0f);
+}
\ No newline at end of file
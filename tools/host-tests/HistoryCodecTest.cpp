@@ -0,0 +1,215 @@
+#include <string.h>
+#include <vector>
+#include "HistoryArchive.h"
+#include "HistoryCodec.h"
+#include "HostTest.h"
+
+/**
+ * @file HistoryCodecTest.cpp
+ * @brief Round trips, width class boundaries, block limits and corrupt input of the history codec.
+ */
+
+/**
+ * @brief Builds a sample with every channel set to the same reading.
+ */
+static HistorySample makeSample(uint32_t timestampMs, float value) {
+    HistorySample sample;
+    sample.timestampMs = timestampMs;
+    for (int i = 0; i < HISTORY_CHANNEL_COUNT; i++) {
+        sample.values[i] = value;
+    }
+    return sample;
+}
+
+/**
+ * @brief Encodes samples into one block, decodes it and checks every sample survived.
+ *
+ * @return The size of the block in bytes.
+ */
+static size_t roundTrip(const std::vector<HistorySample>& samples) {
+    HistoryEncoder encoder;
+    for (const HistorySample& sample : samples) {
+        CHECK(encoder.append(sample));
+    }
+
+    HistoryDecoder decoder;
+    CHECK(decoder.begin(encoder.getData(), encoder.getSize()));
+    CHECK_EQ(decoder.getSampleCount(), samples.size());
+    HistorySample decoded;
+    for (const HistorySample& sample : samples) {
+        CHECK(decoder.next(decoded));
+        CHECK_EQ(decoded.timestampMs, sample.timestampMs);
+        for (int i = 0; i < HISTORY_CHANNEL_COUNT; i++) {
+            CHECK_EQ(quantizeReading(decoded.values[i]), quantizeReading(sample.values[i]));
+        }
+    }
+    CHECK(!decoder.next(decoded));
+    return encoder.getSize();
+}
+
+TEST(historySteadySamplesCostSixBits) {
+    std::vector<HistorySample> samples;
+    for (uint32_t i = 0; i < 200; i++) {
+        samples.push_back(makeSample(1000 + 2000 * i, 612.34f));
+    }
+    // The first sample is uncompressed and the second one stores the interval (a 12-bit
+    // class); from then on a sample costs one bit for the timestamp and one per channel
+    size_t bits = 8 * HISTORY_HEADER_BYTES + 32 * (1 + HISTORY_CHANNEL_COUNT);
+    bits += 4 + 12 + HISTORY_CHANNEL_COUNT;
+    bits += 198 * (1 + HISTORY_CHANNEL_COUNT);
+    CHECK_EQ(roundTrip(samples), (bits + 7) / 8);
+}
+
+TEST(historyValueClassBoundaries) {
+    // Deltas in hundredths on both sides of every class boundary, and escapes to full values
+    const int32_t deltas[] = { 0, 1, -1, 7, -8, 8, -9, 127, -128, 128, -129, 2047, -2048, 2048, -2049,
+                               1000000, -2000000 };
+    std::vector<HistorySample> samples;
+    int32_t level = 50000;
+    uint32_t timestamp = 0;
+    samples.push_back(makeSample(timestamp, level / 100.0f));
+    for (int32_t delta : deltas) {
+        level += delta;
+        timestamp += 2000;
+        samples.push_back(makeSample(timestamp, level / 100.0f));
+    }
+    roundTrip(samples);
+
+    // The clamped extremes differ by 2e9 steps, more than an int32 difference holds
+    std::vector<HistorySample> extremes = { makeSample(0, 3.0e38f), makeSample(1, -3.0e38f), makeSample(2, NAN),
+                                            makeSample(3, 3.0e38f) };
+    HistoryEncoder encoder;
+    for (const HistorySample& sample : extremes) {
+        CHECK(encoder.append(sample));
+    }
+    HistoryDecoder decoder;
+    decoder.begin(encoder.getData(), encoder.getSize());
+    HistorySample decoded;
+    const int32_t expected[] = { 1000000000, -1000000000, 0, 1000000000 };
+    for (int32_t value : expected) {
+        CHECK(decoder.next(decoded));
+        CHECK_EQ(quantizeReading(decoded.values[HISTORY_CO2]), value);
+    }
+}
+
+TEST(historyTimestampDeltaOfDelta) {
+    // Jitter at the class boundaries, negative delta-of-delta, long pauses and a millis() wrap
+    const uint32_t intervals[] = { 2000, 2000, 2063, 1937, 2064, 1936, 2255, 1745, 2256, 1744, 4047, 0,
+                                   4048, 2000, 600000, 2000, 0xFFFFFFFFUL, 2000 };
+    std::vector<HistorySample> samples;
+    uint32_t timestamp = 0xFFFF0000UL;
+    samples.push_back(makeSample(timestamp, 400.0f));
+    for (uint32_t interval : intervals) {
+        timestamp += interval;
+        samples.push_back(makeSample(timestamp, 400.0f));
+    }
+    roundTrip(samples);
+}
+
+TEST(historyFullBlockIsUnchanged) {
+    HistoryEncoder encoder;
+    uint32_t count = 0;
+    // Noisy values so that every sample needs several bits per channel
+    while (encoder.append(makeSample(2000 * count, 400.0f + (count * 37 % 41) - 20.0f))) {
+        count++;
+    }
+    CHECK(count > 10);
+    CHECK(encoder.getSize() <= HISTORY_BLOCK_BYTES);
+    CHECK_EQ(encoder.getSampleCount(), count);
+
+    // The rejected sample left no bits behind, and the block still decodes completely
+    std::vector<uint8_t> block(encoder.getData(), encoder.getData() + encoder.getSize());
+    CHECK(!encoder.append(makeSample(2000 * count, 0.0f)));
+    CHECK_EQ(encoder.getSize(), block.size());
+    CHECK_EQ(memcmp(encoder.getData(), block.data(), block.size()), 0);
+
+    HistoryDecoder decoder;
+    decoder.begin(block.data(), block.size());
+    HistorySample decoded;
+    for (uint32_t i = 0; i < count; i++) {
+        CHECK(decoder.next(decoded));
+        CHECK_EQ(decoded.timestampMs, 2000 * i);
+    }
+    CHECK(!decoder.next(decoded));
+}
+
+TEST(historyArchiveStartsNewBlockWhenFull) {
+    HistoryArchive archive;
+    HistoryEncoder reference;
+    uint32_t count = 0;
+    while (reference.append(makeSample(2000 * count, 500.0f + count))) {
+        archive.append(makeSample(2000 * count, 500.0f + count));
+        count++;
+    }
+    CHECK_EQ(archive.getBlockCount(), 1);
+
+    // The first sample that does not fit opens the next block as its uncompressed first sample
+    archive.append(makeSample(2000 * count, 500.0f + count));
+    CHECK_EQ(archive.getBlockCount(), 2);
+    CHECK_EQ(archive.getBlock(0).getSampleCount(), count);
+    CHECK_EQ(archive.getBlock(1).getSampleCount(), 1);
+    HistoryDecoder decoder;
+    CHECK(decoder.begin(archive.getBlock(1).getData(), archive.getBlock(1).getSize()));
+    HistorySample decoded;
+    CHECK(decoder.next(decoded));
+    CHECK_EQ(decoded.timestampMs, 2000 * count);
+    CHECK_EQ(quantizeReading(decoded.values[HISTORY_CO2]), quantizeReading(500.0f + count));
+    CHECK_EQ(archive.getStoredSamples(), count + 1);
+}
+
+TEST(historyTruncatedBlockStopsDecoding) {
+    const uint16_t count = 20;
+    HistoryEncoder encoder;
+    for (uint32_t i = 0; i < count; i++) {
+        CHECK(encoder.append(makeSample(2000 * i + (i % 3) * 7, 800.0f + (i % 5) * 1.5f)));
+    }
+    size_t size = encoder.getSize();
+
+    // Every truncation yields a prefix of the samples and then stops, without reading past the end
+    for (size_t cut = HISTORY_HEADER_BYTES; cut < size; cut++) {
+        std::vector<uint8_t> truncated(encoder.getData(), encoder.getData() + cut);
+        HistoryDecoder decoder;
+        CHECK(decoder.begin(truncated.data(), truncated.size()));
+        CHECK_EQ(decoder.getSampleCount(), count);
+        HistorySample decoded;
+        uint32_t samples = 0;
+        while (decoder.next(decoded)) {
+            CHECK_EQ(decoded.timestampMs, 2000 * samples + (samples % 3) * 7);
+            samples++;
+        }
+        CHECK(samples < count);
+    }
+
+    // Headers that are too short or of another format are rejected
+    HistoryDecoder decoder;
+    CHECK(!decoder.begin(encoder.getData(), HISTORY_HEADER_BYTES - 1));
+    std::vector<uint8_t> block(encoder.getData(), encoder.getData() + size);
+    block[0] = HISTORY_FORMAT_VERSION + 1;
+    CHECK(!decoder.begin(block.data(), block.size()));
+    HistorySample decoded;
+    CHECK(!decoder.next(decoded));
+}
+
+TEST(historyBase64RoundTrip) {
+    uint8_t data[HISTORY_BLOCK_BYTES];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = static_cast<uint8_t>(i * 151 + 7);
+    }
+    char text[4 * ((sizeof(data) + 2) / 3) + 1];
+    uint8_t decoded[sizeof(data)];
+    for (size_t size = 0; size <= 5; size++) {
+        size_t length = encodeBase64(data, size, text, sizeof(text));
+        CHECK_EQ(length, 4 * ((size + 2) / 3));
+        CHECK_EQ(decodeBase64(text, length, decoded, sizeof(decoded)), size);
+        CHECK_EQ(memcmp(decoded, data, size), 0);
+    }
+    size_t length = encodeBase64(data, sizeof(data), text, sizeof(text));
+    CHECK_EQ(decodeBase64(text, length, decoded, sizeof(decoded)), sizeof(data));
+    CHECK_EQ(memcmp(decoded, data, sizeof(data)), 0);
+
+    CHECK_EQ(encodeBase64(data, 3, text, 4), 0u);
+    CHECK_EQ(decodeBase64("QUJD", 3, decoded, sizeof(decoded)), 0u);
+    CHECK_EQ(decodeBase64("Q=JD", 4, decoded, sizeof(decoded)), 0u);
+    CHECK_EQ(decodeBase64("QU*D", 4, decoded, sizeof(decoded)), 0u);
+    CHECK_EQ(decodeBase64("QUJD", 4, decoded, 2), 0u);
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <math.h>
+#include <stdint.h>
+
+/**
+ * @file HostTest.h
+ * @brief Minimal test and benchmark registry for the host tests of the firmware sources.
+ *
+ * `TEST(name)` and `BENCH(name)` define a function and register it before `main()` runs.
+ * A failed `CHECK` reports the expression and continues with the next check, so one run
+ * lists every broken expectation of a test.
+ */
+
+namespace hosttest {
+
+/**
+ * @struct Case
+ * @brief One registered test or benchmark.
+ */
+struct Case {
+    const char* name; ///< Name given to `TEST` or `BENCH`
+    void (*run)(); ///< The test body
+    bool bench; ///< Whether the case is a benchmark
+    Case* next; ///< Next registered case
+};
+
+/**
+ * @brief Adds a case to the registry.
+ *
+ * @return Always `true`, so the call can initialize a static.
+ */
+bool add(Case& testCase);
+
+/**
+ * @brief Records a failed check of the running test.
+ */
+void fail(const char* file, int line, const char* expression);
+
+/**
+ * @brief Advances a linear congruential generator and returns a value in [0, 1).
+ */
+inline double uniform(uint32_t& state) {
+    state = state * 1664525UL + 1013904223UL;
+    return (state >> 8) / 16777216.0;
+}
+
+/**
+ * @brief Returns an approximately normal value with mean 0 and standard deviation 1.
+ *
+ * The sum of twelve uniform values is deterministic and good enough for sensor noise.
+ */
+inline double gaussian(uint32_t& state) {
+    double sum = 0;
+    for (int i = 0; i < 12; i++) {
+        sum += uniform(state);
+    }
+    return sum - 6.0;
+}
+
+} // namespace hosttest
+
+#define HOST_TEST_CASE(name, isBench)                                                          \
+    static void name();                                                                      \
+    static hosttest::Case name##Case = { #name, name, isBench, nullptr };                    \
+    static const bool name##Registered = hosttest::add(name##Case);                          \
+    static void name()
+
+#define TEST(name) HOST_TEST_CASE(name, false)
+#define BENCH(name) HOST_TEST_CASE(name, true)
+
+#define CHECK(expression)                                                                    \
+    do {                                                                                     \
+        if (!(expression)) {                                                                 \
+            hosttest::fail(__FILE__, __LINE__, #expression);                                 \
+        }                                                                                    \
+    } while (0)
+
+#define CHECK_EQ(actual, expected) CHECK((actual) == (expected))
+#define CHECK_NEAR(actual, expected, tolerance) CHECK(fabs((actual) - (expected)) <= (tolerance))
+
+#endif // HOST_TEST_H
@@ -0,0 +1,315 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <memory>
+#include <string>
+#include "HostTest.h"
+#include "MetricsServer.h"
+
+/**
+ * @file MetricsServerTest.cpp
+ * @brief Scrapes the metrics server over 127.0.0.1 with real sockets.
+ */
+
+/**
+ * @class PosixMetricsSocket
+ * @brief Non-blocking listening socket on an ephemeral port of 127.0.0.1.
+ */
+class PosixMetricsSocket : public MetricsSocket {
+public:
+    size_t writeRoom = 1460; ///< Bytes the send buffer reports as free, one TCP segment on the device
+    uint16_t port = 0; ///< Port chosen by the kernel
+    unsigned accepted = 0; ///< Connections accepted so far
+    int listener = -1; ///< Listening socket
+    int connection = -1; ///< Connection being served, or -1
+
+    ~PosixMetricsSocket() override {
+        close();
+        if (listener >= 0) {
+            ::close(listener);
+        }
+    }
+
+    void begin() override {
+        listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        if (bind(listener, reinterpret_cast<sockaddr*>(&address), length) != 0 || listen(listener, 4) != 0 ||
+            getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+            perror("metrics socket");
+            exit(1);
+        }
+        fcntl(listener, F_SETFL, O_NONBLOCK);
+        port = ntohs(address.sin_port);
+    }
+
+    bool accept() override {
+        connection = ::accept(listener, nullptr, nullptr);
+        if (connection < 0) {
+            return false;
+        }
+        fcntl(connection, F_SETFL, O_NONBLOCK);
+        accepted++;
+        return true;
+    }
+
+    int available() override {
+        int count = 0;
+        return connection >= 0 && ioctl(connection, FIONREAD, &count) == 0 ? count : 0;
+    }
+
+    int read() override {
+        unsigned char c;
+        return connection >= 0 && recv(connection, &c, 1, 0) == 1 ? c : -1;
+    }
+
+    size_t availableForWrite() override {
+        return connection >= 0 ? writeRoom : 0;
+    }
+
+    size_t write(const uint8_t* data, size_t length) override {
+        ssize_t written = send(connection, data, length, MSG_NOSIGNAL);
+        return written > 0 ? static_cast<size_t>(written) : 0;
+    }
+
+    bool connected() override {
+        if (connection < 0) {
+            return false;
+        }
+        char c;
+        ssize_t peeked = recv(connection, &c, 1, MSG_PEEK);
+        return peeked > 0 || (peeked < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+    }
+
+    void close() override {
+        if (connection < 0) {
+            return;
+        }
+        // Closing with unread request bytes would reset the connection and discard the response
+        shutdown(connection, SHUT_WR);
+        char discard[256];
+        while (recv(connection, discard, sizeof(discard), 0) > 0) {
+        }
+        ::close(connection);
+        connection = -1;
+    }
+};
+
+/**
+ * @struct ScrapeFixture
+ * @brief The server on a loopback socket and one scraping client.
+ */
+struct ScrapeFixture {
+    PosixMetricsSocket socket;
+    MetricsPage page;
+    MetricsServer server{ socket, page };
+    unsigned long now = 0; ///< Time of the next poll in ms, advancing 1 ms per poll
+    int client = -1; ///< Client end of the connection, or -1
+    std::string received; ///< Response bytes received by the client
+    bool peerClosed = false; ///< Whether the server closed the connection
+
+    ~ScrapeFixture() {
+        disconnect();
+    }
+
+    /**
+     * @brief Opens a client connection to the server.
+     */
+    void connectClient() {
+        client = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(socket.port);
+        if (connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            perror("metrics client");
+            exit(1);
+        }
+        fcntl(client, F_SETFL, O_NONBLOCK);
+        received.clear();
+        peerClosed = false;
+    }
+
+    /**
+     * @brief Closes the client end.
+     */
+    void disconnect() {
+        if (client >= 0) {
+            ::close(client);
+            client = -1;
+        }
+    }
+
+    /**
+     * @brief Sends request bytes from the client.
+     */
+    void send(const std::string& text) {
+        CHECK_EQ(::send(client, text.data(), text.size(), MSG_NOSIGNAL), static_cast<ssize_t>(text.size()));
+    }
+
+    /**
+     * @brief Polls the server once and collects what the client received.
+     */
+    void poll() {
+        server.poll(now++);
+        char buffer[512];
+        ssize_t count;
+        while ((count = recv(client, buffer, sizeof(buffer), 0)) > 0) {
+            received.append(buffer, count);
+        }
+        peerClosed = peerClosed || count == 0;
+    }
+
+    /**
+     * @brief Sends a request in pieces of `pieceSize` bytes, one per poll, and reads the response.
+     *
+     * @return The response, complete once the server closed the connection.
+     */
+    std::string scrape(const std::string& request, size_t pieceSize = 4096) {
+        connectClient();
+        for (size_t sent = 0; !peerClosed && now < 100000; ) {
+            if (sent < request.size()) {
+                send(request.substr(sent, pieceSize));
+                sent += pieceSize;
+            }
+            poll();
+        }
+        disconnect();
+        return received;
+    }
+};
+
+static const char SCRAPE_REQUEST[] = "GET /metrics HTTP/1.1\r\nHost: 127.0.0.1\r\nAccept: text/plain\r\n\r\n";
+
+/**
+ * @brief Creates a fixture on the heap with the server listening.
+ */
+static std::unique_ptr<ScrapeFixture> makeFixture() {
+    std::unique_ptr<ScrapeFixture> fixture(new ScrapeFixture());
+    fixture->server.begin();
+    return fixture;
+}
+
+/**
+ * @brief Reads the value of a metric line, or NaN if the line is missing.
+ */
+static double valueOf(const std::string& response, const char* name) {
+    size_t position = response.find(std::string("\n") + name + " ");
+    return position == std::string::npos ? NAN : atof(response.c_str() + position + strlen(name) + 2);
+}
+
+TEST(metricsScrapeOverLoopback) {
+    auto fixture = makeFixture();
+    fixture->page.setValue(METRIC_CO2, 612.5);
+    std::string response = fixture->scrape(SCRAPE_REQUEST);
+    CHECK_EQ(response, std::string(fixture->page.getResponse(), fixture->page.getResponseLength()));
+    CHECK_EQ(response.compare(0, 17, "HTTP/1.1 200 OK\r\n"), 0);
+    CHECK_EQ(valueOf(response, "co2meter_co2_ppm"), 612.5);
+    CHECK_EQ(valueOf(response, "co2meter_scrapes_total"), 1.0);
+
+    size_t body = response.find("\r\n\r\n") + 4;
+    CHECK_EQ(atol(response.c_str() + response.find("Content-Length:") + 15), static_cast<long>(response.size() - body));
+
+    // The connection is closed after each response; the next scrape gets a new one
+    CHECK_EQ(valueOf(fixture->scrape(SCRAPE_REQUEST), "co2meter_scrapes_total"), 2.0);
+    CHECK_EQ(fixture->socket.accepted, 2u);
+}
+
+TEST(metricsPartialReadsAndWrites) {
+    auto fixture = makeFixture();
+    // The request trickles in one byte per poll, the response leaves 7 bytes per poll
+    fixture->socket.writeRoom = 7;
+    std::string response = fixture->scrape(SCRAPE_REQUEST, 1);
+    CHECK_EQ(response, std::string(fixture->page.getResponse(), fixture->page.getResponseLength()));
+    CHECK(fixture->now >= sizeof(SCRAPE_REQUEST) - 1 + fixture->page.getResponseLength() / 7);
+}
+
+TEST(metricsReadIsBoundedPerPoll) {
+    auto fixture = makeFixture();
+    fixture->connectClient();
+    fixture->send("GET /metrics HTTP/1.1\r\nX-Padding: " + std::string(600, 'a') + "\r\n\r\n");
+    fixture->poll();
+    fixture->poll();
+    CHECK(fixture->received.empty());
+    // 600 padding bytes at METRICS_MAX_BYTES_PER_POLL per poll
+    for (int i = 0; i < 3 && !fixture->peerClosed; i++) {
+        fixture->poll();
+    }
+    CHECK_EQ(valueOf(fixture->received, "co2meter_scrapes_total"), 1.0);
+}
+
+TEST(metricsRejectsOversizedRequests) {
+    auto fixture = makeFixture();
+    std::string headers = "GET /metrics HTTP/1.1\r\nX-Padding: " + std::string(HTTP_MAX_REQUEST_BYTES, 'a') + "\r\n\r\n";
+    CHECK_EQ(fixture->scrape(headers).compare(0, 26, "HTTP/1.1 400 Bad Request\r\n"), 0);
+
+    std::string line = "GET /metrics?" + std::string(HTTP_REQUEST_LINE_SIZE, 'q') + " HTTP/1.1\r\n\r\n";
+    CHECK_EQ(fixture->scrape(line, 16).compare(0, 26, "HTTP/1.1 400 Bad Request\r\n"), 0);
+    CHECK_EQ(fixture->scrape("GET / HTTP/1.1\r\n\r\n").compare(0, 24, "HTTP/1.1 404 Not Found\r\n"), 0);
+
+    // Rejected requests are not counted as scrapes, and the server still answers
+    CHECK_EQ(valueOf(fixture->scrape(SCRAPE_REQUEST), "co2meter_scrapes_total"), 1.0);
+}
+
+TEST(metricsDropsIdleClients) {
+    auto fixture = makeFixture();
+    fixture->connectClient();
+    fixture->send("GET /met");
+    while (!fixture->peerClosed && fixture->now <= METRICS_CLIENT_TIMEOUT_MS) {
+        fixture->poll();
+    }
+    CHECK(fixture->peerClosed);
+    CHECK(fixture->received.empty());
+    CHECK_EQ(fixture->now, METRICS_CLIENT_TIMEOUT_MS + 1);
+    fixture->disconnect();
+
+    CHECK_EQ(valueOf(fixture->scrape(SCRAPE_REQUEST), "co2meter_scrapes_total"), 1.0);
+}
+
+TEST(metricsHoldsPageDuringResponse) {
+    auto fixture = makeFixture();
+    fixture->socket.writeRoom = 100;
+    fixture->page.setValue(METRIC_CO2, 600.0);
+    fixture->connectClient();
+    fixture->send(SCRAPE_REQUEST);
+    fixture->poll();
+    CHECK_EQ(fixture->received.size(), 100u);
+
+    // A sample is patched in while the response is half sent
+    fixture->page.setValue(METRIC_CO2, 1234.0);
+    CHECK_EQ(valueOf(fixture->page.getResponse(), "co2meter_co2_ppm"), 600.0);
+    while (!fixture->peerClosed) {
+        fixture->poll();
+    }
+    CHECK_EQ(valueOf(fixture->received, "co2meter_co2_ppm"), 600.0);
+    fixture->disconnect();
+
+    // The deferred value is applied once the response is complete
+    CHECK_EQ(valueOf(fixture->page.getResponse(), "co2meter_co2_ppm"), 1234.0);
+    CHECK_EQ(valueOf(fixture->scrape(SCRAPE_REQUEST), "co2meter_co2_ppm"), 1234.0);
+}
+
+TEST(metricsReleasesPageWhenClientLeaves) {
+    auto fixture = makeFixture();
+    fixture->socket.writeRoom = 100;
+    fixture->connectClient();
+    fixture->send(SCRAPE_REQUEST);
+    fixture->poll();
+    fixture->page.setValue(METRIC_UPTIME, 42);
+
+    // The scraper gives up half-way through the response
+    fixture->disconnect();
+    for (int i = 0; i < 5; i++) {
+        fixture->server.poll(fixture->now++);
+    }
+    CHECK_EQ(fixture->socket.connection, -1);
+    CHECK_EQ(valueOf(fixture->page.getResponse(), "co2meter_uptime_seconds"), 42.0);
+}
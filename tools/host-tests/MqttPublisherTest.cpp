@@ -0,0 +1,266 @@
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "HostTest.h"
+#include "MqttPublisher.h"
+
+/**
+ * @file MqttPublisherTest.cpp
+ * @brief Batching, offline queueing, drain rate and statistics of the MQTT publisher.
+ */
+
+/**
+ * @class FakeMqttTransport
+ * @brief In-memory broker connection that records the published messages.
+ */
+class FakeMqttTransport : public MqttTransport {
+public:
+    bool brokerUp = true; ///< Whether connection attempts succeed and the connection stays up
+    bool acceptPublish = true; ///< Whether publishes succeed
+    bool connected = false; ///< Connection state
+    unsigned connectAttempts = 0; ///< Calls to `connect()`
+    std::vector<unsigned long> attemptTimes; ///< Time of every `connect()` call in ms
+    std::vector<std::string> messages; ///< Published payloads, in order
+    std::vector<unsigned long> publishTimes; ///< Time of every successful publish in ms
+    unsigned long now = 0; ///< Time of the current `poll()`, set by the test
+
+    bool connect() override {
+        connectAttempts++;
+        attemptTimes.push_back(now);
+        connected = brokerUp;
+        return connected;
+    }
+
+    bool isConnected() override {
+        connected = connected && brokerUp;
+        return connected;
+    }
+
+    bool publish(const char* topic, const char* payload, size_t length) override {
+        if (!acceptPublish || strcmp(topic, MQTT_TOPIC) != 0) {
+            return false;
+        }
+        messages.push_back(std::string(payload, length));
+        publishTimes.push_back(now);
+        return true;
+    }
+
+    void loop() override {}
+};
+
+/**
+ * @brief Builds a sample with distinct readings.
+ */
+static HistorySample makeSample(unsigned long timestampMs, float co2) {
+    HistorySample sample = {};
+    sample.timestampMs = static_cast<uint32_t>(timestampMs);
+    sample.values[HISTORY_CO2] = co2;
+    sample.values[HISTORY_TEMP_SCD] = 24.1f;
+    sample.values[HISTORY_TEMP_BMP] = 22.0f;
+    sample.values[HISTORY_HUMIDITY] = 45.5f;
+    sample.values[HISTORY_PRESSURE] = 1013.25f;
+    return sample;
+}
+
+/**
+ * @brief Runs the device loop: a sample every `sampleIntervalMs` (none if 0), polls every 100 ms.
+ */
+static void runFor(MqttPublisher& publisher, FakeMqttTransport& transport, unsigned long& now,
+                   unsigned long durationMs, unsigned long sampleIntervalMs = 2000) {
+    unsigned long end = now + durationMs;
+    for (; now < end; now += 100) {
+        transport.now = now;
+        if (sampleIntervalMs > 0 && now % sampleIntervalMs == 0) {
+            publisher.addSample(makeSample(now, 600.0f + (now / 2000) % 100), now);
+        }
+        publisher.poll(now);
+    }
+}
+
+/**
+ * @brief Time after which the loop of `runFor()` has closed `count` batches.
+ *
+ * A batch opens with its first sample and closes in the poll one interval later, so it holds
+ * both end samples and the next batch opens with the sample after that.
+ */
+static unsigned long closedAfter(unsigned count) {
+    return MQTT_BATCH_INTERVAL_MS + (count - 1) * (MQTT_BATCH_INTERVAL_MS + 2000) + 100;
+}
+
+/**
+ * @brief Counts the samples of a batch payload.
+ */
+static size_t countSamples(const std::string& payload) {
+    size_t count = 0;
+    for (size_t i = payload.find("\"samples\":[") + 11; i < payload.size(); i++) {
+        count += payload[i] == '[';
+    }
+    return count;
+}
+
+/**
+ * @brief Extracts the sequence number of a batch payload.
+ */
+static long sequenceOf(const std::string& payload) {
+    size_t position = payload.find("\"seq\":");
+    return position == std::string::npos ? -1 : atol(payload.c_str() + position + 6);
+}
+
+TEST(mqttBatchesSamplesPerInterval) {
+    FakeMqttTransport transport;
+    MqttPublisher publisher(transport);
+    unsigned long now = 0;
+    runFor(publisher, transport, now, closedAfter(3));
+
+    CHECK_EQ(transport.messages.size(), 3u);
+    const std::string& first = transport.messages[0];
+    CHECK_EQ(first.rfind("{\"device\":\"co2-meter\",\"seq\":0,\"samples\":[[0,600.00,24.10,22.00,45.50,1013.25],", 0), 0u);
+    CHECK_EQ(first.substr(first.size() - 2), "]}");
+    CHECK_EQ(countSamples(first), MQTT_BATCH_INTERVAL_MS / 2000 + 1);
+    CHECK_EQ(transport.messages[1].rfind("{\"device\":\"co2-meter\",\"seq\":1,\"samples\":[[32000,", 0), 0u);
+    for (size_t i = 0; i < transport.messages.size(); i++) {
+        CHECK_EQ(sequenceOf(transport.messages[i]), static_cast<long>(i));
+    }
+}
+
+TEST(mqttSplitsFullBatches) {
+    FakeMqttTransport transport;
+    MqttPublisher publisher(transport);
+    // A burst far larger than one payload, within one batch interval
+    for (unsigned long i = 0; i < 40; i++) {
+        publisher.addSample(makeSample(i, 1234.56f), 0);
+    }
+    unsigned long now = 0;
+    runFor(publisher, transport, now, closedAfter(1));
+    // Let the batch opened by the last split close and go out
+    runFor(publisher, transport, now, MQTT_BATCH_INTERVAL_MS + 1000, 0);
+
+    CHECK(transport.messages.size() >= 3);
+    size_t samples = 0;
+    for (const std::string& message : transport.messages) {
+        CHECK(message.size() <= MQTT_PAYLOAD_SIZE);
+        CHECK_EQ(message.substr(message.size() - 2), "]}");
+        samples += countSamples(message);
+    }
+    CHECK_EQ(samples, 40u + MQTT_BATCH_INTERVAL_MS / 2000 + 1);
+}
+
+TEST(mqttQueuesWhileOfflineAndDropsOldest) {
+    FakeMqttTransport transport;
+    transport.brokerUp = false;
+    MqttPublisher publisher(transport);
+    unsigned long now = 0;
+    const unsigned batches = MQTT_QUEUE_SLOTS + 3;
+    runFor(publisher, transport, now, closedAfter(batches));
+
+    const MqttPublisherStats& stats = publisher.getStatistics();
+    CHECK(transport.messages.empty());
+    CHECK_EQ(stats.queueDepth, MQTT_QUEUE_SLOTS);
+    CHECK_EQ(stats.maxQueueDepth, MQTT_QUEUE_SLOTS);
+    CHECK_EQ(stats.dropped, 3u);
+
+    // After the broker returns, the kept batches go out oldest first, without gaps
+    transport.brokerUp = true;
+    runFor(publisher, transport, now, MQTT_RECONNECT_MAX_MS + 10000, 0);
+    CHECK_EQ(transport.messages.size(), static_cast<size_t>(MQTT_QUEUE_SLOTS));
+    for (size_t i = 0; i < transport.messages.size(); i++) {
+        CHECK_EQ(sequenceOf(transport.messages[i]), static_cast<long>(3 + i));
+    }
+    CHECK_EQ(stats.reconnects, 1u);
+    CHECK_EQ(stats.queueDepth, 0);
+}
+
+TEST(mqttDrainIsRateLimited) {
+    FakeMqttTransport transport;
+    transport.brokerUp = false;
+    MqttPublisher publisher(transport);
+    unsigned long now = 0;
+    runFor(publisher, transport, now, closedAfter(5));
+    CHECK_EQ(publisher.getStatistics().queueDepth, 5);
+
+    transport.brokerUp = true;
+    runFor(publisher, transport, now, MQTT_RECONNECT_MAX_MS + 5000);
+    CHECK(transport.messages.size() >= 5u);
+    // The backlog goes out back to back at the drain rate, not in one burst
+    CHECK_EQ(transport.publishTimes[4] - transport.publishTimes[0], 4 * MQTT_DRAIN_INTERVAL_MS);
+    for (size_t i = 1; i < transport.publishTimes.size(); i++) {
+        CHECK(transport.publishTimes[i] - transport.publishTimes[i - 1] >= MQTT_DRAIN_INTERVAL_MS);
+    }
+}
+
+TEST(mqttReconnectBacksOff) {
+    FakeMqttTransport transport;
+    transport.brokerUp = false;
+    MqttPublisher publisher(transport);
+    unsigned long now = 0;
+    runFor(publisher, transport, now, 10 * MQTT_RECONNECT_MAX_MS);
+
+    const std::vector<unsigned long>& times = transport.attemptTimes;
+    CHECK(times.size() >= 5);
+    CHECK_EQ(times[0], MQTT_RECONNECT_MIN_MS);
+    for (size_t i = 1; i < times.size(); i++) {
+        unsigned long gap = times[i] - times[i - 1];
+        unsigned long expected = MQTT_RECONNECT_MIN_MS << i;
+        CHECK_EQ(gap, expected < MQTT_RECONNECT_MAX_MS ? expected : MQTT_RECONNECT_MAX_MS);
+    }
+}
+
+TEST(mqttFailedPublishIsRetried) {
+    FakeMqttTransport transport;
+    MqttPublisher publisher(transport);
+    unsigned long now = 0;
+    transport.acceptPublish = false;
+    runFor(publisher, transport, now, MQTT_BATCH_INTERVAL_MS + 2000);
+    CHECK(publisher.getStatistics().failures > 0);
+    CHECK_EQ(publisher.getStatistics().queueDepth, 1);
+
+    transport.acceptPublish = true;
+    runFor(publisher, transport, now, 1000);
+    CHECK_EQ(transport.messages.size(), 1u);
+    CHECK_EQ(sequenceOf(transport.messages[0]), 0);
+    CHECK_EQ(publisher.getStatistics().published, 1u);
+}
+
+TEST(mqttRateMetric) {
+    FakeMqttTransport transport;
+    transport.brokerUp = false;
+    MqttPublisher publisher(transport);
+    unsigned long now = 0;
+    runFor(publisher, transport, now, closedAfter(MQTT_QUEUE_SLOTS));
+
+    // The queued batches drain within one rate window, once the broker is back
+    transport.brokerUp = true;
+    while (publisher.getStatistics().published == 0) {
+        runFor(publisher, transport, now, 100, 0);
+    }
+    runFor(publisher, transport, now, MQTT_RATE_WINDOW_MS, 0);
+    const MqttPublisherStats& stats = publisher.getStatistics();
+    CHECK_EQ(stats.published, static_cast<uint32_t>(MQTT_QUEUE_SLOTS));
+    CHECK(stats.messagesPerSecond > 0.0f);
+    CHECK(stats.messagesPerSecond <= 1000.0f / MQTT_DRAIN_INTERVAL_MS);
+
+    // An idle window reports zero, after the open batch has gone out
+    runFor(publisher, transport, now, MQTT_BATCH_INTERVAL_MS + 2 * MQTT_RATE_WINDOW_MS, 0);
+    CHECK_EQ(publisher.getStatistics().messagesPerSecond, 0.0f);
+}
+
+TEST(mqttRejectsRowsThatDoNotFit) {
+    FakeMqttTransport transport;
+    MqttPublisher publisher(transport);
+    HistorySample huge = makeSample(0, 3.0e38f);
+    huge.values[HISTORY_PRESSURE] = -3.0e38f;
+    huge.values[HISTORY_HUMIDITY] = 3.0e38f;
+    huge.values[HISTORY_TEMP_SCD] = 3.0e38f;
+    publisher.addSample(huge, 0);
+    CHECK_EQ(publisher.getStatistics().rejected, 1u);
+
+    HistorySample invalid = makeSample(2000, NAN);
+    invalid.values[HISTORY_PRESSURE] = INFINITY;
+    publisher.addSample(invalid, 2000);
+    unsigned long now = 2100;
+    runFor(publisher, transport, now, MQTT_BATCH_INTERVAL_MS);
+    CHECK(!transport.messages.empty());
+    CHECK_EQ(transport.messages[0].find("[2000,null,24.10,22.00,45.50,null]") != std::string::npos, true);
+    CHECK_EQ(publisher.getStatistics().rejected, 1u);
+}
@@ -0,0 +1,161 @@
+#include "HostTest.h"
+#include "PageManager.h"
+
+/**
+ * @file PageManagerTest.cpp
+ * @brief Rotation, holds, pinning and lazy rendering of the page manager.
+ */
+
+/**
+ * @class CountingPage
+ * @brief Page that only counts how often it is drawn.
+ */
+class CountingPage : public DisplayPage {
+public:
+    uint8_t inputs; ///< Input groups the page depends on
+    unsigned long refreshInterval; ///< Refresh interval in ms, or 0
+    unsigned backgrounds = 0; ///< Calls to `drawBackground()`
+    unsigned contents = 0; ///< Calls to `drawContent()`
+
+    explicit CountingPage(uint8_t inputs = INPUT_READINGS, unsigned long refreshInterval = 0)
+        : inputs(inputs), refreshInterval(refreshInterval) {}
+
+    uint8_t getInputs() const override { return inputs; }
+    unsigned long getRefreshInterval() const override { return refreshInterval; }
+    void drawBackground(DisplayManager&) override { backgrounds++; }
+    void drawContent(DisplayManager&, unsigned long) override { contents++; }
+};
+
+/**
+ * @struct PageFixture
+ * @brief Three rotation pages and an alert page outside the rotation.
+ */
+struct PageFixture {
+    static const uint8_t ALERT = 3; ///< Index of the alert page
+
+    DisplayManager displayManager;
+    CountingPage first;
+    CountingPage second{ INPUT_EXPOSURE };
+    CountingPage third{ INPUT_HEALTH };
+    CountingPage alert{ INPUT_ALERT, 500 };
+    DisplayPage* pages[4] = { &first, &second, &third, &alert };
+    PageManager manager{ displayManager, pages, 4, 3 };
+
+    /**
+     * @brief Updates the manager every 100 ms up to a time.
+     */
+    void runUntil(unsigned long& now, unsigned long end) {
+        for (; now < end; now += 100) {
+            manager.update(now);
+        }
+    }
+};
+
+TEST(pagesRotateEveryInterval) {
+    PageFixture fixture;
+    unsigned long now = 0;
+    fixture.manager.update(now);
+    CHECK_EQ(fixture.manager.getCurrentPage(), 0);
+    fixture.runUntil(now, DISPLAY_PAGE_INTERVAL_MS + 100);
+    CHECK_EQ(fixture.manager.getCurrentPage(), 1);
+    fixture.runUntil(now, 3 * DISPLAY_PAGE_INTERVAL_MS + 100);
+    // The alert page is not part of the rotation
+    CHECK_EQ(fixture.manager.getCurrentPage(), 0);
+    CHECK_EQ(fixture.manager.getStatistics().switches, 3u);
+}
+
+TEST(pagesRenderOnlyWhenNeeded) {
+    PageFixture fixture;
+    CHECK(fixture.manager.update(0));
+    CHECK(!fixture.manager.update(100));
+
+    // Inputs of hidden pages do not cause a render
+    fixture.manager.invalidate(INPUT_EXPOSURE | INPUT_HEALTH);
+    CHECK(!fixture.manager.update(200));
+    fixture.manager.invalidate(INPUT_READINGS);
+    CHECK(fixture.manager.update(300));
+    CHECK_EQ(fixture.first.contents, 2u);
+    CHECK_EQ(fixture.first.backgrounds, 1u);
+
+    // A page with a refresh interval renders when a multiple of it is crossed
+    fixture.manager.show(PageFixture::ALERT, 400, 0);
+    CHECK(fixture.manager.update(400));
+    CHECK(!fixture.manager.update(499));
+    CHECK(fixture.manager.update(500));
+    CHECK(!fixture.manager.update(900));
+    CHECK(fixture.manager.update(1000));
+    CHECK_EQ(fixture.alert.contents, 3u);
+}
+
+TEST(pagesCacheBackgrounds) {
+    PageFixture fixture;
+    unsigned long now = 0;
+    fixture.runUntil(now, 2 * DISPLAY_PAGE_INTERVAL_MS + 100);
+    CHECK_EQ(fixture.manager.getCurrentPage(), 2);
+    fixture.manager.next(now);
+    fixture.manager.update(now);
+
+    // Two slots: the first page was evicted by the third one
+    const PageManagerStats& stats = fixture.manager.getStatistics();
+    CHECK_EQ(fixture.first.backgrounds, 2u);
+    CHECK_EQ(fixture.second.backgrounds, 1u);
+    CHECK_EQ(stats.backgroundMisses, 4u);
+
+    // Re-rendering the visible page and switching to the other cached page hit the cache
+    fixture.manager.invalidate(INPUT_READINGS);
+    fixture.manager.update(now + 100);
+    fixture.manager.show(2, now + 200, 1000);
+    fixture.manager.update(now + 200);
+    CHECK_EQ(stats.backgroundMisses, 4u);
+    CHECK_EQ(stats.backgroundHits, 2u);
+    CHECK_EQ(stats.renders, 6u);
+}
+
+TEST(pagesButtonHoldsRotation) {
+    PageFixture fixture;
+    unsigned long now = 0;
+    fixture.runUntil(now, 1000);
+    fixture.manager.next(now);
+    CHECK_EQ(fixture.manager.getCurrentPage(), 1);
+    fixture.runUntil(now, 1000 + DISPLAY_PAGE_HOLD_MS);
+    CHECK_EQ(fixture.manager.getCurrentPage(), 1);
+    // After the hold the rotation continues from the selected page
+    fixture.runUntil(now, 1000 + DISPLAY_PAGE_HOLD_MS + 200);
+    CHECK_EQ(fixture.manager.getCurrentPage(), 2);
+}
+
+TEST(pagesAlertStaysPinned) {
+    PageFixture fixture;
+    unsigned long now = 0;
+    fixture.manager.update(now);
+    fixture.manager.show(PageFixture::ALERT, now, 0);
+    fixture.runUntil(now, 5 * DISPLAY_PAGE_INTERVAL_MS);
+    CHECK_EQ(fixture.manager.getCurrentPage(), PageFixture::ALERT);
+
+    // A button press during the alert shows the other pages for one interval only
+    fixture.manager.next(now);
+    CHECK_EQ(fixture.manager.getCurrentPage(), 0);
+    fixture.runUntil(now, now + 1000);
+    fixture.manager.next(now);
+    CHECK_EQ(fixture.manager.getCurrentPage(), 1);
+    unsigned long pressed = now;
+    fixture.runUntil(now, pressed + DISPLAY_PAGE_INTERVAL_MS);
+    CHECK_EQ(fixture.manager.getCurrentPage(), 1);
+    fixture.runUntil(now, pressed + DISPLAY_PAGE_INTERVAL_MS + 100);
+    CHECK_EQ(fixture.manager.getCurrentPage(), PageFixture::ALERT);
+    fixture.runUntil(now, now + 3 * DISPLAY_PAGE_HOLD_MS);
+    CHECK_EQ(fixture.manager.getCurrentPage(), PageFixture::ALERT);
+
+    // A timed page returns to the pinned page as well
+    fixture.manager.show(2, now, 3000);
+    fixture.runUntil(now, now + 3100);
+    CHECK_EQ(fixture.manager.getCurrentPage(), PageFixture::ALERT);
+
+    // Once released, the rotation resumes and button presses hold as usual
+    fixture.manager.release(0, now);
+    fixture.runUntil(now, now + DISPLAY_PAGE_INTERVAL_MS + 100);
+    CHECK_EQ(fixture.manager.getCurrentPage(), 1);
+    fixture.manager.next(now);
+    fixture.runUntil(now, now + DISPLAY_PAGE_HOLD_MS - 100);
+    CHECK_EQ(fixture.manager.getCurrentPage(), 2);
+}
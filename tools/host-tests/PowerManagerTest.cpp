@@ -0,0 +1,213 @@
+#include <string.h>
+#include "HostTest.h"
+#include "PowerManager.h"
+
+/**
+ * @file PowerManagerTest.cpp
+ * @brief Wake handling, schedule and record validation of the low-power duty cycle.
+ */
+
+/**
+ * @class FakeRtcStore
+ * @brief RTC user memory backed by a plain array, kept across `PowerManager` instances.
+ */
+class FakeRtcStore : public RtcStore {
+public:
+    uint32_t memory[RTC_STATE_MAX_BYTES / 4]; ///< Retained words
+    bool failReads = false; ///< Whether reads fail
+    bool failWrites = false; ///< Whether writes fail
+    unsigned reads = 0; ///< Calls to `read()`
+    unsigned writes = 0; ///< Successful calls to `write()`
+    size_t size = 0; ///< Size of the last record written in bytes
+
+    FakeRtcStore() {
+        // Power-on content of the RTC memory
+        memset(memory, 0xA5, sizeof(memory));
+    }
+
+    bool read(void* data, size_t size) override {
+        reads++;
+        if (failReads || size > sizeof(memory)) {
+            return false;
+        }
+        memcpy(data, memory, size);
+        return true;
+    }
+
+    bool write(const void* data, size_t size) override {
+        if (failWrites || size > sizeof(memory)) {
+            return false;
+        }
+        memcpy(memory, data, size);
+        this->size = size;
+        writes++;
+        return true;
+    }
+};
+
+/**
+ * @brief Computes the checksum `PowerManager` stores in the last word of a record.
+ */
+static uint32_t recordChecksum(const FakeRtcStore& store) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(store.memory);
+    uint32_t hash = 2166136261UL;
+    for (size_t i = 0; i < store.size - 4; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+TEST(powerColdBootStartsFresh) {
+    FakeRtcStore store;
+    PowerManager manager(store);
+    CHECK(!manager.begin(WAKE_COLD_BOOT));
+    CHECK_EQ(store.reads, 0u);
+    CHECK_EQ(manager.getWakeReason(), WAKE_COLD_BOOT);
+    CHECK_EQ(manager.getWakeCount(), 0u);
+    CHECK_EQ(manager.getTimeMs(1234), 1234u);
+    CHECK_EQ(manager.getState().samples, 0u);
+    CHECK_EQ(manager.getState().sensorsStarted, 0);
+    CHECK(manager.isSampleDue(0));
+    CHECK(!manager.isDisplayHeld(0));
+}
+
+TEST(powerTimerWakeRestoresState) {
+    FakeRtcStore store;
+    {
+        PowerManager manager(store);
+        manager.begin(WAKE_COLD_BOOT);
+        manager.getState().samples = 5;
+        manager.getState().moderateThreshold = 800.0f;
+        manager.sampleTaken(1500);
+        uint32_t sleepMs = manager.planSleep(2000);
+        CHECK_EQ(sleepMs, LOW_POWER_SAMPLE_INTERVAL_MS - 2000);
+        CHECK(manager.save(2000, sleepMs));
+    }
+
+    PowerManager manager(store);
+    CHECK(manager.begin(WAKE_TIMER));
+    CHECK_EQ(manager.getWakeReason(), WAKE_TIMER);
+    CHECK_EQ(manager.getWakeCount(), 1u);
+    CHECK_EQ(manager.getTimeMs(0), LOW_POWER_SAMPLE_INTERVAL_MS);
+    CHECK(manager.isSampleDue(0));
+    CHECK_EQ(manager.getState().samples, 5u);
+    CHECK_EQ(manager.getState().moderateThreshold, 800.0f);
+}
+
+TEST(powerTimerRunsEarlyWithinTolerance) {
+    FakeRtcStore store;
+    PowerManager manager(store);
+    manager.begin(WAKE_COLD_BOOT);
+    manager.sampleTaken(0);
+    // The RTC timer ran fast: the wake arrives before the sample is due
+    manager.save(0, LOW_POWER_SAMPLE_INTERVAL_MS - LOW_POWER_WAKE_TOLERANCE_MS);
+    CHECK(manager.begin(WAKE_TIMER));
+    CHECK(manager.isSampleDue(0));
+
+    manager.sampleTaken(100);
+    // The schedule keeps its phase instead of restarting from the early wake
+    CHECK_EQ(manager.planSleep(100), LOW_POWER_WAKE_TOLERANCE_MS - 100 + LOW_POWER_SAMPLE_INTERVAL_MS);
+}
+
+TEST(powerButtonWakeHoldsDisplay) {
+    FakeRtcStore store;
+    PowerManager manager(store);
+    manager.begin(WAKE_COLD_BOOT);
+    manager.sampleTaken(0);
+    manager.save(0, manager.planSleep(0));
+
+    CHECK(manager.begin(WAKE_BUTTON));
+    CHECK_EQ(manager.getWakeReason(), WAKE_BUTTON);
+    manager.holdDisplay(500, LOW_POWER_BUTTON_DISPLAY_MS);
+    CHECK(manager.isSampleDue(1000));
+    manager.sampleTaken(1000);
+    CHECK(manager.isDisplayHeld(1000));
+    CHECK(!manager.isDisplayHeld(500 + LOW_POWER_BUTTON_DISPLAY_MS));
+
+    // The display timeout comes before the next sample, so the device wakes for it
+    uint32_t sleepMs = manager.planSleep(1000);
+    CHECK_EQ(sleepMs, LOW_POWER_BUTTON_DISPLAY_MS - 500);
+    manager.save(1000, sleepMs);
+
+    CHECK(manager.begin(WAKE_TIMER));
+    CHECK_EQ(manager.getWakeCount(), 2u);
+    CHECK(!manager.isDisplayHeld(0));
+    CHECK(!manager.isSampleDue(0));
+    // The next sample keeps its phase after the extra wake
+    CHECK_EQ(manager.getTimeMs(200) + manager.planSleep(200), 2 * LOW_POWER_SAMPLE_INTERVAL_MS);
+}
+
+TEST(powerRetriesMissedSamples) {
+    FakeRtcStore store;
+    PowerManager manager(store);
+    manager.begin(WAKE_COLD_BOOT);
+    // The SCD30 had no data in time: the sample stays due and is retried soon
+    CHECK(manager.isSampleDue(3500));
+    CHECK_EQ(manager.planSleep(3500), LOW_POWER_RETRY_MS);
+    manager.save(3500, LOW_POWER_RETRY_MS);
+
+    CHECK(manager.begin(WAKE_TIMER));
+    CHECK(manager.isSampleDue(0));
+    manager.sampleTaken(1000);
+    CHECK_EQ(manager.getTimeMs(1000) + manager.planSleep(1000), LOW_POWER_SAMPLE_INTERVAL_MS);
+
+    // After several missed intervals the schedule restarts from the sample
+    manager.save(1000, 5 * LOW_POWER_SAMPLE_INTERVAL_MS);
+    CHECK(manager.begin(WAKE_TIMER));
+    manager.sampleTaken(0);
+    CHECK_EQ(manager.planSleep(0), LOW_POWER_SAMPLE_INTERVAL_MS);
+}
+
+TEST(powerRetryAfterFailedSensorStart) {
+    FakeRtcStore store;
+    PowerManager manager(store);
+    manager.begin(WAKE_COLD_BOOT);
+    // The firmware saves without marking the sensors started before the retry sleep
+    CHECK(manager.save(300, LOW_POWER_RETRY_MS));
+
+    CHECK(manager.begin(WAKE_TIMER));
+    CHECK_EQ(manager.getState().sensorsStarted, 0);
+    CHECK_EQ(manager.getWakeCount(), 1u);
+    CHECK_EQ(manager.getTimeMs(0), 300 + LOW_POWER_RETRY_MS);
+    CHECK(manager.isSampleDue(0));
+}
+
+TEST(powerRejectsInvalidRecords) {
+    FakeRtcStore store;
+    // Power-on garbage
+    PowerManager manager(store);
+    CHECK(!manager.begin(WAKE_TIMER));
+    CHECK_EQ(manager.getWakeReason(), WAKE_COLD_BOOT);
+
+    // A flipped bit in the retained state
+    manager.getState().samples = 9;
+    manager.save(0, 1000);
+    const size_t size = store.size;
+    CHECK(size > 8 && size <= RTC_STATE_MAX_BYTES);
+    reinterpret_cast<uint8_t*>(store.memory)[size / 2] ^= 0x10;
+    CHECK(!manager.begin(WAKE_BUTTON));
+    CHECK_EQ(manager.getState().samples, 0u);
+
+    // A record of another layout version, with a valid checksum
+    manager.save(0, 1000);
+    CHECK_EQ(recordChecksum(store), store.memory[size / 4 - 1]);
+    store.memory[0] ^= 0xFF;
+    store.memory[size / 4 - 1] = recordChecksum(store);
+    CHECK(!manager.begin(WAKE_TIMER));
+
+    // Unreadable memory
+    manager.save(0, 1000);
+    store.failReads = true;
+    CHECK(!manager.begin(WAKE_TIMER));
+    CHECK_EQ(manager.getWakeCount(), 0u);
+}
+
+TEST(powerReportsFailedWrites) {
+    FakeRtcStore store;
+    PowerManager manager(store);
+    manager.begin(WAKE_COLD_BOOT);
+    store.failWrites = true;
+    CHECK(!manager.save(0, 1000));
+    CHECK(!manager.begin(WAKE_TIMER));
+}
@@ -0,0 +1,142 @@
+#include <vector>
+#include "HostTest.h"
+#include "PressureCompensator.h"
+
+/**
+ * @file PressureCompensatorTest.cpp
+ * @brief Deadband, rate limit and write statistics of the pressure compensation.
+ */
+
+/**
+ * @class FakeScd30
+ * @brief Records the ambient pressure commands instead of sending them over I2C.
+ */
+class FakeScd30 : public AmbientPressureSink {
+public:
+    std::vector<uint16_t> commands; ///< Accepted commands in mbar, in order
+    bool accept = true; ///< Whether the next commands are acknowledged
+
+    bool setAmbientPressure(uint16_t pressureMbar) override {
+        if (!accept) {
+            return false;
+        }
+        commands.push_back(pressureMbar);
+        return true;
+    }
+};
+
+TEST(pressureFirstReadingIsWritten) {
+    FakeScd30 sensor;
+    PressureCompensator compensator(sensor, 2.0f, 600000UL);
+    CHECK(compensator.update(1013.4f, 1000));
+    CHECK_EQ(sensor.commands.size(), 1u);
+    CHECK_EQ(sensor.commands[0], 1013);
+    CHECK_EQ(compensator.getStatistics().writes, 1u);
+}
+
+TEST(pressureDeadbandSuppressesSmallChanges) {
+    FakeScd30 sensor;
+    PressureCompensator compensator(sensor, 2.0f, 1000UL);
+    compensator.update(1000.0f, 0);
+
+    // Long after the rate limit, but within the deadband
+    CHECK(!compensator.update(1001.9f, 10000));
+    CHECK(!compensator.update(998.1f, 20000));
+    CHECK_EQ(compensator.getStatistics().skippedDeadband, 2u);
+    CHECK_EQ(sensor.commands.size(), 1u);
+
+    CHECK(compensator.update(1002.0f, 30000));
+    CHECK_EQ(sensor.commands.back(), 1002);
+    // The deadband is measured from the last written value, not the last reading
+    CHECK(!compensator.update(1000.5f, 40000));
+    CHECK(compensator.update(999.9f, 50000));
+    CHECK_EQ(sensor.commands.back(), 1000);
+}
+
+TEST(pressureRateLimitDelaysWrites) {
+    FakeScd30 sensor;
+    PressureCompensator compensator(sensor, 2.0f, 600000UL);
+    compensator.update(1000.0f, 0);
+
+    CHECK(!compensator.update(1005.0f, 1000));
+    CHECK(!compensator.update(1005.0f, 599999));
+    CHECK_EQ(compensator.getStatistics().skippedRateLimit, 2u);
+    CHECK_EQ(sensor.commands.size(), 1u);
+
+    // The pending change goes out with the first reading after the interval
+    CHECK(compensator.update(1005.0f, 600000));
+    CHECK_EQ(sensor.commands.size(), 2u);
+    CHECK_EQ(sensor.commands.back(), 1005);
+}
+
+TEST(pressureRateLimitAcrossMillisWrap) {
+    FakeScd30 sensor;
+    PressureCompensator compensator(sensor, 2.0f, 600000UL);
+    unsigned long start = 0xFFFFFFFFUL - 1000;
+    compensator.update(1000.0f, start);
+    CHECK(!compensator.update(1010.0f, start + 300000));
+    CHECK(compensator.update(1010.0f, start + 600000));
+}
+
+TEST(pressureRejectsOutOfRangeReadings) {
+    FakeScd30 sensor;
+    PressureCompensator compensator(sensor);
+    CHECK(!compensator.update(650.0f, 0));
+    CHECK(!compensator.update(1500.0f, 0));
+    CHECK(!compensator.update(NAN, 0));
+    CHECK_EQ(compensator.getStatistics().rejected, 3u);
+    CHECK(sensor.commands.empty());
+}
+
+TEST(pressureFailedWriteIsRetried) {
+    FakeScd30 sensor;
+    PressureCompensator compensator(sensor, 2.0f, 600000UL);
+    sensor.accept = false;
+    CHECK(!compensator.update(1013.0f, 0));
+    CHECK_EQ(compensator.getStatistics().failures, 1u);
+
+    // A failed write does not start the rate limit
+    sensor.accept = true;
+    CHECK(compensator.update(1013.0f, 2000));
+    CHECK_EQ(sensor.commands.size(), 1u);
+}
+
+TEST(pressureStateSurvivesRestart) {
+    FakeScd30 sensor;
+    PressureCompensator compensator(sensor, 2.0f, 600000UL);
+    compensator.update(1013.0f, 5000);
+    compensator.update(1013.5f, 7000);
+    PressureCompensatorState state;
+    compensator.getState(state);
+
+    FakeScd30 restartedSensor;
+    PressureCompensator restarted(restartedSensor, 2.0f, 600000UL);
+    restarted.setState(state);
+    CHECK(!restarted.update(1013.2f, 9000));
+    CHECK(restartedSensor.commands.empty());
+    CHECK_EQ(restarted.getStatistics().writes, 1u);
+    CHECK_EQ(restarted.getStatistics().skippedDeadband, 2u);
+}
+
+TEST(pressureDayTraceAvoidsWrites) {
+    FakeScd30 sensor;
+    PressureCompensator compensator(sensor);
+    uint32_t seed = 17;
+    const unsigned long intervalMs = 2000;
+    const unsigned long samples = 24UL * 3600 * 1000 / intervalMs;
+
+    // A weather front: 12 hPa over the day with 0.3 hPa of sensor noise
+    for (unsigned long i = 0; i < samples; i++) {
+        double pressure = 1010.0 - 12.0 * i / samples + 0.3 * hosttest::gaussian(seed);
+        compensator.update(static_cast<float>(pressure), i * intervalMs);
+    }
+
+    const PressureCompensationStats& stats = compensator.getStatistics();
+    CHECK_EQ(stats.writes, sensor.commands.size());
+    CHECK(stats.writes >= 6 && stats.writes <= 8);
+    CHECK_EQ(stats.writes + stats.skippedDeadband + stats.skippedRateLimit + stats.failures + stats.rejected,
+             samples);
+    for (size_t i = 1; i < sensor.commands.size(); i++) {
+        CHECK(abs(sensor.commands[i] - sensor.commands[i - 1]) >= 2);
+    }
+}
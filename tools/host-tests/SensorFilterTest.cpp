@@ -0,0 +1,155 @@
+#include <chrono>
+#include <stdio.h>
+#include "HostTest.h"
+#include "SensorFilter.h"
+
+/**
+ * @file SensorFilterTest.cpp
+ * @brief Accuracy of the fixed-point filters on synthetic traces, and their cost per sample.
+ */
+
+/**
+ * @brief Root mean square error of the raw and filtered CO2 on a trace.
+ */
+struct Co2Error {
+    double raw; ///< Error of the unfiltered readings in ppm
+    double filtered; ///< Error of the filter output in ppm
+};
+
+/**
+ * @brief Feeds a constant concentration with the configured noise model and measures the errors.
+ */
+static Co2Error runConstantTrace(double trueCO2, int samples, uint32_t seed) {
+    SensorFilter filter;
+    double sigma = FILTER_CO2_NOISE_PPM + FILTER_CO2_NOISE_RELATIVE * trueCO2;
+    double rawSquares = 0;
+    double filteredSquares = 0;
+    for (int i = 0; i < samples; i++) {
+        double raw = trueCO2 + sigma * hosttest::gaussian(seed);
+        filter.update(static_cast<float>(raw), 25.0f, 22.0f);
+        // Skip the settling of the first samples
+        if (i >= 20) {
+            rawSquares += (raw - trueCO2) * (raw - trueCO2);
+            filteredSquares += (filter.getCO2() - trueCO2) * (filter.getCO2() - trueCO2);
+        }
+    }
+    int counted = samples - 20;
+    return { sqrt(rawSquares / counted), sqrt(filteredSquares / counted) };
+}
+
+TEST(filterFirstSampleInitializes) {
+    SensorFilter filter;
+    filter.update(812.0f, 25.5f, 22.5f);
+    CHECK_NEAR(filter.getCO2(), 812.0, 0.01);
+    CHECK_NEAR(filter.getTemperature(), 22.5, 0.01);
+    CHECK_NEAR(filter.getSelfHeatingBias(), 3.0, 0.01);
+}
+
+TEST(filterReducesCO2Noise) {
+    const double levels[] = { 450, 1000, 2500 };
+    for (double level : levels) {
+        Co2Error error = runConstantTrace(level, 2000, 7);
+        CHECK(error.filtered < error.raw / 2);
+    }
+}
+
+TEST(filterFollowsCO2Step) {
+    SensorFilter filter;
+    uint32_t seed = 3;
+    for (int i = 0; i < 200; i++) {
+        filter.update(static_cast<float>(600 + 5 * hosttest::gaussian(seed)), 25.0f, 22.0f);
+    }
+    CHECK_NEAR(filter.getCO2(), 600.0, 10.0);
+
+    // A window closes in a crowded room: 90 % of the step must show on the first sample
+    filter.update(1500.0f, 25.0f, 22.0f);
+    CHECK(filter.getCO2() > 600 + 0.9 * 900);
+    for (int i = 0; i < 4; i++) {
+        filter.update(1500.0f, 25.0f, 22.0f);
+    }
+    CHECK_NEAR(filter.getCO2(), 1500.0, 15.0);
+}
+
+TEST(filterLearnsSelfHeatingBias) {
+    SensorFilter filter;
+    uint32_t seed = 11;
+    double squares = 0;
+    int counted = 0;
+    for (int i = 0; i < 3000; i++) {
+        // Slow drift of the room temperature, the SCD30 reading 2.5 °C high
+        double trueTemperature = 21.0 + 1.5 * sin(i / 500.0);
+        double bmp = trueTemperature + FILTER_TEMP_NOISE_BMP * hosttest::gaussian(seed);
+        double scd = trueTemperature + 2.5 + FILTER_TEMP_NOISE_SCD * hosttest::gaussian(seed);
+        filter.update(800.0f, static_cast<float>(scd), static_cast<float>(bmp));
+        if (i >= 2000) {
+            double error = filter.getTemperature() - trueTemperature;
+            squares += error * error;
+            counted++;
+        }
+    }
+    CHECK_NEAR(filter.getSelfHeatingBias(), 2.5, 0.1);
+    CHECK(sqrt(squares / counted) < FILTER_TEMP_NOISE_BMP);
+    CHECK_NEAR(filter.compensateTemperatureSCD(24.0f), 24.0 - filter.getSelfHeatingBias(), 0.001);
+}
+
+TEST(filterClampsOutOfRangeReadings) {
+    SensorFilter filter;
+    filter.update(40000.0f, 25.0f, 22.0f);
+    CHECK_NEAR(filter.getCO2(), FILTER_CO2_MAX_PPM, 1.0);
+    for (int i = 0; i < 10; i++) {
+        filter.update(40000.0f, 200.0f, -100.0f);
+    }
+    CHECK_NEAR(filter.getCO2(), FILTER_CO2_MAX_PPM, 1.0);
+    CHECK(filter.getTemperature() >= FILTER_TEMP_MIN - 0.01);
+
+    SensorFilter other;
+    other.update(NAN, NAN, NAN);
+    CHECK(isfinite(other.getCO2()));
+    CHECK(other.getCO2() >= 0);
+    other.update(-50.0f, 22.0f, 22.0f);
+    CHECK(other.getCO2() >= 0);
+}
+
+TEST(filterStateRoundTrip) {
+    SensorFilter original;
+    uint32_t seed = 5;
+    for (int i = 0; i < 100; i++) {
+        original.update(static_cast<float>(900 + 15 * hosttest::gaussian(seed)), 25.0f, 22.0f);
+    }
+    SensorFilterState state;
+    original.getState(state);
+    SensorFilter restored;
+    restored.setState(state);
+
+    for (int i = 0; i < 10; i++) {
+        float co2 = static_cast<float>(900 + 15 * hosttest::gaussian(seed));
+        original.update(co2, 25.0f, 22.0f);
+        restored.update(co2, 25.0f, 22.0f);
+    }
+    CHECK_EQ(restored.getCO2(), original.getCO2());
+    CHECK_EQ(restored.getTemperature(), original.getTemperature());
+
+    restored.reset();
+    restored.update(500.0f, 25.0f, 22.0f);
+    CHECK_NEAR(restored.getCO2(), 500.0, 0.01);
+}
+
+BENCH(filterUpdate) {
+    const int samples = 2000000;
+    SensorFilter filter;
+    uint32_t seed = 1;
+    float co2[1024];
+    for (float& value : co2) {
+        value = static_cast<float>(800 + 20 * hosttest::gaussian(seed));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < samples; i++) {
+        filter.update(co2[i & 1023], 25.0f, 22.0f);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    Co2Error error = runConstantTrace(1000, 10000, 1);
+    printf("SensorFilter::update  %8.1f ns/sample  (CO2 RMS error at 1000 ppm: raw %.1f, filtered %.1f ppm)\n",
+           seconds * 1e9 / samples, error.raw, error.filtered);
+    CHECK(filter.getCO2() > 0);
+}
@@ -0,0 +1,171 @@
+#include "HostTest.h"
+#include "SensorGroup.h"
+
+/**
+ * @file SensorGroupTest.cpp
+ * @brief Rooms that are missing at boot or drop off the multiplexer, and their restart.
+ */
+
+/**
+ * @class PlugMux
+ * @brief Multiplexer that acknowledges every channel except an unplugged one.
+ */
+class PlugMux : public MuxBus {
+public:
+    int unplugged = -1; ///< Channel that does not answer, or -1
+
+    bool selectChannel(uint8_t channel) override { return channel != unplugged; }
+};
+
+/**
+ * @class PlugRoom
+ * @brief Room sensors that answer only while plugged in and count their initializations.
+ */
+class PlugRoom : public RoomSensor {
+public:
+    bool plugged = true; ///< Whether the sensors answer
+    bool ready = false; ///< Whether a measurement waits to be read
+    unsigned inits = 0; ///< Calls to `initializeSensors()`
+
+    bool initializeSensors(bool) override {
+        inits++;
+        return plugged;
+    }
+
+    bool setMeasurementInterval(uint16_t) override { return plugged; }
+
+    bool isDataAvailable() override { return plugged && ready; }
+
+    void readSample(float values[HISTORY_CHANNEL_COUNT]) override {
+        for (int i = 0; i < HISTORY_CHANNEL_COUNT; i++) {
+            values[i] = 800.0f;
+        }
+        ready = false;
+    }
+};
+
+/**
+ * @struct GroupFixture
+ * @brief Three rooms on channels 0 to 2, polled every 100 ms like the main loop.
+ */
+struct GroupFixture {
+    PlugMux mux;
+    PlugRoom rooms[3];
+    SensorGroup group{ mux, SCD30_INTERVAL_MS };
+    unsigned long now = 0; ///< Time of the next poll in ms
+    uint8_t onlineChanges = 0; ///< Rooms that went offline or came back since the last check
+
+    GroupFixture() {
+        for (uint8_t i = 0; i < 3; i++) {
+            group.addRoom(rooms[i], i);
+        }
+    }
+
+    /**
+     * @brief Polls up to, but not including, a time; every sensor measures every interval.
+     */
+    void runUntil(unsigned long end) {
+        for (; now < end; now += 100) {
+            if (now % SCD30_INTERVAL_MS == 0) {
+                for (PlugRoom& room : rooms) {
+                    room.ready = true;
+                }
+            }
+            group.poll(now);
+            onlineChanges |= group.getOnlineChanges();
+        }
+    }
+
+    /**
+     * @brief Retrieves and clears the rooms that went offline or came back.
+     */
+    uint8_t takeOnlineChanges() {
+        uint8_t changes = onlineChanges;
+        onlineChanges = 0;
+        return changes;
+    }
+};
+
+TEST(groupRestartsRoomMissingAtBoot) {
+    GroupFixture fixture;
+    fixture.rooms[2].plugged = false;
+    CHECK_EQ(fixture.group.begin(0), 2);
+    CHECK_EQ(fixture.rooms[2].inits, 1u);
+
+    // No attempt before the restart period, then one attempt per period
+    fixture.runUntil(SENSOR_GROUP_RESTART_MS);
+    CHECK_EQ(fixture.rooms[2].inits, 1u);
+    fixture.runUntil(SENSOR_GROUP_RESTART_MS + 100);
+    CHECK_EQ(fixture.rooms[2].inits, 2u);
+    CHECK_EQ(fixture.group.getStatistics().restarts, 1u);
+    CHECK(!fixture.group.getRoom(2).online);
+    CHECK_EQ(fixture.takeOnlineChanges(), 0);
+
+    fixture.rooms[2].plugged = true;
+    fixture.runUntil(2 * SENSOR_GROUP_RESTART_MS);
+    CHECK_EQ(fixture.rooms[2].inits, 2u);
+    fixture.runUntil(2 * SENSOR_GROUP_RESTART_MS + 100);
+    CHECK_EQ(fixture.rooms[2].inits, 3u);
+    CHECK(fixture.group.getRoom(2).online);
+    CHECK_EQ(fixture.takeOnlineChanges(), 1 << 2);
+
+    // The room delivers samples again, and the other rooms never noticed
+    fixture.runUntil(2 * SENSOR_GROUP_RESTART_MS + 10000);
+    CHECK(fixture.group.getRoom(2).samples >= 4);
+    CHECK_EQ(fixture.group.getRoom(0).samples, fixture.group.getRoom(1).samples);
+    CHECK(fixture.group.getRoom(0).samples >= 34);
+    CHECK_EQ(fixture.takeOnlineChanges(), 0);
+    CHECK_EQ(fixture.rooms[0].inits, 1u);
+}
+
+TEST(groupRestartsRoomThatDroppedOff) {
+    GroupFixture fixture;
+    CHECK_EQ(fixture.group.begin(0), 3);
+    fixture.runUntil(10000);
+    CHECK(fixture.group.getRoom(1).samples > 0);
+
+    // A silent room stays online for SENSOR_GROUP_OFFLINE_MS after its last sample
+    fixture.mux.unplugged = 1;
+    unsigned long lost = fixture.group.getRoom(1).lastSampleMs;
+    fixture.runUntil(lost + SENSOR_GROUP_OFFLINE_MS);
+    CHECK(fixture.group.getRoom(1).online);
+    fixture.runUntil(lost + SENSOR_GROUP_OFFLINE_MS + 100);
+    CHECK(!fixture.group.getRoom(1).online);
+    CHECK(fixture.group.getRoom(0).online);
+    CHECK(fixture.group.getRoom(2).online);
+    CHECK_EQ(fixture.takeOnlineChanges(), 1 << 1);
+
+    // Attempts fail while the channel is gone
+    unsigned long offline = lost + SENSOR_GROUP_OFFLINE_MS;
+    fixture.runUntil(offline + SENSOR_GROUP_RESTART_MS + 100);
+    CHECK_EQ(fixture.group.getStatistics().restarts, 1u);
+    CHECK(!fixture.group.getRoom(1).online);
+    CHECK_EQ(fixture.takeOnlineChanges(), 0);
+
+    fixture.mux.unplugged = -1;
+    fixture.runUntil(offline + 2 * SENSOR_GROUP_RESTART_MS + 100);
+    CHECK_EQ(fixture.group.getStatistics().restarts, 2u);
+    CHECK(fixture.group.getRoom(1).online);
+    CHECK_EQ(fixture.rooms[1].inits, 2u);
+    CHECK_EQ(fixture.takeOnlineChanges(), 1 << 1);
+
+    uint32_t samples = fixture.group.getRoom(1).samples;
+    fixture.runUntil(fixture.now + 10000);
+    CHECK(fixture.group.getRoom(1).samples >= samples + 4);
+    CHECK(fixture.group.getRoom(1).online);
+}
+
+TEST(groupRestartsOneRoomPerPoll) {
+    GroupFixture fixture;
+    fixture.rooms[0].plugged = false;
+    fixture.rooms[1].plugged = false;
+    CHECK_EQ(fixture.group.begin(0), 1);
+
+    fixture.runUntil(SENSOR_GROUP_RESTART_MS + 100);
+    CHECK_EQ(fixture.rooms[0].inits, 2u);
+    CHECK_EQ(fixture.rooms[1].inits, 1u);
+    fixture.runUntil(SENSOR_GROUP_RESTART_MS + 200);
+    CHECK_EQ(fixture.rooms[1].inits, 2u);
+    CHECK_EQ(fixture.group.getStatistics().restarts, 2u);
+    CHECK_EQ(fixture.rooms[2].inits, 1u);
+}
\ No newline at end of file
@@ -0,0 +1,283 @@
+#include <memory>
+#include <string>
+#include <EEPROM.h>
+#include "HostTest.h"
+#include "Logger.h"
+#include "MeterPages.h"
+#include "ReplayHardware.h"
+#include "SerialConsole.h"
+
+/**
+ * @file SerialConsoleTest.cpp
+ * @brief Drives the serial console with scripted input and checks its answers.
+ */
+
+/**
+ * @class ScriptedStream
+ * @brief Stream that plays back a script and collects everything written to it.
+ */
+class ScriptedStream : public Stream {
+public:
+    std::string input; ///< Bytes not read yet
+    std::string output; ///< Everything written so far
+
+    int available() override { return static_cast<int>(input.size()); }
+
+    int read() override {
+        if (input.empty()) {
+            return -1;
+        }
+        int c = static_cast<unsigned char>(input[0]);
+        input.erase(0, 1);
+        return c;
+    }
+
+    size_t write(const char* text) override {
+        output += text;
+        return strlen(text);
+    }
+
+    /**
+     * @brief Retrieves and clears the output.
+     */
+    std::string take() {
+        std::string text;
+        text.swap(output);
+        return text;
+    }
+};
+
+/**
+ * @class OfflineTransport
+ * @brief MQTT transport that never connects.
+ */
+class OfflineTransport : public MqttTransport {
+public:
+    bool connect() override { return false; }
+    bool isConnected() override { return false; }
+    bool publish(const char*, const char*, size_t) override { return false; }
+    void loop() override {}
+};
+
+/**
+ * @struct ConsoleFixture
+ * @brief The console wired to the same objects as on the device.
+ */
+struct ConsoleFixture {
+    ScriptedStream stream;
+    DisplayManager displayManager;
+    SensorManager sensorManager;
+    PressureCompensator pressureCompensator{ sensorManager };
+    SensorFilter sensorFilter;
+    VentilationEstimator ventilationEstimator;
+    ExposureAccumulator exposureAccumulator;
+    AlertMonitor alertMonitor;
+    HistoryArchive historyArchive;
+    OfflineTransport transport;
+    MqttPublisher mqttPublisher{ transport };
+    TraceRecorder traceRecorder;
+    DisplayModel displayModel = {};
+    MeterPages meterPages{ displayModel, displayManager };
+    PageManager pageManager{ displayManager, meterPages.getPages(), PAGE_COUNT, PAGE_ROTATION_COUNT };
+    MeasurementPipeline pipeline{ sensorManager, sensorFilter, pressureCompensator, exposureAccumulator,
+                                  ventilationEstimator, alertMonitor, pageManager, displayModel, traceRecorder };
+    SerialConsole console{ stream, sensorManager, displayManager, alertMonitor, exposureAccumulator,
+                           pressureCompensator, ventilationEstimator, historyArchive, mqttPublisher,
+                           traceRecorder, pipeline, pageManager };
+
+    /**
+     * @brief Feeds a script and polls often enough to consume it and finish any dump.
+     *
+     * @return Everything the console printed.
+     */
+    std::string run(const char* script, int maxPolls = 100) {
+        stream.input += script;
+        for (int i = 0; i < maxPolls; i++) {
+            console.poll();
+        }
+        return stream.take();
+    }
+};
+
+/**
+ * @brief Creates a fixture on the heap, with the emulated hardware reset.
+ */
+static std::unique_ptr<ConsoleFixture> makeFixture() {
+    replay::reset();
+    EEPROM.begin(EEPROM_SIZE);
+    std::unique_ptr<ConsoleFixture> fixture(new ConsoleFixture());
+    fixture->exposureAccumulator.begin();
+    return fixture;
+}
+
+/**
+ * @brief Counts the lines of a console output.
+ */
+static size_t countLines(const std::string& text) {
+    size_t lines = 0;
+    for (char c : text) {
+        lines += c == '\n';
+    }
+    return lines;
+}
+
+TEST(consoleHelpListsCommands) {
+    auto fixture = makeFixture();
+    std::string output = fixture->run("help\n");
+    CHECK_EQ(countLines(output), 9u);
+    CHECK(output.find("  dump history|compressed|trace\n") != std::string::npos);
+}
+
+TEST(consoleLogLevel) {
+    auto fixture = makeFixture();
+    CHECK_EQ(fixture->run("loglevel\n"), "loglevel 0\n");
+    CHECK_EQ(fixture->run("loglevel 2\n"), "ok\n");
+    CHECK_EQ(Logger::getLogLevel(), LOG_WARNING);
+    CHECK_EQ(fixture->run("loglevel 9\n"), "error: usage loglevel [0-4]\n");
+    CHECK_EQ(fixture->run("loglevel x\n"), "error: usage loglevel [0-4]\n");
+    Logger::setLogLevel(LOG_NONE);
+}
+
+TEST(consoleThresholds) {
+    auto fixture = makeFixture();
+    CHECK_EQ(fixture->run("threshold moderate 900\n"), "ok\n");
+    CHECK_EQ(fixture->alertMonitor.getModerateThreshold(), 900.0f);
+    CHECK_EQ(fixture->exposureAccumulator.getThreshold(EXPOSURE_MODERATE), 900.0f);
+    CHECK_EQ(fixture->run("threshold\n"), "threshold moderate 900 critical 2000 ppm\n");
+    CHECK_EQ(fixture->run("threshold critical 800\n"), "error: thresholds must satisfy 0 < moderate < critical\n");
+    CHECK_EQ(fixture->run("threshold warm 800\n"), "error: usage threshold [moderate|critical <ppm>]\n");
+    CHECK_EQ(fixture->alertMonitor.getCriticalThreshold(), 2000.0f);
+    CHECK_EQ(fixture->exposureAccumulator.getThreshold(EXPOSURE_CRITICAL), 2000.0f);
+}
+
+TEST(consoleBlinkInterval) {
+    auto fixture = makeFixture();
+    CHECK_EQ(fixture->run("interval 250\n"), "ok\n");
+    CHECK_EQ(fixture->displayManager.getBlinkInterval(), 250ul);
+    CHECK_EQ(fixture->run("interval -5\n"), "error: usage interval [<ms>]\n");
+}
+
+TEST(consoleCalibrateReportsFailure) {
+    auto fixture = makeFixture();
+    CHECK_EQ(fixture->run("calibrate\n"), "ok\n");
+    replay::setCommandsAccepted(false);
+    CHECK_EQ(fixture->run("calibrate\n"), "error: calibration failed\n");
+    replay::setCommandsAccepted(true);
+}
+
+TEST(consoleDumpHistoryIgnoresLogLevel) {
+    auto fixture = makeFixture();
+    Logger::setLogLevel(LOG_NONE);
+    std::string output = fixture->run("dump history\n");
+    CHECK_EQ(countLines(output), static_cast<size_t>(EXPOSURE_HOUR_COUNT + EXPOSURE_DAY_COUNT));
+    CHECK_EQ(output.compare(0, 9, "hour -0: "), 0);
+    CHECK(output.find("\nday -6: moderate 0.00 ppm*h / 0.0 min, critical 0.00 ppm*h / 0.0 min\n") !=
+          std::string::npos);
+}
+
+TEST(consoleDumpEmitsOneLinePerPoll) {
+    auto fixture = makeFixture();
+    fixture->stream.input = "dump history\n";
+    fixture->console.poll();
+    CHECK(fixture->stream.take().empty());
+    for (int i = 0; i < 3; i++) {
+        fixture->console.poll();
+        CHECK_EQ(countLines(fixture->stream.take()), 1u);
+    }
+}
+
+TEST(consolePollIsBounded) {
+    auto fixture = makeFixture();
+    // Two commands in one burst: only the first runs in the first poll
+    fixture->stream.input = "interval\ninterval\n";
+    fixture->console.poll();
+    CHECK_EQ(countLines(fixture->stream.take()), 1u);
+    CHECK_EQ(fixture->stream.input, "interval\n");
+    fixture->console.poll();
+    CHECK_EQ(countLines(fixture->stream.take()), 1u);
+
+    // Without a line end, a poll consumes at most CONSOLE_MAX_BYTES_PER_POLL bytes
+    fixture->stream.input = std::string(100, ' ');
+    fixture->console.poll();
+    CHECK_EQ(fixture->stream.input.size(), static_cast<size_t>(100 - CONSOLE_MAX_BYTES_PER_POLL));
+}
+
+TEST(consoleLineEditingAndErrors) {
+    auto fixture = makeFixture();
+    CHECK_EQ(fixture->run("intervax\bl 300\r\n"), "ok\n");
+    CHECK_EQ(fixture->displayManager.getBlinkInterval(), 300ul);
+    CHECK_EQ(fixture->run("reboot\n"), "error: unknown command 'reboot', try 'help'\n");
+    CHECK_EQ(fixture->run("threshold a b c d\n"), "error: too many arguments\n");
+    CHECK_EQ(fixture->run("\n\n"), "");
+
+    std::string longLine(CONSOLE_BUFFER_SIZE + 10, 'x');
+    CHECK_EQ(fixture->run((longLine + "\n").c_str()), "error: line too long\n");
+    // The console recovers after the long line
+    CHECK_EQ(fixture->run("interval\n"), "interval 300 ms\n");
+}
+
+TEST(consoleStats) {
+    auto fixture = makeFixture();
+    std::string output = fixture->run("stats\n");
+    CHECK_EQ(countLines(output), static_cast<size_t>(14 + STAGE_COUNT));
+    CHECK(output.find("pressure compensation: 0 writes") != std::string::npos);
+    CHECK(output.find("display: page 0") != std::string::npos);
+    CHECK(output.find("...") == std::string::npos);
+}
+
+TEST(consoleMarksTruncatedResponses) {
+    auto fixture = makeFixture();
+    // The echoed command makes the error longer than a response line
+    std::string command(CONSOLE_BUFFER_SIZE - 2, 'x');
+    std::string output = fixture->run((command + "\n").c_str());
+    CHECK_EQ(output.size(), static_cast<size_t>(CONSOLE_RESPONSE_SIZE));
+    CHECK_EQ(output.compare(0, 25, "error: unknown command 'x"), 0);
+    CHECK_EQ(output.substr(output.size() - 4), "...\n");
+}
+
+/**
+ * @class CountingMux
+ * @brief Multiplexer that acknowledges every channel except an unplugged one.
+ */
+class CountingMux : public MuxBus {
+public:
+    int unplugged = -1; ///< Channel that does not answer, or -1
+    unsigned selects = 0; ///< Calls to `selectChannel()`
+
+    bool selectChannel(uint8_t channel) override {
+        selects++;
+        return channel != unplugged;
+    }
+};
+
+TEST(consoleRoutesSensorCommandsToRooms) {
+    auto fixture = makeFixture();
+    CountingMux mux;
+    mux.unplugged = 2;
+    SensorManager rooms[3];
+    SensorGroup group(mux, SCD30_INTERVAL_MS);
+    for (uint8_t i = 0; i < 3; i++) {
+        group.addRoom(rooms[i], i);
+    }
+    CHECK_EQ(group.begin(0), 2);
+    fixture->console.setRooms(group, rooms);
+
+    CHECK_EQ(fixture->run("calibrate\n"), "error: usage calibrate <room 1-3>\n");
+    CHECK_EQ(fixture->run("calibrate 4\n"), "error: usage calibrate <room 1-3>\n");
+    CHECK_EQ(fixture->run("calibrate 3\n"), "error: room 3 is offline\n");
+    unsigned selects = mux.selects;
+    CHECK_EQ(fixture->run("calibrate 2\n"), "ok\n");
+    CHECK_EQ(mux.selects, selects + 1);
+
+    // Thresholds apply to the alert monitor of every room
+    CHECK_EQ(fixture->run("threshold moderate 900\n"), "ok\n");
+    for (uint8_t i = 0; i < 3; i++) {
+        CHECK_EQ(group.getRoom(i).alertMonitor.getModerateThreshold(), 900.0f);
+    }
+
+    std::string output = fixture->run("stats\n");
+    CHECK(output.find("\nroom 1: online,") != std::string::npos);
+    CHECK(output.find("\nroom 3: offline,") != std::string::npos);
+    CHECK(output.find("thresholds: moderate 900, critical 2000 ppm") != std::string::npos);
+    CHECK(output.find("pressure compensation") == std::string::npos);
+}
@@ -0,0 +1,160 @@
+#include <math.h>
+#include "HostTest.h"
+#include "VentilationEstimator.h"
+
+/**
+ * @file VentilationEstimatorTest.cpp
+ * @brief Episode detection and the log-linear air change fit on synthetic decays.
+ */
+
+/**
+ * @struct RoomScript
+ * @brief Feeds a synthetic CO2 curve into the estimator, one sample every 2 s.
+ */
+struct RoomScript {
+    static const unsigned long STEP_MS = 2000; ///< Sample interval in ms
+
+    VentilationEstimator estimator;
+    unsigned long now = 0; ///< Timestamp of the next sample in ms
+    float co2 = 0.0f; ///< Last CO2 level fed in ppm
+    float noise = 0.0f; ///< Amplitude of the uniform noise added to every sample in ppm
+    uint32_t random = 1; ///< Generator state of the noise
+    unsigned completed = 0; ///< Samples that completed an episode with a valid estimate
+    bool opened = false; ///< Whether an episode was active at any point
+
+    /**
+     * @brief Feeds one sample of the given level.
+     */
+    void sample(float level) {
+        random = random * 1664525UL + 1013904223UL;
+        co2 = level;
+        completed += estimator.addSample(level + noise * ((random >> 8) / 8388608.0f - 1.0f), now);
+        opened = opened || estimator.isEpisodeActive();
+        now += STEP_MS;
+    }
+
+    /**
+     * @brief Holds a constant level for a duration.
+     */
+    void hold(float level, unsigned long durationMs) {
+        for (unsigned long end = now + durationMs; now < end; ) {
+            sample(level);
+        }
+    }
+
+    /**
+     * @brief Decays exponentially from the last level towards outdoor air for a duration.
+     *
+     * @param airChangesPerHour The true air change rate.
+     */
+    void decay(float airChangesPerHour, unsigned long durationMs) {
+        float excess = co2 - FRESH_AIR_CO2;
+        unsigned long start = now;
+        for (unsigned long end = now + durationMs; now < end; ) {
+            float hours = (now - start + STEP_MS) / 3600000.0f;
+            sample(FRESH_AIR_CO2 + excess * expf(-airChangesPerHour * hours));
+        }
+    }
+
+    /**
+     * @brief Rises linearly from the last level for a duration.
+     */
+    void rise(float ppmPerMinute, unsigned long durationMs) {
+        float start = co2;
+        unsigned long begin = now;
+        for (unsigned long end = now + durationMs; now < end; ) {
+            sample(start + ppmPerMinute * (now - begin + STEP_MS) / 60000.0f);
+        }
+    }
+};
+
+TEST(ventilationFitsKnownDecays) {
+    const float rates[] = { 1.0f, 3.0f, 8.0f };
+    for (float rate : rates) {
+        RoomScript room;
+        room.hold(1500.0f, 300000);
+        room.decay(rate, 4 * 3600000UL);
+        CHECK_EQ(room.completed, 1u);
+        CHECK(room.estimator.hasEstimate());
+        CHECK_NEAR(room.estimator.getLastAirChangeRate(), rate, 0.01 * rate);
+        CHECK(room.estimator.getLastFitQuality() > 0.999f);
+        // The episode ends where the excess approaches VENT_MIN_EXCESS
+        float minutes = 60.0f * logf(1100.0f / VENT_MIN_EXCESS) / rate;
+        CHECK_NEAR(room.estimator.getLastEpisodeMinutes(), minutes, 0.1 * minutes);
+    }
+}
+
+TEST(ventilationFitsNoisyDecay) {
+    RoomScript room;
+    room.noise = 10.0f;
+    room.hold(1200.0f, 600000);
+    room.decay(2.0f, 3 * 3600000UL);
+    CHECK_EQ(room.completed, 1u);
+    CHECK_NEAR(room.estimator.getLastAirChangeRate(), 2.0, 0.2);
+    CHECK(room.estimator.getLastFitQuality() >= VENT_MIN_FIT_QUALITY);
+}
+
+TEST(ventilationRejectsShortEpisodes) {
+    RoomScript room;
+    room.hold(1500.0f, 300000);
+    // At 60 air changes per hour the excess is gone in under four minutes
+    room.decay(60.0f, 600000);
+    CHECK(room.opened);
+    CHECK(!room.estimator.isEpisodeActive());
+    CHECK_EQ(room.completed, 0u);
+    CHECK(!room.estimator.hasEstimate());
+}
+
+TEST(ventilationRejectsFlatEpisodes) {
+    RoomScript room;
+    room.noise = 5.0f;
+    room.hold(1500.0f, 300000);
+    // A step down opens an episode, but the level stays flat afterwards
+    room.hold(1400.0f, 1800000);
+    CHECK(room.estimator.isEpisodeActive());
+    room.rise(20.0f, 600000);
+    CHECK(!room.estimator.isEpisodeActive());
+    CHECK_EQ(room.completed, 0u);
+    CHECK(!room.estimator.hasEstimate());
+}
+
+TEST(ventilationIgnoresLevelsNearOutdoor) {
+    RoomScript room;
+    // The excess is too small for the logarithm to carry information
+    room.hold(FRESH_AIR_CO2 + VENT_MIN_EXCESS + 20.0f, 300000);
+    room.decay(3.0f, 3600000);
+    CHECK(!room.opened);
+    CHECK(!room.estimator.hasEstimate());
+}
+
+TEST(ventilationRiseEndsEpisode) {
+    RoomScript room;
+    room.hold(1500.0f, 300000);
+    // Windows closed again after three minutes: too short for an estimate
+    room.decay(3.0f, 180000);
+    CHECK(room.estimator.isEpisodeActive());
+    room.rise(30.0f, 300000);
+    CHECK(!room.estimator.isEpisodeActive());
+    CHECK_EQ(room.completed, 0u);
+
+    // A long decay interrupted by a rise closes within a few samples of the rise
+    room.hold(room.co2, 300000);
+    room.decay(3.0f, 1200000);
+    room.rise(30.0f, 300000);
+    CHECK_EQ(room.completed, 1u);
+    CHECK_NEAR(room.estimator.getLastAirChangeRate(), 3.0, 0.15);
+    CHECK(room.estimator.getLastEpisodeMinutes() < 22.0f);
+}
+
+TEST(ventilationGapAbortsEpisode) {
+    RoomScript room;
+    room.hold(1500.0f, 300000);
+    room.decay(3.0f, 600000);
+    CHECK(room.estimator.isEpisodeActive());
+    room.now += VENT_MAX_SAMPLE_GAP_MS + room.STEP_MS;
+    room.decay(3.0f, 2 * 3600000UL);
+    // After the gap the detection starts over from the current level
+    CHECK_EQ(room.completed, 1u);
+    CHECK(room.estimator.getLastEpisodeMinutes() < 65.0f);
+    CHECK_NEAR(room.estimator.getLastAirChangeRate(), 3.0, 0.05);
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "HostTest.h"
+#include "Logger.h"
+
+/**
+ * @file main.cpp
+ * @brief Runs the registered host tests, or the benchmarks with `--bench`.
+ *
+ * The firmware log is off unless `--log LEVEL` is given, so only failed checks are printed.
+ */
+
+namespace hosttest {
+
+static Case* first = nullptr; ///< Registered cases, in reverse order of registration
+static unsigned failures = 0; ///< Failed checks of the running test
+
+bool add(Case& testCase) {
+    testCase.next = first;
+    first = &testCase;
+    return true;
+}
+
+void fail(const char* file, int line, const char* expression) {
+    printf("  %s:%d: CHECK(%s) failed\n", file, line, expression);
+    failures++;
+}
+
+} // namespace hosttest
+
+/**
+ * @brief Prints the usage.
+ */
+static void printUsage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [--bench] [--log LEVEL] [PREFIX]\n"
+            "  --bench      run the benchmarks instead of the tests\n"
+            "  --log LEVEL  firmware log level written to standard error (default 0)\n"
+            "  PREFIX       run only the cases whose name starts with PREFIX\n",
+            program);
+}
+
+int main(int argc, char** argv) {
+    bool bench = false;
+    const char* prefix = "";
+    int logLevel = LOG_NONE;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--bench") == 0) {
+            bench = true;
+        } else if (strcmp(argv[i], "--log") == 0 && i + 1 < argc) {
+            logLevel = atoi(argv[++i]);
+        } else if (strncmp(argv[i], "--", 2) == 0) {
+            printUsage(argv[0]);
+            return 2;
+        } else {
+            prefix = argv[i];
+        }
+    }
+
+    Logger::setLogLevel(static_cast<LogLevel>(logLevel));
+
+    // Registration prepends, so reverse the list to run in file order
+    hosttest::Case* ordered = nullptr;
+    while (hosttest::first != nullptr) {
+        hosttest::Case* next = hosttest::first->next;
+        hosttest::first->next = ordered;
+        ordered = hosttest::first;
+        hosttest::first = next;
+    }
+
+    unsigned run = 0;
+    unsigned failed = 0;
+    for (hosttest::Case* testCase = ordered; testCase != nullptr; testCase = testCase->next) {
+        if (testCase->bench != bench || strncmp(testCase->name, prefix, strlen(prefix)) != 0) {
+            continue;
+        }
+        hosttest::failures = 0;
+        testCase->run();
+        run++;
+        if (hosttest::failures > 0) {
+            failed++;
+        }
+        if (!bench) {
+            printf("%-4s %s\n", hosttest::failures == 0 ? "ok" : "FAIL", testCase->name);
+        }
+    }
+
+    if (!bench) {
+        printf("%u of %u tests passed\n", run - failed, run);
+    }
+    return failed == 0 ? 0 : 1;
+}
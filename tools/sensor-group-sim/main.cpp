@@ -0,0 +1,334 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <memory>
+#include "SensorGroup.h"
+
+/**
+ * @file main.cpp
+ * @brief Simulates the polling of several rooms behind an I2C multiplexer.
+ *
+ * Every room is a simulated SCD30 that delivers a measurement every interval, with its own
+ * phase and clock drift. Each bus transaction advances a virtual clock by its typical
+ * duration, so the simulation shows how long each scheme occupies the bus and how late
+ * a measurement is read after it became available. The `SensorGroup` of the firmware is
+ * compared with a naive loop that visits every channel once per `SENSOR_POLL_INTERVAL_MS`.
+ * The same seed always gives the same results.
+ */
+
+#define SELECT_COST_US 200UL ///< Writing the channel register of the TCA9548A
+#define DATA_CHECK_COST_US 3500UL ///< SCD30 data-ready command, including the command delay
+#define READ_COST_US 6000UL ///< SCD30 measurement read plus the BMP280 temperature and pressure
+#define MAX_DRIFT 0.005 ///< Largest relative deviation of a sensor clock
+
+/**
+ * @struct Options
+ * @brief Command-line settings of a simulation.
+ */
+struct Options {
+    double minutes = 60; ///< Simulated time per run
+    unsigned long intervalMs = SCD30_INTERVAL_MS; ///< Measurement interval of the sensors
+    int rooms = 0; ///< Number of rooms, or 0 for 1 to 8
+    uint32_t seed = 1; ///< Seed of the sensor phases, drifts and readings
+};
+
+/**
+ * @struct SimBus
+ * @brief Virtual clock and bus occupancy shared by the multiplexer and the sensors.
+ */
+struct SimBus {
+    uint64_t nowUs = 0; ///< Virtual time in us
+    uint64_t busyUs = 0; ///< Time spent in bus transactions in us
+    int channel = -1; ///< Channel selected on the multiplexer
+    uint32_t selects = 0; ///< Writes to the multiplexer
+    uint32_t checks = 0; ///< Data-ready checks
+    uint32_t wrongChannel = 0; ///< Sensor accesses while another channel was selected
+
+    /**
+     * @brief Occupies the bus for one transaction.
+     */
+    void transfer(uint64_t costUs) {
+        nowUs += costUs;
+        busyUs += costUs;
+    }
+
+    unsigned long millis() const { return static_cast<unsigned long>(nowUs / 1000); }
+};
+
+/**
+ * @class FakeMux
+ * @brief A TCA9548A that always acknowledges.
+ */
+class FakeMux : public MuxBus {
+private:
+    SimBus& bus; ///< Clock and bus state
+
+public:
+    explicit FakeMux(SimBus& bus) : bus(bus) {}
+
+    bool selectChannel(uint8_t channel) override {
+        bus.transfer(SELECT_COST_US);
+        bus.channel = channel;
+        bus.selects++;
+        return true;
+    }
+};
+
+/**
+ * @brief Advances a linear congruential generator and returns a value in [0, 1).
+ */
+static double nextRandom(uint32_t& state) {
+    state = state * 1664525UL + 1013904223UL;
+    return (state >> 8) / 16777216.0;
+}
+
+/**
+ * @class FakeRoomSensor
+ * @brief An SCD30/BMP280 set that measures on its own clock.
+ *
+ * Measurement `k` becomes available at `startUs + k * periodUs`; a measurement that is not
+ * read before the next one arrives is overwritten and counted as missed.
+ */
+class FakeRoomSensor : public RoomSensor {
+private:
+    SimBus& bus; ///< Clock and bus state
+    uint8_t channel; ///< Channel the sensor is wired to
+    uint32_t random; ///< Generator state of the phase, drift and readings
+    double startUs = 0; ///< Time of the first measurement in us
+    double periodUs = 0; ///< Measurement period on the sensor clock in us
+    int64_t lastRead = -1; ///< Index of the last measurement read, or -1
+    double co2 = 600; ///< Random walk of the CO2 concentration in ppm
+
+    /**
+     * @brief Checks the sensor is accessed on its own channel.
+     */
+    void checkChannel() {
+        if (bus.channel != channel) {
+            bus.wrongChannel++;
+        }
+    }
+
+    /**
+     * @brief Retrieves the index of the latest available measurement, or -1.
+     */
+    int64_t latest() const {
+        if (periodUs <= 0 || bus.nowUs < startUs) {
+            return -1;
+        }
+        return static_cast<int64_t>((bus.nowUs - startUs) / periodUs);
+    }
+
+public:
+    uint32_t samples = 0; ///< Measurements read
+    uint32_t missed = 0; ///< Measurements overwritten before they were read
+    double latencyTotalUs = 0; ///< Sum of the times between availability and read in us
+    double latencyMaxUs = 0; ///< Longest time between availability and read in us
+
+    FakeRoomSensor(SimBus& bus, uint8_t channel, uint32_t seed)
+        : bus(bus), channel(channel), random(seed * 2654435761UL + channel) {}
+
+    bool initializeSensors(bool) override {
+        checkChannel();
+        bus.transfer(DATA_CHECK_COST_US);
+        return true;
+    }
+
+    bool setMeasurementInterval(uint16_t seconds) override {
+        checkChannel();
+        bus.transfer(SELECT_COST_US);
+        double drift = (2 * nextRandom(random) - 1) * MAX_DRIFT;
+        periodUs = seconds * 1e6 * (1 + drift);
+        startUs = bus.nowUs + nextRandom(random) * periodUs;
+        return true;
+    }
+
+    bool isDataAvailable() override {
+        checkChannel();
+        bus.transfer(DATA_CHECK_COST_US);
+        bus.checks++;
+        return latest() > lastRead;
+    }
+
+    void readSample(float values[HISTORY_CHANNEL_COUNT]) override {
+        checkChannel();
+        int64_t index = latest();
+        if (index > lastRead) {
+            missed += static_cast<uint32_t>(index - lastRead - 1);
+            double latencyUs = bus.nowUs - (startUs + index * periodUs);
+            latencyTotalUs += latencyUs;
+            if (latencyUs > latencyMaxUs) {
+                latencyMaxUs = latencyUs;
+            }
+            lastRead = index;
+            samples++;
+        }
+        bus.transfer(READ_COST_US);
+
+        co2 += (nextRandom(random) - 0.48) * 20;
+        co2 = fmin(fmax(co2, 400), 2500);
+        values[HISTORY_CO2] = static_cast<float>(co2);
+        values[HISTORY_TEMP_SCD] = 22.0f + static_cast<float>(nextRandom(random));
+        values[HISTORY_TEMP_BMP] = 21.5f + static_cast<float>(nextRandom(random));
+        values[HISTORY_HUMIDITY] = 45.0f;
+        values[HISTORY_PRESSURE] = 1013.0f;
+    }
+};
+
+/**
+ * @struct RunResult
+ * @brief Outputs of one run.
+ */
+struct RunResult {
+    uint32_t samples = 0; ///< Measurements read from all rooms
+    uint32_t missed = 0; ///< Measurements overwritten before they were read
+    double latencyMeanMs = 0; ///< Mean time between availability and read in ms
+    double latencyMaxMs = 0; ///< Longest time between availability and read in ms
+    uint32_t checks = 0; ///< Data-ready checks
+    uint32_t selects = 0; ///< Writes to the multiplexer
+    double busyPercent = 0; ///< Share of the time the bus was occupied
+    double passMaxMs = 0; ///< Longest blocking poll pass in ms
+    uint32_t alertChanges = 0; ///< Alert level changes of all rooms
+    uint32_t wrongChannel = 0; ///< Sensor accesses while another channel was selected
+};
+
+/**
+ * @brief Runs one scheme over the simulated time.
+ *
+ * @param rooms The number of rooms.
+ * @param scheduled `true` for the `SensorGroup`, `false` for the naive loop.
+ * @param options The simulation settings.
+ */
+static RunResult run(int rooms, bool scheduled, const Options& options) {
+    SimBus bus;
+    FakeMux mux(bus);
+    std::unique_ptr<SensorGroup> group(new SensorGroup(mux, options.intervalMs));
+    std::unique_ptr<FakeRoomSensor> sensors[SENSOR_GROUP_MAX_ROOMS];
+    for (int i = 0; i < rooms; i++) {
+        sensors[i].reset(new FakeRoomSensor(bus, i, options.seed));
+        group->addRoom(*sensors[i], i);
+    }
+    group->begin(bus.millis());
+
+    // Both schemes filter and evaluate the alerts of every room the same way
+    SensorFilter filters[SENSOR_GROUP_MAX_ROOMS];
+    AlertMonitor alerts[SENSOR_GROUP_MAX_ROOMS];
+
+    RunResult result;
+    uint64_t endUs = bus.nowUs + static_cast<uint64_t>(options.minutes * 60e6);
+    uint64_t nextNaiveUs = bus.nowUs;
+    while (bus.nowUs < endUs) {
+        uint64_t passStart = bus.nowUs;
+        if (scheduled) {
+            group->poll(bus.millis());
+            for (uint8_t mask = group->getAlertChanges(); mask != 0; mask &= mask - 1) {
+                result.alertChanges++;
+            }
+            bus.nowUs += LOOP_IDLE_MS * 1000ULL;
+        } else if (bus.nowUs >= nextNaiveUs) {
+            nextNaiveUs += SENSOR_POLL_INTERVAL_MS * 1000ULL;
+            for (int i = 0; i < rooms; i++) {
+                mux.selectChannel(i);
+                if (!sensors[i]->isDataAvailable()) {
+                    continue;
+                }
+                HistorySample sample;
+                sensors[i]->readSample(sample.values);
+                const float* values = sample.values;
+                filters[i].update(values[HISTORY_CO2], values[HISTORY_TEMP_SCD], values[HISTORY_TEMP_BMP]);
+                AlertLevel previous = alerts[i].getLevel();
+                if (alerts[i].evaluate(filters[i].getCO2()) != previous) {
+                    result.alertChanges++;
+                }
+            }
+        } else {
+            bus.nowUs += LOOP_IDLE_MS * 1000ULL;
+        }
+        double passMs = (bus.nowUs - passStart) / 1e3 - (scheduled ? LOOP_IDLE_MS : 0);
+        if (passMs > result.passMaxMs) {
+            result.passMaxMs = passMs;
+        }
+    }
+
+    double latencyTotalUs = 0;
+    for (int i = 0; i < rooms; i++) {
+        result.samples += sensors[i]->samples;
+        result.missed += sensors[i]->missed;
+        latencyTotalUs += sensors[i]->latencyTotalUs;
+        result.latencyMaxMs = fmax(result.latencyMaxMs, sensors[i]->latencyMaxUs / 1e3);
+    }
+    result.latencyMeanMs = result.samples > 0 ? latencyTotalUs / result.samples / 1e3 : 0;
+    result.checks = bus.checks;
+    result.selects = bus.selects;
+    result.busyPercent = 100.0 * bus.busyUs / bus.nowUs;
+    result.wrongChannel = bus.wrongChannel;
+    return result;
+}
+
+/**
+ * @brief Prints one table row.
+ */
+static void printRow(int rooms, const char* scheme, const RunResult& result) {
+    double samples = result.samples > 0 ? result.samples : 1;
+    printf("%5d  %-9s %8u %7u %9.1f %8.1f %7.2f %9.2f %6.2f %9.1f %7u\n", rooms, scheme, result.samples,
+           result.missed, result.latencyMeanMs, result.latencyMaxMs, result.checks / samples,
+           result.selects / samples, result.busyPercent, result.passMaxMs, result.alertChanges);
+}
+
+/**
+ * @brief Prints the usage.
+ */
+static void printUsage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --minutes N         simulated time per run (default 60)\n"
+            "  --interval-ms MS    SCD30 measurement interval, a multiple of 1000 (default %lu)\n"
+            "  --rooms N           simulate N rooms only (default 1 to %d)\n"
+            "  --seed N            seed of the sensor phases, drifts and readings (default 1)\n",
+            program, static_cast<unsigned long>(SCD30_INTERVAL_MS), SENSOR_GROUP_MAX_ROOMS);
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--minutes") == 0 && i + 1 < argc) {
+            options.minutes = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--interval-ms") == 0 && i + 1 < argc) {
+            options.intervalMs = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--rooms") == 0 && i + 1 < argc) {
+            options.rooms = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options.seed = strtoul(argv[++i], nullptr, 10);
+        } else {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    if (options.minutes <= 0 || options.intervalMs < 2000 || options.intervalMs % 1000 != 0 ||
+        options.rooms < 0 || options.rooms > SENSOR_GROUP_MAX_ROOMS) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    printf("%.0f min per run, measurement interval %lu ms, naive poll every %lu ms\n", options.minutes,
+           options.intervalMs, static_cast<unsigned long>(SENSOR_POLL_INTERVAL_MS));
+    printf("rooms  scheme     samples  missed  lat mean  lat max  checks  switches  busy%%  pass max  alerts\n");
+    printf("                                       ms       ms  /sample   /sample            ms\n");
+
+    int first = options.rooms > 0 ? options.rooms : 1;
+    int last = options.rooms > 0 ? options.rooms : SENSOR_GROUP_MAX_ROOMS;
+    uint32_t wrongChannel = 0;
+    for (int rooms = first; rooms <= last; rooms++) {
+        RunResult naive = run(rooms, false, options);
+        RunResult scheduled = run(rooms, true, options);
+        printRow(rooms, "naive", naive);
+        printRow(rooms, "scheduled", scheduled);
+        wrongChannel += naive.wrongChannel + scheduled.wrongChannel;
+    }
+
+    if (wrongChannel > 0) {
+        fprintf(stderr, "%u sensor accesses on the wrong channel\n", wrongChannel);
+        return 1;
+    }
+    return 0;
+}
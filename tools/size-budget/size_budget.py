@@ -0,0 +1,65 @@
+"""Reports the flash and RAM usage of a firmware build and checks it against its budget.
+
+Used as a PlatformIO post script (``extra_scripts = post:tools/size-budget/size_budget.py``).
+The budgets in bytes come from the ``custom_flash_budget`` and ``custom_ram_budget`` options
+of the environment; a build that exceeds either one fails. The report line is also written
+to ``size-budget.txt`` in the build directory, which ``make sizes`` collects per profile.
+"""
+
+import re
+import subprocess
+
+Import("env")  # noqa: F821 - provided by PlatformIO
+
+# The sections the ESP8266 platform counts as program (flash) and data (RAM)
+FLASH_SECTIONS = re.compile(r"^(?:\.irom0\.text|\.text|\.text1|\.data|\.rodata)\s+([0-9]+)")
+RAM_SECTIONS = re.compile(r"^(?:\.data|\.rodata|\.bss)\s+([0-9]+)")
+
+
+def section_sizes(elf):
+    """Sums the flash and RAM sections of an ELF file as reported by ``size -A``."""
+    output = subprocess.check_output([env.subst("$SIZETOOL"), "-A", "-d", elf]).decode()  # noqa: F821
+    flash = ram = 0
+    for line in output.splitlines():
+        match = FLASH_SECTIONS.match(line)
+        if match:
+            flash += int(match.group(1))
+        match = RAM_SECTIONS.match(line)
+        if match:
+            ram += int(match.group(1))
+    return flash, ram
+
+
+def budget(option):
+    """Reads a budget option of the environment; 0 means no limit."""
+    value = env.GetProjectOption(option, "0")  # noqa: F821
+    return int(str(value).split(";")[0].strip() or 0)
+
+
+def check_budget(source, target, env):
+    elf = str(source[0])
+    flash, ram = section_sizes(elf)
+    flash_budget = budget("custom_flash_budget")
+    ram_budget = budget("custom_ram_budget")
+
+    def usage(used, limit):
+        if limit == 0:
+            return "%d bytes" % used
+        return "%d / %d bytes (%.0f%%)" % (used, limit, 100.0 * used / limit)
+
+    report = "%-20s flash %s, RAM %s" % (env["PIOENV"], usage(flash, flash_budget), usage(ram, ram_budget))
+    print("Size budget: " + report)
+    with open(env.subst("$BUILD_DIR/size-budget.txt"), "w") as file:
+        file.write(report + "\n")
+
+    over = []
+    if flash_budget and flash > flash_budget:
+        over.append("flash by %d bytes" % (flash - flash_budget))
+    if ram_budget and ram > ram_budget:
+        over.append("RAM by %d bytes" % (ram - ram_budget))
+    if over:
+        print("Error: %s exceeds its budget: %s" % (env["PIOENV"], ", ".join(over)))
+        env.Exit(1)
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", check_budget)  # noqa: F821
@@ -0,0 +1,431 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <EEPROM.h>
+#include "AlertMonitor.h"
+#include "DisplayManager.h"
+#include "ExposureAccumulator.h"
+#include "HistoryCodec.h"
+#include "LogLineParser.h"
+#include "Logger.h"
+#include "MeasurementPipeline.h"
+#include "MeterPages.h"
+#include "PageManager.h"
+#include "PressureCompensator.h"
+#include "ReplayHardware.h"
+#include "SensorFilter.h"
+#include "SensorManager.h"
+#include "TraceCodec.h"
+#include "TraceRecorder.h"
+#include "VentilationEstimator.h"
+
+/**
+ * @file main.cpp
+ * @brief Replays recorded sensor traces through the firmware sample path under a virtual clock.
+ *
+ * The firmware sources are compiled unchanged against the shims in `shim/`: the SCD30 and
+ * BMP280 drivers answer from the trace, `millis()` follows the trace timestamps and the
+ * SSD1306 driver records each pushed frame. The same trace therefore always produces the
+ * same readings, alerts and frames, which the output digest condenses into one number.
+ */
+
+static const char* const ALERT_NAMES[] = { "none", "moderate", "critical" };
+
+/**
+ * @struct Options
+ * @brief Command-line settings of a replay.
+ */
+struct Options {
+    bool csv = false; ///< Print one CSV line per sample
+    float moderate = CO2_MODERATE_THRESHOLD; ///< Moderate alert threshold in ppm
+    float critical = CO2_CRITICAL_THRESHOLD; ///< Critical alert threshold in ppm
+    unsigned long repeat = 1; ///< Number of timed passes
+    int logLevel = LOG_NONE; ///< Firmware log level during the first pass
+    const char* expect = nullptr; ///< Expected output digest in hex
+};
+
+/**
+ * @struct ReplayResult
+ * @brief Outputs of one pass through the trace.
+ */
+struct ReplayResult {
+    uint32_t digest = 2166136261UL; ///< FNV-1a hash over the per-sample outputs
+    uint32_t samples = 0; ///< Number of processed samples
+    uint32_t alertOnsets = 0; ///< Transitions from no alert to an alert
+    uint32_t levelChanges = 0; ///< Transitions between any two alert levels
+    uint32_t shortestDwellMs = 0; ///< Shortest time between two level changes (0 if fewer than two)
+    replay::FrameLog frames; ///< Frames pushed to the display
+    PageManagerStats pages = {}; ///< Page switches and background cache use
+    PipelineStageTiming timing[STAGE_COUNT] = {}; ///< Host execution time per stage
+    double wallSeconds = 0; ///< Host time of the pass
+};
+
+/**
+ * @brief Reads a whole file, or standard input for "-".
+ */
+static bool readFile(const char* path, std::string& out) {
+    if (strcmp(path, "-") == 0) {
+        char buffer[4096];
+        size_t received;
+        while ((received = fread(buffer, 1, sizeof(buffer), stdin)) > 0) {
+            out.append(buffer, received);
+        }
+        return true;
+    }
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return false;
+    }
+    std::ostringstream content;
+    content << file.rdbuf();
+    out = content.str();
+    return true;
+}
+
+/**
+ * @brief Decodes all `TRACE:` lines of a `dump trace` capture.
+ *
+ * @param text The capture.
+ * @param events Receives the events.
+ * @return The number of corrupt blocks.
+ */
+static size_t parseTraceDump(const std::string& text, std::vector<TraceEvent>& events) {
+    size_t corrupt = 0;
+    size_t position = 0;
+    while ((position = text.find("TRACE:", position)) != std::string::npos) {
+        size_t begin = position + 6;
+        size_t end = text.find_first_of("\r\n", begin);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        position = end;
+
+        uint8_t block[TRACE_BLOCK_BYTES];
+        size_t size = decodeBase64(text.data() + begin, end - begin, block, sizeof(block));
+        TraceDecoder decoder;
+        if (size == 0 || !decoder.begin(block, size)) {
+            corrupt++;
+            continue;
+        }
+        TraceEvent event;
+        uint16_t decoded = 0;
+        while (decoder.next(event)) {
+            events.push_back(event);
+            decoded++;
+        }
+        if (decoded != decoder.getEventCount()) {
+            corrupt++;
+        }
+    }
+    return corrupt;
+}
+
+/**
+ * @brief Builds a trace from the readings of a `Logger` text log.
+ *
+ * Logs carry neither timestamps nor poll results, so samples are spaced by `intervalMs`
+ * with one empty poll halfway in between, like `loop()` polling every second against the
+ * 2 s SCD30 interval. The poll durations are unknown and recorded as 0.
+ */
+static void parseTextLog(const std::string& text, uint32_t intervalMs, std::vector<TraceEvent>& events) {
+    static const int CHANNEL_MAP[CHANNEL_COUNT] = {
+        HISTORY_CO2, HISTORY_TEMP_SCD, HISTORY_TEMP_BMP, HISTORY_HUMIDITY, HISTORY_PRESSURE
+    };
+
+    TraceEvent current = {};
+    bool pending = false;
+    uint32_t timestamp = 0;
+
+    size_t position = 0;
+    while (position < text.size()) {
+        size_t end = text.find('\n', position);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        std::string_view line(text.data() + position, end - position);
+        position = end + 1;
+
+        LogLine parsed;
+        Channel channel;
+        float value;
+        if (!parseLogLine(line, parsed) || !parseReading(parsed.message, channel, value)) {
+            continue;
+        }
+        if (channel == CHANNEL_CO2) {
+            if (pending) {
+                events.push_back(current);
+            }
+            TraceEvent poll = {};
+            poll.timestampMs = timestamp + intervalMs / 2;
+            poll.type = TRACE_POLL_EMPTY;
+            events.push_back(poll);
+
+            timestamp += intervalMs;
+            current = {};
+            current.timestampMs = timestamp;
+            current.type = TRACE_SAMPLE;
+            pending = true;
+        }
+        current.values[CHANNEL_MAP[channel]] = value;
+    }
+    if (pending) {
+        events.push_back(current);
+    }
+}
+
+/**
+ * @brief Adds a string to an FNV-1a hash.
+ */
+static void hashText(uint32_t& hash, const char* text) {
+    for (; *text != '\0'; text++) {
+        hash ^= static_cast<uint8_t>(*text);
+        hash *= 16777619UL;
+    }
+}
+
+/**
+ * @brief Runs the events once through freshly constructed firmware objects.
+ *
+ * The objects are set up the way `setup()` does it, so no state leaks between passes.
+ *
+ * @param events The trace, ordered by timestamp.
+ * @param options The replay settings.
+ * @param csv Whether to print the per-sample CSV lines.
+ * @return The outputs of the pass.
+ */
+static ReplayResult runPass(const std::vector<TraceEvent>& events, const Options& options, bool csv) {
+    // The firmware objects are large enough to keep them off the stack
+    struct Firmware {
+        DisplayManager displayManager;
+        SensorManager sensorManager;
+        PressureCompensator pressureCompensator{ sensorManager };
+        SensorFilter sensorFilter;
+        VentilationEstimator ventilationEstimator;
+        ExposureAccumulator exposureAccumulator;
+        AlertMonitor alertMonitor;
+        TraceRecorder traceRecorder;
+        DisplayModel displayModel = {};
+        MeterPages meterPages{ displayModel, displayManager };
+        PageManager pageManager{ displayManager, meterPages.getPages(), PAGE_COUNT, PAGE_ROTATION_COUNT };
+        MeasurementPipeline pipeline{ sensorManager, sensorFilter, pressureCompensator, exposureAccumulator,
+                                      ventilationEstimator, alertMonitor, pageManager, displayModel, traceRecorder };
+    };
+
+    replay::reset();
+    std::unique_ptr<Firmware> firmware(new Firmware());
+    firmware->displayManager.initialize();
+    firmware->sensorManager.initializeSensors();
+    EEPROM.begin(EEPROM_SIZE);
+    firmware->exposureAccumulator.begin();
+    if (!firmware->alertMonitor.setThresholds(options.moderate, options.critical)) {
+        fprintf(stderr, "Invalid thresholds, using the defaults\n");
+    }
+
+    ReplayResult result;
+    AlertLevel level = ALERT_NONE;
+    uint32_t lastChangeMs = 0;
+    char line[160];
+
+    auto start = std::chrono::steady_clock::now();
+    for (const TraceEvent& event : events) {
+        replay::setTime(event.timestampMs);
+        replay::setSensorData(event.type == TRACE_SAMPLE, event.values);
+        bool sampled = firmware->pipeline.poll(event.timestampMs);
+        // loop() updates the pages after every poll, which advances the rotation and blinking
+        firmware->pageManager.update(event.timestampMs);
+        if (!sampled) {
+            continue;
+        }
+
+        const PipelineReadings& readings = firmware->pipeline.getReadings();
+        if (readings.alertLevel != level) {
+            if (level == ALERT_NONE) {
+                result.alertOnsets++;
+            }
+            uint32_t dwellMs = event.timestampMs - lastChangeMs;
+            if (result.levelChanges > 0 && (result.shortestDwellMs == 0 || dwellMs < result.shortestDwellMs)) {
+                result.shortestDwellMs = dwellMs;
+            }
+            result.levelChanges++;
+            lastChangeMs = event.timestampMs;
+            level = readings.alertLevel;
+        }
+
+        snprintf(line, sizeof(line), "%lu,%.2f,%.2f,%.2f,%s,%s",
+                 static_cast<unsigned long>(event.timestampMs), readings.raw.values[HISTORY_CO2], readings.co2,
+                 readings.temperatureSCD, ALERT_NAMES[readings.alertLevel], replay::frames().page.c_str());
+        hashText(result.digest, line);
+        hashText(result.digest, "\n");
+        if (csv) {
+            printf("%s\n", line);
+        }
+        result.samples++;
+    }
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    result.frames = replay::frames();
+    result.pages = firmware->pageManager.getStatistics();
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        result.timing[i] = firmware->pipeline.getTiming(static_cast<PipelineStage>(i));
+    }
+    return result;
+}
+
+/**
+ * @brief Prints the usage.
+ */
+static void printUsage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [options] [FILE...]\n"
+            "       Replays the TRACE: lines of 'dump trace' captures (default: stdin)\n"
+            "  --from-log FILE     build the trace from a Logger text log instead\n"
+            "  --interval-ms MS    sample spacing for --from-log (default 2000)\n"
+            "  --csv               print time_ms,co2_raw,co2_filtered,temp_scd,alert,page per sample\n"
+            "  --moderate PPM      moderate alert threshold\n"
+            "  --critical PPM      critical alert threshold\n"
+            "  --repeat N          additional timed passes\n"
+            "  --log LEVEL         firmware log level of the first pass (0-4, to stderr)\n"
+            "  --expect DIGEST     fail unless the output digest matches\n",
+            program);
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    std::vector<const char*> paths;
+    std::vector<const char*> logPaths;
+    unsigned long intervalMs = 2000;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            options.csv = true;
+        } else if (strcmp(argv[i], "--from-log") == 0 && i + 1 < argc) {
+            logPaths.push_back(argv[++i]);
+        } else if (strcmp(argv[i], "--interval-ms") == 0 && i + 1 < argc) {
+            intervalMs = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--moderate") == 0 && i + 1 < argc) {
+            options.moderate = strtof(argv[++i], nullptr);
+        } else if (strcmp(argv[i], "--critical") == 0 && i + 1 < argc) {
+            options.critical = strtof(argv[++i], nullptr);
+        } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            options.repeat = strtoul(argv[++i], nullptr, 10) + 1;
+        } else if (strcmp(argv[i], "--log") == 0 && i + 1 < argc) {
+            options.logLevel = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--expect") == 0 && i + 1 < argc) {
+            options.expect = argv[++i];
+        } else if (strncmp(argv[i], "--", 2) == 0) {
+            printUsage(argv[0]);
+            return 2;
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty() && logPaths.empty()) {
+        paths.push_back("-");
+    }
+
+    std::vector<TraceEvent> events;
+    size_t corrupt = 0;
+    for (const char* path : paths) {
+        std::string content;
+        if (!readFile(path, content)) {
+            return 1;
+        }
+        corrupt += parseTraceDump(content, events);
+    }
+    for (const char* path : logPaths) {
+        std::string content;
+        if (!readFile(path, content)) {
+            return 1;
+        }
+        parseTextLog(content, intervalMs, events);
+    }
+
+    // Blocks overlap when the recorder advanced during a dump
+    std::stable_sort(events.begin(), events.end(), [](const TraceEvent& a, const TraceEvent& b) {
+        return a.timestampMs < b.timestampMs;
+    });
+    events.erase(std::unique(events.begin(), events.end(), [](const TraceEvent& a, const TraceEvent& b) {
+        return a.timestampMs == b.timestampMs;
+    }), events.end());
+    if (events.empty()) {
+        fprintf(stderr, "No trace events found\n");
+        return 1;
+    }
+
+    // Only the first pass logs and prints; the others are for timing
+    Logger::setLogLevel(static_cast<LogLevel>(options.logLevel));
+    if (options.csv) {
+        printf("time_ms,co2_raw,co2_filtered,temp_scd,alert,page\n");
+    }
+    ReplayResult first = runPass(events, options, options.csv);
+    Logger::setLogLevel(LOG_NONE);
+
+    PipelineStageTiming timing[STAGE_COUNT] = {};
+    double wallSeconds = 0;
+    bool deterministic = true;
+    for (unsigned long pass = 0; pass < options.repeat; pass++) {
+        ReplayResult result = pass == 0 ? first : runPass(events, options, false);
+        deterministic = deterministic && result.digest == first.digest && result.frames.digest == first.frames.digest;
+        wallSeconds += result.wallSeconds;
+        for (int i = 0; i < STAGE_COUNT; i++) {
+            timing[i].count += result.timing[i].count;
+            timing[i].totalUs += result.timing[i].totalUs;
+            timing[i].maxUs = std::max(timing[i].maxUs, result.timing[i].maxUs);
+        }
+    }
+
+    uint64_t pollTotalUs = 0;
+    uint32_t pollMaxUs = 0;
+    for (const TraceEvent& event : events) {
+        pollTotalUs += event.pollMicros;
+        pollMaxUs = std::max(pollMaxUs, event.pollMicros);
+    }
+    uint32_t spanMs = events.back().timestampMs - events.front().timestampMs;
+
+    // The summary goes to stderr when stdout carries the CSV
+    FILE* out = options.csv ? stderr : stdout;
+    fprintf(out, "events:           %zu (%u samples, %zu empty polls), %zu corrupt blocks\n", events.size(),
+            first.samples, events.size() - first.samples, corrupt);
+    fprintf(out, "span:             %.1f min\n", spanMs / 60000.0);
+    fprintf(out, "recorded poll:    mean %.0f us, max %lu us\n", static_cast<double>(pollTotalUs) / events.size(),
+            static_cast<unsigned long>(pollMaxUs));
+    fprintf(out, "alerts:           %u onsets, %u level changes, shortest dwell %.1f s\n", first.alertOnsets,
+            first.levelChanges, first.shortestDwellMs / 1000.0);
+    fprintf(out, "frames:           %lu, digest %08lx, last page '%s'\n",
+            static_cast<unsigned long>(first.frames.count), static_cast<unsigned long>(first.frames.digest),
+            first.frames.page.c_str());
+    fprintf(out, "pages:            %lu renders, %lu switches, backgrounds %lu cached / %lu drawn\n",
+            static_cast<unsigned long>(first.pages.renders), static_cast<unsigned long>(first.pages.switches),
+            static_cast<unsigned long>(first.pages.backgroundHits),
+            static_cast<unsigned long>(first.pages.backgroundMisses));
+    fprintf(out, "output digest:    %08lx%s\n", static_cast<unsigned long>(first.digest),
+            deterministic ? "" : " (passes differ!)");
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        double mean = timing[i].count > 0 ? static_cast<double>(timing[i].totalUs) / timing[i].count : 0;
+        fprintf(out, "stage %-8s     mean %.2f us, max %lu us over %lu runs\n",
+                MeasurementPipeline::getStageName(static_cast<PipelineStage>(i)), mean,
+                static_cast<unsigned long>(timing[i].maxUs), static_cast<unsigned long>(timing[i].count));
+    }
+    if (wallSeconds > 0) {
+        fprintf(out, "speed:            %.0fx real time over %lu passes\n",
+                spanMs / 1000.0 * options.repeat / wallSeconds, options.repeat);
+    }
+
+    if (!deterministic) {
+        return 1;
+    }
+    if (options.expect != nullptr && strtoul(options.expect, nullptr, 16) != first.digest) {
+        fprintf(stderr, "Output digest %08lx does not match %s\n", static_cast<unsigned long>(first.digest),
+                options.expect);
+        return 1;
+    }
+    return 0;
+}
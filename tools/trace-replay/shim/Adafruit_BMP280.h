@@ -0,0 +1,20 @@
+#ifndef REPLAY_BMP280_H
+#define REPLAY_BMP280_H
+
+#include <Wire.h>
+#include "ReplayHardware.h"
+
+/**
+ * @file Adafruit_BMP280.h
+ * @brief BMP280 driver answering from the trace event being replayed.
+ */
+
+class Adafruit_BMP280 {
+public:
+    bool begin(uint8_t) { return true; }
+    float readTemperature() { return replay::sensorData().values[HISTORY_TEMP_BMP]; }
+    // The driver reports Pa
+    float readPressure() { return replay::sensorData().values[HISTORY_PRESSURE] * 100.0f; }
+};
+
+#endif // REPLAY_BMP280_H
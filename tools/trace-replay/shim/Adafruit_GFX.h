@@ -0,0 +1,38 @@
+#ifndef REPLAY_GFX_H
+#define REPLAY_GFX_H
+
+#include <Arduino.h>
+
+/**
+ * @file Adafruit_GFX.h
+ * @brief Text drawing that records the operations of a frame instead of rasterizing them.
+ *
+ * Every cursor move, size change and printed string is appended to the frame text, so two
+ * frames compare equal exactly when the firmware drew the same content. The text lives in
+ * a buffer of the size of the real frame buffer, so copies made through `getBuffer()`
+ * restore the drawing operations just like they restore pixels on the device.
+ */
+
+class Adafruit_GFX {
+protected:
+    uint8_t frame[128 * 64 / 8] = {}; ///< Drawing operations since the last `clearDisplay()`, NUL-terminated
+    uint8_t textSize = 1; ///< Current text scale
+
+    /**
+     * @brief Appends to the frame text; text beyond the buffer is dropped.
+     */
+    void append(const std::string& text);
+
+public:
+    void setTextSize(uint8_t size);
+    void setTextColor(uint16_t color);
+    void setTextColor(uint16_t color, uint16_t background);
+    void setCursor(int16_t x, int16_t y);
+    // The built-in font is 6x8 pixels per character
+    void getTextBounds(const char* text, int16_t x, int16_t y, int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h);
+    size_t print(const char* text);
+    size_t println(const char* text);
+    uint8_t* getBuffer() { return frame; }
+};
+
+#endif // REPLAY_GFX_H
@@ -0,0 +1,27 @@
+#ifndef REPLAY_SSD1306_H
+#define REPLAY_SSD1306_H
+
+#include <Adafruit_GFX.h>
+#include <Wire.h>
+
+/**
+ * @file Adafruit_SSD1306.h
+ * @brief SSD1306 driver handing every pushed frame to the replay frame log.
+ */
+
+#define SSD1306_BLACK 0
+#define SSD1306_WHITE 1
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_DISPLAYOFF 0xAE
+#define SSD1306_DISPLAYON 0xAF
+
+class Adafruit_SSD1306 : public Adafruit_GFX {
+public:
+    Adafruit_SSD1306(uint8_t, uint8_t, TwoWire*, int8_t) {}
+    bool begin(uint8_t, uint8_t) { return true; }
+    void clearDisplay() { frame[0] = 0; }
+    void display();
+    void ssd1306_command(uint8_t command);
+};
+
+#endif // REPLAY_SSD1306_H
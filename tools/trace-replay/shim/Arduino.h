@@ -0,0 +1,85 @@
+#ifndef REPLAY_ARDUINO_H
+#define REPLAY_ARDUINO_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+/**
+ * @file Arduino.h
+ * @brief The subset of the Arduino core used by the replayed firmware sources.
+ *
+ * `millis()` returns the virtual clock of the replay, while `micros()` measures real host
+ * time so that the stage timing of `MeasurementPipeline` reports the host cost.
+ */
+
+typedef uint8_t byte;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+
+/**
+ * @class String
+ * @brief Minimal Arduino `String` supporting concatenation.
+ */
+class String {
+private:
+    std::string text; ///< The characters
+
+public:
+    String(const char* text = "") : text(text) {}
+    String(const std::string& text) : text(text) {}
+    String(unsigned long value) : text(std::to_string(value)) {}
+    String operator+(const String& other) const { return String(text + other.text); }
+    String operator+(const char* other) const { return String(text + other); }
+    const char* c_str() const { return text.c_str(); }
+};
+
+/**
+ * @class Stream
+ * @brief Byte stream with text output, e.g. a serial port or a scripted host stream.
+ */
+class Stream {
+public:
+    virtual ~Stream() {}
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual size_t write(const char* text) = 0;
+    size_t print(const char* text) { return write(text); }
+    size_t println(const char* text = "") { return write(text) + write("\n"); }
+};
+
+/**
+ * @class HardwareSerial
+ * @brief Serial port writing to standard error, so standard output stays clean for CSV.
+ */
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long) {}
+    int available() override { return 0; }
+    int read() override { return -1; }
+    size_t write(const char* text) override { return fputs(text, stderr) < 0 ? 0 : strlen(text); }
+    void flush() { fflush(stderr); }
+    operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+/**
+ * @class EspClass
+ * @brief The ESP8266 system calls used by the firmware sources.
+ */
+class EspClass {
+public:
+    uint32_t getFreeHeap() const { return 40000; }
+    uint32_t getCycleCount() const { return static_cast<uint32_t>(micros() * 80); }
+};
+
+extern EspClass ESP;
+
+#endif // REPLAY_ARDUINO_H
@@ -0,0 +1,38 @@
+#ifndef REPLAY_EEPROM_H
+#define REPLAY_EEPROM_H
+
+#include <Arduino.h>
+
+/**
+ * @file EEPROM.h
+ * @brief Emulated EEPROM in host memory; `replay::reset()` erases it before every pass.
+ */
+
+class EEPROMClass {
+private:
+    uint8_t data[4096]; ///< The memory, erased to 0xFF
+
+public:
+    EEPROMClass() { erase(); }
+    void begin(size_t) {}
+    void erase() { memset(data, 0xFF, sizeof(data)); }
+    uint8_t read(int address) const { return data[address]; }
+    void write(int address, uint8_t value) { data[address] = value; }
+    bool commit() { return true; }
+
+    template <typename T>
+    T& get(int address, T& value) const {
+        memcpy(&value, data + address, sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    const T& put(int address, const T& value) {
+        memcpy(data + address, &value, sizeof(T));
+        return value;
+    }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif // REPLAY_EEPROM_H
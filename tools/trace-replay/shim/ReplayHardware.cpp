@@ -0,0 +1,147 @@
+#include "ReplayHardware.h"
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+#include <Adafruit_SSD1306.h>
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <Wire.h>
+
+/**
+ * @file ReplayHardware.cpp
+ * @brief Implements the shimmed Arduino core and drivers of the replay harness.
+ */
+
+HardwareSerial Serial;
+EspClass ESP;
+TwoWire Wire;
+EEPROMClass EEPROM;
+
+namespace replay {
+
+static unsigned long virtualMillis = 0; ///< Time returned by `millis()`
+static bool acceptCommands = true; ///< Result of the SCD30 configuration commands
+static SensorData currentData = {}; ///< Data the sensors report
+static FrameLog frameLog = { 0, 2166136261UL, "", "" };
+
+void setTime(unsigned long ms) {
+    virtualMillis = ms;
+}
+
+void setSensorData(bool available, const float* values) {
+    currentData.available = available;
+    for (int i = 0; i < HISTORY_CHANNEL_COUNT; i++) {
+        currentData.values[i] = values[i];
+    }
+}
+
+const SensorData& sensorData() {
+    return currentData;
+}
+
+void pushFrame(const std::string& frame, const std::string& firstText) {
+    frameLog.count++;
+    for (unsigned char c : frame) {
+        frameLog.digest ^= c;
+        frameLog.digest *= 16777619UL;
+    }
+    // Separate the frames so that moving text between them changes the digest
+    frameLog.digest ^= 0xFF;
+    frameLog.digest *= 16777619UL;
+    frameLog.lastFrame = frame;
+    frameLog.page = firstText.empty() ? "(blank)" : firstText;
+}
+
+const FrameLog& frames() {
+    return frameLog;
+}
+
+void setCommandsAccepted(bool accepted) {
+    acceptCommands = accepted;
+}
+
+bool commandsAccepted() {
+    return acceptCommands;
+}
+
+void reset() {
+    virtualMillis = 0;
+    acceptCommands = true;
+    currentData = {};
+    frameLog = { 0, 2166136261UL, "", "" };
+    EEPROM.erase();
+}
+
+} // namespace replay
+
+unsigned long millis() {
+    return replay::virtualMillis;
+}
+
+unsigned long micros() {
+    static const auto start = std::chrono::steady_clock::now();
+    return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+void delay(unsigned long ms) {
+    replay::virtualMillis += ms;
+}
+
+void Adafruit_GFX::append(const std::string& text) {
+    size_t length = strlen(reinterpret_cast<char*>(frame));
+    size_t count = std::min(text.size(), sizeof(frame) - 1 - length);
+    memcpy(frame + length, text.data(), count);
+    frame[length + count] = 0;
+}
+
+void Adafruit_GFX::setTextSize(uint8_t size) {
+    textSize = size;
+    append("S" + std::to_string(size) + ";");
+}
+
+void Adafruit_GFX::setTextColor(uint16_t color) {
+    append("C" + std::to_string(color) + ";");
+}
+
+void Adafruit_GFX::setTextColor(uint16_t color, uint16_t background) {
+    append("C" + std::to_string(color) + "/" + std::to_string(background) + ";");
+}
+
+void Adafruit_GFX::setCursor(int16_t x, int16_t y) {
+    append("@" + std::to_string(x) + "," + std::to_string(y) + ";");
+}
+
+void Adafruit_GFX::getTextBounds(const char* text, int16_t x, int16_t y, int16_t* x1, int16_t* y1,
+                                 uint16_t* w, uint16_t* h) {
+    *x1 = x;
+    *y1 = y;
+    *w = static_cast<uint16_t>(strlen(text) * 6 * textSize);
+    *h = static_cast<uint16_t>(8 * textSize);
+}
+
+size_t Adafruit_GFX::print(const char* text) {
+    append(std::string("'") + text + "';");
+    return strlen(text);
+}
+
+size_t Adafruit_GFX::println(const char* text) {
+    size_t length = print(text);
+    append("\\n;");
+    return length + 1;
+}
+
+void Adafruit_SSD1306::display() {
+    // The first text operation follows the first quote
+    std::string frame(reinterpret_cast<char*>(this->frame));
+    std::string firstText;
+    size_t begin = frame.find('\'');
+    if (begin != std::string::npos) {
+        firstText = frame.substr(begin + 1, frame.find("';", begin) - begin - 1);
+    }
+    replay::pushFrame(frame, firstText);
+}
+
+void Adafruit_SSD1306::ssd1306_command(uint8_t command) {
+    replay::pushFrame(command == SSD1306_DISPLAYOFF ? "OFF" : "ON", command == SSD1306_DISPLAYOFF ? "(off)" : "(on)");
+}
@@ -0,0 +1,82 @@
+#ifndef REPLAY_HARDWARE_H
+#define REPLAY_HARDWARE_H
+
+#include <stdint.h>
+#include <string>
+#include "HistoryCodec.h"
+
+/**
+ * @file ReplayHardware.h
+ * @brief State shared by the shimmed drivers: virtual clock, sensor data and frame log.
+ */
+
+namespace replay {
+
+/**
+ * @struct SensorData
+ * @brief What the sensors report for the event being replayed.
+ */
+struct SensorData {
+    bool available; ///< Result of `SCD30::dataAvailable()`
+    float values[HISTORY_CHANNEL_COUNT]; ///< Readings indexed by `HistoryChannel`
+};
+
+/**
+ * @struct FrameLog
+ * @brief Summary of the frames pushed to the display.
+ */
+struct FrameLog {
+    uint32_t count; ///< Number of `display()` calls and panel commands
+    uint32_t digest; ///< FNV-1a hash chained over all frames in order
+    std::string lastFrame; ///< Drawing operations of the last frame
+    std::string page; ///< First text of the last frame, which names the page
+};
+
+/**
+ * @brief Sets the virtual time returned by `millis()`.
+ */
+void setTime(unsigned long ms);
+
+/**
+ * @brief Sets the data the sensors report until the next call.
+ */
+void setSensorData(bool available, const float* values);
+
+/**
+ * @brief Retrieves the data the sensors report.
+ */
+const SensorData& sensorData();
+
+/**
+ * @brief Sets whether the SCD30 acknowledges calibration and configuration commands.
+ */
+void setCommandsAccepted(bool accepted);
+
+/**
+ * @brief Checks whether the SCD30 acknowledges calibration and configuration commands.
+ */
+bool commandsAccepted();
+
+/**
+ * @brief Adds a frame or panel command to the log.
+ *
+ * @param frame The drawing operations of the frame.
+ * @param firstText The first text drawn, empty for blank frames.
+ */
+void pushFrame(const std::string& frame, const std::string& firstText);
+
+/**
+ * @brief Retrieves the frame log.
+ */
+const FrameLog& frames();
+
+/**
+ * @brief Rewinds the clock and clears the sensor data, the frame log and the EEPROM.
+ *
+ * The SCD30 accepts commands again afterwards.
+ */
+void reset();
+
+} // namespace replay
+
+#endif // REPLAY_HARDWARE_H
@@ -0,0 +1,25 @@
+#ifndef REPLAY_SCD30_H
+#define REPLAY_SCD30_H
+
+#include <Wire.h>
+#include "ReplayHardware.h"
+
+/**
+ * @file SparkFun_SCD30_Arduino_Library.h
+ * @brief SCD30 driver answering from the trace event being replayed.
+ */
+
+class SCD30 {
+public:
+    bool begin(TwoWire&, bool, bool) { return true; }
+    bool dataAvailable() { return replay::sensorData().available; }
+    // The driver reports CO2 as a whole number of ppm
+    uint16_t getCO2() { return static_cast<uint16_t>(lroundf(replay::sensorData().values[HISTORY_CO2])); }
+    float getTemperature() { return replay::sensorData().values[HISTORY_TEMP_SCD]; }
+    float getHumidity() { return replay::sensorData().values[HISTORY_HUMIDITY]; }
+    bool setForcedRecalibrationFactor(uint16_t) { return replay::commandsAccepted(); }
+    bool setAmbientPressure(uint16_t) { return replay::commandsAccepted(); }
+    bool setMeasurementInterval(uint16_t) { return replay::commandsAccepted(); }
+};
+
+#endif // REPLAY_SCD30_H
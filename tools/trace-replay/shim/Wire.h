@@ -0,0 +1,18 @@
+#ifndef REPLAY_WIRE_H
+#define REPLAY_WIRE_H
+
+#include <Arduino.h>
+
+/**
+ * @file Wire.h
+ * @brief I2C bus placeholder; the replayed devices do not talk to a bus.
+ */
+
+class TwoWire {
+public:
+    void begin() {}
+};
+
+extern TwoWire Wire;
+
+#endif // REPLAY_WIRE_H